@@ -0,0 +1,247 @@
+// Benchmark da camada de tilemap afim ("mode 7", libsprite/tile_affine.h)
+// em 640x480 com pixels dobrados (320x240, 16bpp).
+//
+// Core 1 codifica TMDS com dvi_scanbuf_main_16bpp e, no callback de
+// scanline do DVI, calcula a entrada da tabela de linhas do próximo quadro
+// para a linha que acabou de ser mostrada (o custo da tabela fica espalhado
+// pelo quadro, sem pico no vblank). Os parâmetros do quadro (câmera ou
+// transformação) são calculados uma vez por quadro num job de vblank
+// (dvi_vblank.h). Core 0 renderiza as linhas.
+//
+// Dois modos, alternados a cada MODE_FRAMES quadros:
+// - chão em perspectiva abaixo do horizonte, céu liso acima
+// - tela inteira girando e com zoom (uma transformação afim por quadro)
+//
+// O pior tempo de linha (ciclos, SysTick do Core 0) e o pior tempo do
+// callback (SysTick do Core 1) são comparados com o orçamento de uma linha
+// renderizada (DVI_VERTICAL_REPEAT linhas de vídeo). Saída na USB serial.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "hardware/clocks.h"
+#include "hardware/vreg.h"
+#include "hardware/structs/bus_ctrl.h"
+#include "hardware/structs/systick.h"
+
+#include "dvi.h"
+#include "dvi_serialiser.h"
+#include "dvi_vblank.h"
+#include "common_dvi_pin_configs.h"
+#include "sprite.h"
+#include "tile_affine.h"
+
+#define FRAME_WIDTH 320
+#define FRAME_HEIGHT 240
+#define VREG_VSEL VREG_VOLTAGE_1_20
+#define DVI_TIMING dvi_timing_640x480p_60hz
+
+#define N_SCANLINE_BUFFERS 4
+#define HORIZON 72
+#define MODE_FRAMES 300
+
+struct dvi_inst dvi0;
+
+static uint16_t __attribute__((aligned(4))) scanbuf[N_SCANLINE_BUFFERS][FRAME_WIDTH];
+
+// Mapa de 512x512 px com tiles 8x8 (64x64 tiles)
+#define MAP_LOG_SIZE 9
+#define MAP_LOG_TILES (MAP_LOG_SIZE - 3)
+#define N_TILES 8
+static uint16_t __attribute__((aligned(4))) tileset[N_TILES * 8 * 8];
+static uint8_t tilemap[1u << (2 * MAP_LOG_TILES)];
+static affine_line_t lines[FRAME_HEIGHT];
+static tilebg_affine_t bg;
+
+enum { MODE_FLOOR, MODE_ROTOZOOM, N_MODES };
+static volatile uint mode;
+static volatile uint cb_frame;
+static volatile uint32_t cb_worst;
+
+static inline uint16_t rgb565(uint r, uint g, uint b) {
+    return (uint16_t)((r & 0x1f) << 11 | (g & 0x3f) << 5 | (b & 0x1f));
+}
+
+static void make_assets(void) {
+    // Tiles: grama, asfalto e faixas, com um pixel de borda para ver o
+    // movimento
+    for (uint t = 0; t < N_TILES; ++t) {
+        for (uint y = 0; y < 8; ++y) {
+            for (uint x = 0; x < 8; ++x) {
+                bool edge = x == 0 || y == 0;
+                uint16_t c;
+                if (t < 4)
+                    c = rgb565(4 + t, 36 + 4 * t, 4);
+                else if (t < 7)
+                    c = rgb565(12 + t, 24 + 2 * t, 12 + t);
+                else
+                    c = ((x ^ y) & 4) ? rgb565(31, 63, 31) : rgb565(31, 0, 0);
+                tileset[t * 64 + y * 8 + x] = edge ? c - (c >> 2 & 0x39e7) : c;
+            }
+        }
+    }
+    // Pista em anel no meio da grama
+    const int n = 1 << MAP_LOG_TILES;
+    for (int ty = 0; ty < n; ++ty) {
+        for (int tx = 0; tx < n; ++tx) {
+            int dx = 2 * tx - n + 1, dy = 2 * ty - n + 1;
+            int r2 = dx * dx + dy * dy;
+            uint8_t t = (tx * 7 + ty * 3) & 3;
+            if (r2 > 40 * 40 && r2 < 52 * 52)
+                t = 4 + ((tx + ty) % 3);
+            else if ((r2 >= 38 * 38 && r2 <= 40 * 40) || (r2 >= 52 * 52 && r2 <= 54 * 54))
+                t = 7;
+            tilemap[ty * n + tx] = t;
+        }
+    }
+
+    bg.tileset = tileset;
+    bg.tilemap = tilemap;
+    bg.log_size_x = MAP_LOG_SIZE;
+    bg.log_size_y = MAP_LOG_SIZE;
+    bg.tilesize = TILESIZE_8;
+    bg.fill_loop = (tile_affine_loop_t)tile16_affine_8px_loop;
+    bg.lines = lines;
+}
+
+// Parâmetros do quadro f, calculados uma vez por quadro
+static affine_camera_t frame_cam;
+static affine_transform_t frame_trans;
+
+static void __not_in_flash_func(prepare_frame)(uint f) {
+    if (mode == MODE_FLOOR) {
+        // Câmera dando voltas na pista (raio de 23 tiles), olhando na
+        // direção do movimento
+        uint8_t theta = (uint8_t)(f / 2);
+        frame_cam.u = (256 << 16) + 23 * 8 * sin_fp1616(theta);
+        frame_cam.v = (256 << 16) - 23 * 8 * cos_fp1616(theta);
+        frame_cam.height = 24 << 16;
+        frame_cam.focal = 160;
+        frame_cam.theta = theta;
+    }
+    else {
+        affine_identity(frame_trans);
+        affine_translate(frame_trans, FRAME_WIDTH / 2, FRAME_HEIGHT / 2);
+        affine_rotate(frame_trans, (uint8_t)f);
+        int32_t zoom = AF_ONE + (sin_fp1616((uint8_t)(f * 3)) >> 1) + (AF_ONE >> 1);
+        affine_scale(frame_trans, zoom, zoom);
+        affine_translate(frame_trans, -256, -256);
+    }
+}
+
+static inline void update_line(uint y) {
+    if (mode == MODE_FLOOR)
+        tile_affine_line_perspective(&lines[y], &frame_cam, HORIZON, y, FRAME_WIDTH);
+    else
+        tile_affine_line_from_transform(&lines[y], frame_trans, y);
+}
+
+// Job de vblank, depois da última linha do quadro: parâmetros do próximo
+// quadro, que os callbacks de scanline usam a partir da linha 0
+static void __not_in_flash_func(vblank_job_fn)(void *arg) {
+    (void)arg;
+    prepare_frame(++cb_frame + 1);
+}
+
+static dvi_vblank_t vblank;
+static dvi_vblank_job_t frame_job = DVI_VBLANK_JOB_INIT(vblank_job_fn, NULL, 1);
+
+// DMA IRQ do Core 1, uma vez por linha renderizada: prepara a mesma linha do
+// próximo quadro. O Core 0 só lê a linha y do próximo quadro bem depois.
+static void __not_in_flash_func(scanline_cb)(void) {
+    uint32_t t0 = systick_hw->cvr;
+    uint y = dvi0.timing_state.v_ctr / DVI_VERTICAL_REPEAT;
+    update_line(y);
+    uint32_t t = (t0 - systick_hw->cvr) & 0xffffff;
+    if (t > cb_worst)
+        cb_worst = t;
+}
+
+static inline void render_line(uint16_t *buf, uint y) {
+    if (mode == MODE_FLOOR && y <= HORIZON)
+        sprite_fill16(buf, rgb565(8, 40, 31 - y / 4), FRAME_WIDTH);
+    else
+        tile_affine16(buf, &bg, y, FRAME_WIDTH);
+}
+
+// Renderiza um quadro e devolve o pior tempo de linha em ciclos
+static uint32_t render_frame_timed(void) {
+    uint32_t worst = 0;
+    for (uint y = 0; y < FRAME_HEIGHT; ++y) {
+        uint16_t *buf;
+        queue_remove_blocking(&dvi0.q_colour_free, &buf);
+        uint32_t t0 = systick_hw->cvr;
+        render_line(buf, y);
+        uint32_t t = (t0 - systick_hw->cvr) & 0xffffff;
+        if (t > worst)
+            worst = t;
+        queue_add_blocking(&dvi0.q_colour_valid, &buf);
+    }
+    return worst;
+}
+
+void core1_main() {
+    systick_hw->rvr = 0xffffff;
+    systick_hw->csr = 0x5;
+    dvi_register_irqs_this_core(&dvi0, DMA_IRQ_0);
+    dvi_vblank_init(&vblank, &dvi0, next_striped_spin_lock_num());
+    dvi_vblank_add(&vblank, &frame_job);
+    dvi_start(&dvi0);
+    dvi_scanbuf_main_16bpp(&dvi0);
+}
+
+int main() {
+    vreg_set_voltage(VREG_VSEL);
+    sleep_ms(10);
+    set_sys_clock_khz(DVI_TIMING.bit_clk_khz, true);
+    stdio_init_all();
+
+    dvi0.timing = &DVI_TIMING;
+    dvi0.ser_cfg = picodvi_dvi_cfg;
+    dvi0.scanline_callback = scanline_cb;
+    dvi_init(&dvi0, next_striped_spin_lock_num(), next_striped_spin_lock_num());
+
+    make_assets();
+    prepare_frame(0);
+    for (uint y = 0; y < FRAME_HEIGHT; ++y)
+        update_line(y);
+
+    for (int i = 0; i < N_SCANLINE_BUFFERS; ++i) {
+        uint16_t *buf = scanbuf[i];
+        queue_add_blocking(&dvi0.q_colour_free, &buf);
+    }
+
+    // SysTick livre a clk_sys, só para medir
+    systick_hw->rvr = 0xffffff;
+    systick_hw->csr = 0x5;
+
+    hw_set_bits(&bus_ctrl_hw->priority, BUSCTRL_BUS_PRIORITY_PROC1_BITS);
+    multicore_launch_core1(core1_main);
+
+    const struct dvi_timing *t = &DVI_TIMING;
+    uint32_t line_budget = 10 * DVI_VERTICAL_REPEAT *
+        (t->h_front_porch + t->h_sync_width + t->h_back_porch + t->h_active_pixels);
+    static const char *const mode_names[N_MODES] = {"chão em perspectiva", "rotozoom tela cheia"};
+
+    while (true) {
+        uint32_t worst = 0;
+        cb_worst = 0;
+        for (uint frame = 0; frame < MODE_FRAMES; ++frame) {
+            uint32_t w = render_frame_timed();
+            if (w > worst)
+                worst = w;
+        }
+        printf("%s: pior linha %lu ciclos (%lu.%02lu ciclos/px), callback %lu ciclos, orçamento %lu%s\n",
+            mode_names[mode], (unsigned long)worst,
+            (unsigned long)(worst / FRAME_WIDTH), (unsigned long)(worst % FRAME_WIDTH * 100 / FRAME_WIDTH),
+            (unsigned long)cb_worst, (unsigned long)line_budget,
+            worst <= line_budget ? "" : "  (estourou)");
+        printf("  vblank: %lu passadas, pior %lu us, %lu estouros, %lu perdidas\n",
+            (unsigned long)vblank.passes, (unsigned long)vblank.max_pass_us,
+            (unsigned long)vblank.overruns, (unsigned long)vblank.missed);
+        // A troca vale a partir do próximo quadro; um quadro com a tabela
+        // antiga não importa aqui
+        mode = (mode + 1) % N_MODES;
+    }
+}
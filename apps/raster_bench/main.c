@@ -0,0 +1,242 @@
+// Demo de efeitos por linha em fundos de tiles (tabelas de scroll e
+// habilitação por linha de tilebg_t) em 640x480 com pixels dobrados
+// (320x240, 16bpp).
+//
+// Duas camadas:
+// - fundo: colinas em faixas com paralaxe (cada faixa rola numa velocidade)
+// - frente: tiles 8x8 com alpha, ondulando na horizontal, com uma barra de
+//   status fixa nas 16 primeiras linhas (as linhas apontam para a parte de
+//   baixo do mapa e cancelam o scroll) e desligada numa faixa do meio
+//
+// As tabelas são reescritas pelo Core 0 entre quadros; nenhum tile é
+// redesenhado e não há buffer extra. Para medir, cada linha é renderizada
+// de novo num buffer descartável com as mesmas camadas sem tabelas
+// (ponteiros NULL), e a diferença entre os tempos médios de linha (SysTick)
+// é o custo por linha dos efeitos (um pouco subestimado, já que a faixa
+// desligada da frente fica mais barata). Saída na USB serial.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "hardware/clocks.h"
+#include "hardware/vreg.h"
+#include "hardware/structs/bus_ctrl.h"
+#include "hardware/structs/systick.h"
+
+#include "dvi.h"
+#include "dvi_serialiser.h"
+#include "common_dvi_pin_configs.h"
+#include "affine_transform.h"
+#include "tile.h"
+
+#define FRAME_WIDTH 320
+#define FRAME_HEIGHT 240
+#define VREG_VSEL VREG_VOLTAGE_1_20
+#define DVI_TIMING dvi_timing_640x480p_60hz
+
+#define N_SCANLINE_BUFFERS 4
+#define FRAMES_PER_REPORT 120
+
+#define STATUS_LINES 16
+#define GAP_FIRST 120
+#define GAP_END 136
+
+struct dvi_inst dvi0;
+
+static uint16_t __attribute__((aligned(4))) scanbuf[N_SCANLINE_BUFFERS][FRAME_WIDTH];
+
+// Fundo: 512x256 px, tiles 16x16
+#define BACK_LOG_W 9
+#define BACK_LOG_H 8
+static uint16_t __attribute__((aligned(4))) back_tiles[4 * 16 * 16];
+static uint8_t back_map[(1u << (BACK_LOG_W - 4)) * (1u << (BACK_LOG_H - 4))];
+
+// Frente: 512x256 px, tiles 8x8; as linhas 240..255 do mapa são a barra de status
+#define FRONT_LOG_W 9
+#define FRONT_LOG_H 8
+#define STATUS_MAP_Y 240
+static uint16_t __attribute__((aligned(4))) front_tiles[4 * 8 * 8];
+static uint8_t front_map[(1u << (FRONT_LOG_W - 3)) * (1u << (FRONT_LOG_H - 3))];
+
+static tilebg_t back, front;
+// As mesmas camadas sem tabelas, só para medir
+static tilebg_t back_plain, front_plain;
+static uint16_t __attribute__((aligned(4))) scratch_buf[FRAME_WIDTH];
+
+static int16_t back_xscroll[FRAME_HEIGHT];
+static int16_t front_xscroll[FRAME_HEIGHT];
+static int16_t front_yscroll[FRAME_HEIGHT];
+static uint32_t front_enable[(FRAME_HEIGHT + 31) / 32];
+
+static inline uint16_t rgab5515(uint r, uint g, uint b, bool alpha) {
+    return (uint16_t)((r & 0x1f) << 11 | (g & 0x1f) << 6 | (alpha ? 1u << 5 : 0) | (b & 0x1f));
+}
+
+static void make_assets(void) {
+    // Fundo: céu, dois tons de colina e chão; cada faixa de 64 linhas do
+    // mapa é um tipo de tile
+    for (uint t = 0; t < 4; ++t)
+        for (uint i = 0; i < 16 * 16; ++i)
+            back_tiles[t * 256 + i] = rgab5515(4 + 3 * t, 8 + 5 * t - (i >> 6), 28 - 6 * t, true);
+    const uint back_w = 1u << (BACK_LOG_W - 4);
+    for (uint i = 0; i < count_of(back_map); ++i) {
+        uint tx = i % back_w, ty = i / back_w;
+        // Colinas: o topo de cada faixa varia com x
+        uint band = ty / 4;
+        back_map[i] = (ty % 4) < ((tx * 5 + band) % 3) ? (band ? band - 1 : 0) : band;
+    }
+
+    // Frente: tile 0 transparente, 1 e 2 blocos, 3 barra de status
+    for (uint y = 0; y < 8; ++y) {
+        for (uint x = 0; x < 8; ++x) {
+            front_tiles[0 * 64 + y * 8 + x] = 0;
+            front_tiles[1 * 64 + y * 8 + x] = rgab5515(28, 12 + y, 4, x != 0 && y != 0);
+            front_tiles[2 * 64 + y * 8 + x] = rgab5515(31, 31 - 2 * y, 8, true);
+            front_tiles[3 * 64 + y * 8 + x] = rgab5515(2, 2, 10 + y, true);
+        }
+    }
+    const uint front_w = 1u << (FRONT_LOG_W - 3);
+    for (uint i = 0; i < count_of(front_map); ++i) {
+        uint tx = i % front_w, ty = i / front_w;
+        uint8_t t = 0;
+        if (ty * 8 >= STATUS_MAP_Y)
+            t = 3;
+        else if (ty >= 24)
+            t = 1;
+        else if (ty >= 8 && (tx % 16) < 3 && ((ty + tx / 16) % 5) < 2)
+            t = 2;
+        front_map[i] = t;
+    }
+
+    back.tileset = back_tiles;
+    back.tilemap = back_map;
+    back.log_size_x = BACK_LOG_W;
+    back.log_size_y = BACK_LOG_H;
+    back.tilesize = TILESIZE_16;
+    back.fill_loop = (tile_loop_t)tile16_16px_loop;
+
+    front.tileset = front_tiles;
+    front.tilemap = front_map;
+    front.log_size_x = FRONT_LOG_W;
+    front.log_size_y = FRONT_LOG_H;
+    front.tilesize = TILESIZE_8;
+    front.fill_loop = (tile_loop_t)tile16_8px_alpha_loop;
+}
+
+// Tabelas do quadro f. Só o scroll por linha muda: xscroll/yscroll das
+// camadas são a câmera, as tabelas são os efeitos.
+static void update_tables(uint f) {
+    for (uint y = 0; y < FRAME_HEIGHT; ++y) {
+        // Paralaxe: faixas de 64 linhas do fundo, as de baixo mais rápidas
+        // (a câmera anda f pixels, a faixa k anda f * (k + 1) / 4)
+        uint band = y >> 6;
+        back_xscroll[y] = (int16_t)((int)(f * (band + 1) / 4) - (int)f);
+
+        if (y < STATUS_LINES) {
+            // Barra de status: linhas fixas do mapa, sem scroll
+            front_xscroll[y] = -(int16_t)front.xscroll;
+            front_yscroll[y] = (int16_t)(STATUS_MAP_Y - front.yscroll);
+        }
+        else {
+            // Ondulação de até 6 px
+            front_xscroll[y] = (int16_t)((6 * sin_fp1616((uint8_t)(4 * y + 3 * f))) >> 16);
+            front_yscroll[y] = -STATUS_LINES;
+        }
+    }
+}
+
+static inline uint32_t render_line_timed(uint16_t *buf, const tilebg_t *b, const tilebg_t *f, uint y) {
+    uint32_t t0 = systick_hw->cvr;
+    tile16(buf, b, y, FRAME_WIDTH);
+    tile16(buf, f, y, FRAME_WIDTH);
+    return (t0 - systick_hw->cvr) & 0xffffff;
+}
+
+// Renderiza um quadro; acumula os tempos de linha com e sem tabelas
+static void render_frame_timed(uint64_t total[2], uint32_t worst[2]) {
+    for (uint y = 0; y < FRAME_HEIGHT; ++y) {
+        uint16_t *buf;
+        queue_remove_blocking(&dvi0.q_colour_free, &buf);
+        uint32_t t_on = render_line_timed(buf, &back, &front, y);
+        queue_add_blocking(&dvi0.q_colour_valid, &buf);
+        uint32_t t_off = render_line_timed(scratch_buf, &back_plain, &front_plain, y);
+        total[1] += t_on;
+        total[0] += t_off;
+        worst[1] = MAX(worst[1], t_on);
+        worst[0] = MAX(worst[0], t_off);
+    }
+}
+
+void core1_main() {
+    dvi_register_irqs_this_core(&dvi0, DMA_IRQ_0);
+    dvi_start(&dvi0);
+    dvi_scanbuf_main_16bpp(&dvi0);
+}
+
+int main() {
+    vreg_set_voltage(VREG_VSEL);
+    sleep_ms(10);
+    set_sys_clock_khz(DVI_TIMING.bit_clk_khz, true);
+    stdio_init_all();
+
+    dvi0.timing = &DVI_TIMING;
+    dvi0.ser_cfg = picodvi_dvi_cfg;
+    dvi_init(&dvi0, next_striped_spin_lock_num(), next_striped_spin_lock_num());
+
+    make_assets();
+    for (uint y = 0; y < FRAME_HEIGHT; ++y) {
+        if (y < GAP_FIRST || y >= GAP_END)
+            front_enable[y >> 5] |= 1u << (y & 31);
+    }
+
+    for (int i = 0; i < N_SCANLINE_BUFFERS; ++i) {
+        uint16_t *buf = scanbuf[i];
+        queue_add_blocking(&dvi0.q_colour_free, &buf);
+    }
+
+    // SysTick livre a clk_sys, só para medir
+    systick_hw->rvr = 0xffffff;
+    systick_hw->csr = 0x5;
+
+    hw_set_bits(&bus_ctrl_hw->priority, BUSCTRL_BUS_PRIORITY_PROC1_BITS);
+    multicore_launch_core1(core1_main);
+
+    const struct dvi_timing *t = &DVI_TIMING;
+    uint32_t line_budget = 10 * DVI_VERTICAL_REPEAT *
+        (t->h_front_porch + t->h_sync_width + t->h_back_porch + t->h_active_pixels);
+
+    back.line_xscroll = back_xscroll;
+    front.line_xscroll = front_xscroll;
+    front.line_yscroll = front_yscroll;
+    front.line_enable = front_enable;
+    back_plain = back;
+    front_plain = front;
+    back_plain.line_xscroll = NULL;
+    front_plain.line_xscroll = NULL;
+    front_plain.line_yscroll = NULL;
+    front_plain.line_enable = NULL;
+
+    uint frame = 0;
+    while (true) {
+        uint64_t total[2] = {0, 0};
+        uint32_t worst[2] = {0, 0};
+        uint32_t table_cycles = 0;
+        for (uint i = 0; i < FRAMES_PER_REPORT; ++i, ++frame) {
+            back.xscroll = back_plain.xscroll = frame;
+            front.xscroll = front_plain.xscroll = 2 * frame;
+            uint32_t t0 = systick_hw->cvr;
+            update_tables(frame);
+            table_cycles = MAX(table_cycles, (t0 - systick_hw->cvr) & 0xffffff);
+            render_frame_timed(total, worst);
+        }
+        uint n_lines = FRAMES_PER_REPORT * FRAME_HEIGHT;
+        uint32_t avg_off = (uint32_t)(total[0] / n_lines);
+        uint32_t avg_on = (uint32_t)(total[1] / n_lines);
+        printf("linha média: %lu ciclos sem tabelas, %lu com (custo %ld/linha); pior %lu / %lu; "
+            "tabelas %lu ciclos/quadro; orçamento %lu\n",
+            (unsigned long)avg_off, (unsigned long)avg_on, (long)avg_on - (long)avg_off,
+            (unsigned long)worst[0], (unsigned long)worst[1],
+            (unsigned long)table_cycles, (unsigned long)line_budget);
+    }
+}
@@ -0,0 +1,301 @@
+// Benchmark do compositor de sprites (libsprite/compositor.h) em 640x480
+// com pixels dobrados (320x240, 16bpp RGAB5515).
+//
+// Core 1 codifica TMDS com dvi_scanbuf_main_16bpp; Core 0 compõe as linhas
+// (fundo de tiles + sprites 16x16). Quatro rodadas: sprites com alpha,
+// sprites translúcidos (SPRITE_FLAG_BLEND_50), sprites girando (afins) com
+// alpha e sprites girando opacos (SPRITE_FLAG_OPAQUE, laço afim sem teste de
+// alpha). Em cada rodada, para cada quantidade K de
+// sprites por linha, todos os K sprites são postos numa faixa de 16 linhas e
+// o pior tempo de composição de uma linha (em ciclos, via SysTick) é
+// comparado com o orçamento de uma linha renderizada, que é
+// DVI_VERTICAL_REPEAT linhas de vídeo. Antes das rodadas, mede também um
+// painel translúcido de largura total (sprite_fill16_blend*) e uma pilha de
+// camadas com paralaxe (fundo, chão e barra de status, com sprites entre o
+// chão e a barra), com e sem as dicas de opacidade que permitem ao
+// compositor não desenhar o que fica escondido. O resultado sai na USB
+// serial.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "hardware/clocks.h"
+#include "hardware/vreg.h"
+#include "hardware/structs/bus_ctrl.h"
+#include "hardware/structs/systick.h"
+
+#include "dvi.h"
+#include "dvi_serialiser.h"
+#include "common_dvi_pin_configs.h"
+#include "compositor.h"
+
+#define FRAME_WIDTH 320
+#define FRAME_HEIGHT 240
+#define VREG_VSEL VREG_VOLTAGE_1_20
+#define DVI_TIMING dvi_timing_640x480p_60hz
+
+#define N_SCANLINE_BUFFERS 4
+#define SPRITE_SIZE 16
+#define STRIP_Y 64
+#define FRAMES_PER_STEP 60
+
+struct dvi_inst dvi0;
+static compositor_t comp;
+
+static uint16_t __attribute__((aligned(4))) scanbuf[N_SCANLINE_BUFFERS][FRAME_WIDTH];
+static sprite_t sprites[COMPOSITOR_MAX_SPRITES];
+static uint16_t sprite_img[SPRITE_SIZE * SPRITE_SIZE];
+static uint16_t __attribute__((aligned(4))) panel_buf[FRAME_WIDTH];
+static uint16_t sprite_img_opaque[SPRITE_SIZE * SPRITE_SIZE];
+static affine_transform_t sprite_atrans[COMPOSITOR_MAX_SPRITES];
+static const int32_t *sprite_atrans_ptr[COMPOSITOR_MAX_SPRITES];
+
+enum { RUN_ALPHA, RUN_BLEND50, RUN_AFFINE_ALPHA, RUN_AFFINE_OPAQUE, N_RUNS };
+static const char *const run_names[N_RUNS] = {
+    "com alpha", "translúcidos 50%", "girando com alpha", "girando opacos",
+};
+
+// Fundo: 512x256 px de tiles 16x16, xadrez de 4 tiles
+#define BG_LOG_W 9
+#define BG_LOG_H 8
+static uint16_t __attribute__((aligned(4))) tileset[4 * 16 * 16];
+static uint8_t tilemap[(1u << (BG_LOG_W - 4)) * (1u << (BG_LOG_H - 4))];
+static tilebg_t bg;
+
+// Pilha de camadas: chão e barra de status, tiles 8x8 sobre o fundo acima.
+// Tile 0 transparente, 1 e 2 opacos, 3 com borda transparente (grama).
+#define LAYER_LOG_W 9
+#define LAYER_LOG_H 8
+#define GROUND_ROW 17
+#define STATUS_ROWS 2
+#define N_LAYER_SPRITES 16
+static uint16_t __attribute__((aligned(4))) layer_tiles[4 * 8 * 8];
+static uint32_t layer_opaque_tiles[1];
+static uint8_t ground_map[(1u << (LAYER_LOG_W - 3)) * (1u << (LAYER_LOG_H - 3))];
+static uint8_t status_map[(1u << (LAYER_LOG_W - 3)) * (1u << (LAYER_LOG_H - 3))];
+static tilebg_t ground, status;
+static compositor_layer_t layers[2];
+static uint8_t sprite_depth[COMPOSITOR_MAX_SPRITES];
+
+static inline uint16_t rgab5515(uint r, uint g, uint b, bool alpha) {
+    return (uint16_t)((r & 0x1f) << 11 | (g & 0x1f) << 6 | (alpha ? 1u << 5 : 0) | (b & 0x1f));
+}
+
+static void make_assets(void) {
+    // Círculo com borda transparente, para exercitar o blit com alpha
+    for (int y = 0; y < (int)SPRITE_SIZE; ++y) {
+        for (int x = 0; x < (int)SPRITE_SIZE; ++x) {
+            int dx = 2 * x - (SPRITE_SIZE - 1), dy = 2 * y - (SPRITE_SIZE - 1);
+            bool inside = dx * dx + dy * dy <= (int)(SPRITE_SIZE * SPRITE_SIZE);
+            sprite_img[y * SPRITE_SIZE + x] = inside ? rgab5515(31, x * 2, y * 2, true) : 0;
+            sprite_img_opaque[y * SPRITE_SIZE + x] = rgab5515(x * 2, 31, y * 2, true);
+        }
+    }
+    for (int t = 0; t < 4; ++t)
+        for (int i = 0; i < 16 * 16; ++i)
+            tileset[t * 256 + i] = rgab5515(t * 6, (i >> 4) + 4, 8 + t * 4, true);
+    for (uint i = 0; i < count_of(tilemap); ++i)
+        tilemap[i] = (i + (i >> (BG_LOG_W - 4))) & 3;
+
+    bg.xscroll = 0;
+    bg.yscroll = 0;
+    bg.tileset = tileset;
+    bg.tilemap = tilemap;
+    bg.log_size_x = BG_LOG_W;
+    bg.log_size_y = BG_LOG_H;
+    bg.tilesize = TILESIZE_16;
+    bg.fill_loop = (tile_loop_t)tile16_16px_loop;
+
+    for (uint y = 0; y < 8; ++y) {
+        for (uint x = 0; x < 8; ++x) {
+            layer_tiles[0 * 64 + y * 8 + x] = 0;
+            layer_tiles[1 * 64 + y * 8 + x] = rgab5515(20, 12 + y, 4, true);
+            layer_tiles[2 * 64 + y * 8 + x] = rgab5515(4, 4, 12 + y, true);
+            layer_tiles[3 * 64 + y * 8 + x] = rgab5515(6, 28, 4, y >= 2 + ((x * 3) & 3));
+        }
+    }
+    tile16_opaque_tiles(layer_tiles, 4, TILESIZE_8, layer_opaque_tiles);
+    const uint layer_w = 1u << (LAYER_LOG_W - 3);
+    for (uint i = 0; i < count_of(ground_map); ++i) {
+        uint tx = i % layer_w, ty = i / layer_w;
+        // Chão com morros: a altura varia de tile em tile
+        uint top = GROUND_ROW + ((tx / 4) % 3);
+        ground_map[i] = ty < top ? 0 : ty == top ? 3 : 1;
+        status_map[i] = ty < STATUS_ROWS ? 2 : 0;
+    }
+    ground.tileset = layer_tiles;
+    ground.tilemap = ground_map;
+    ground.log_size_x = LAYER_LOG_W;
+    ground.log_size_y = LAYER_LOG_H;
+    ground.tilesize = TILESIZE_8;
+    ground.fill_loop = (tile_loop_t)tile16_8px_alpha_loop;
+    status = ground;
+    status.tilemap = status_map;
+
+    layers[0].bg = &ground;
+    layers[0].depth = 1;
+    layers[1].bg = &status;
+    layers[1].depth = 2;
+}
+
+// Espalha n sprites na faixa STRIP_Y..STRIP_Y+15, de modo que toda linha da
+// faixa cruza os n sprites; a posição x oscila a cada quadro. Nas rodadas
+// afins cada sprite gira em torno do próprio centro.
+static void place_sprites(uint run, uint n, uint frame) {
+    for (uint i = 0; i < n; ++i) {
+        sprites[i].x = (int16_t)((i * (FRAME_WIDTH - SPRITE_SIZE) / n + frame * (i + 1)) % (FRAME_WIDTH - SPRITE_SIZE));
+        sprites[i].y = STRIP_Y;
+        sprites[i].img = sprite_img;
+        sprites[i].w_minus1 = SPRITE_SIZE - 1;
+        sprites[i].h_minus1 = SPRITE_SIZE - 1;
+        sprites[i].stride_minus1 = SPRITE_SIZE - 1;
+        sprites[i].flags = run == RUN_BLEND50 ? SPRITE_FLAG_BLEND_50 : 0;
+        if (run == RUN_AFFINE_OPAQUE) {
+            sprites[i].img = sprite_img_opaque;
+            sprites[i].flags = SPRITE_FLAG_OPAQUE;
+        }
+        if (run >= RUN_AFFINE_ALPHA) {
+            affine_identity(sprite_atrans[i]);
+            affine_translate(sprite_atrans[i], SPRITE_SIZE / 2, SPRITE_SIZE / 2);
+            affine_rotate(sprite_atrans[i], (uint8_t)(frame + 16 * i));
+            affine_translate(sprite_atrans[i], -SPRITE_SIZE / 2, -SPRITE_SIZE / 2);
+        }
+        sprite_atrans_ptr[i] = run >= RUN_AFFINE_ALPHA ? sprite_atrans[i] : NULL;
+    }
+    comp.n_sprites = n;
+}
+
+// Compõe um quadro e devolve o pior tempo de linha em ciclos
+static uint32_t render_frame_timed(void) {
+    uint32_t worst = 0;
+    compositor_build_bins(&comp);
+    for (uint y = 0; y < FRAME_HEIGHT; ++y) {
+        uint16_t *buf;
+        queue_remove_blocking(&dvi0.q_colour_free, &buf);
+        uint32_t t0 = systick_hw->cvr;
+        compositor_render_line16(&comp, buf, y);
+        uint32_t t = (t0 - systick_hw->cvr) & 0xffffff;
+        if (t > worst)
+            worst = t;
+        queue_add_blocking(&dvi0.q_colour_valid, &buf);
+    }
+    return worst;
+}
+
+// Pilha de camadas: N_LAYER_SPRITES sprites voando entre o chão e a barra de
+// status. hints liga as dicas de opacidade das camadas; sem elas nada é
+// escondido e tudo é desenhado por inteiro.
+static void run_layers(bool hints, uint32_t line_budget) {
+    for (uint i = 0; i < 2; ++i)
+        layers[i].opaque_tiles = hints ? layer_opaque_tiles : NULL;
+    comp.layers = layers;
+    comp.n_layers = 2;
+    comp.atrans = NULL;
+    comp.depth = sprite_depth;
+    uint32_t worst = 0;
+    uint64_t pixels = 0;
+    for (uint frame = 0; frame < FRAMES_PER_STEP; ++frame) {
+        for (uint i = 0; i < N_LAYER_SPRITES; ++i) {
+            sprites[i].x = (int16_t)((i * 37 + frame * (1 + i % 3)) % (FRAME_WIDTH + SPRITE_SIZE) - SPRITE_SIZE);
+            sprites[i].y = (int16_t)(24 + (i * 53) % 200);
+            sprites[i].img = sprite_img;
+            sprites[i].w_minus1 = SPRITE_SIZE - 1;
+            sprites[i].h_minus1 = SPRITE_SIZE - 1;
+            sprites[i].stride_minus1 = SPRITE_SIZE - 1;
+            sprites[i].flags = 0;
+            sprite_depth[i] = 1;
+        }
+        comp.n_sprites = N_LAYER_SPRITES;
+        bg.xscroll = frame / 2;
+        ground.xscroll = frame;
+        uint32_t w = render_frame_timed();
+        if (w > worst)
+            worst = w;
+        pixels += comp.stack_pixels;
+    }
+    uint32_t overdraw_x100 = (uint32_t)(pixels * 100 / ((uint64_t)FRAMES_PER_STEP * FRAME_WIDTH * FRAME_HEIGHT));
+    printf("Camadas %s dicas de opacidade: pior linha %lu ciclos (orçamento %lu), %lu.%02lu px desenhados por px de tela\n",
+        hints ? "com" : "sem", (unsigned long)worst, (unsigned long)line_budget,
+        (unsigned long)(overdraw_x100 / 100), (unsigned long)(overdraw_x100 % 100));
+    comp.layers = NULL;
+    comp.depth = NULL;
+    comp.atrans = sprite_atrans_ptr;
+    bg.xscroll = 0;
+}
+
+void core1_main() {
+    dvi_register_irqs_this_core(&dvi0, DMA_IRQ_0);
+    dvi_start(&dvi0);
+    dvi_scanbuf_main_16bpp(&dvi0);
+}
+
+int main() {
+    vreg_set_voltage(VREG_VSEL);
+    sleep_ms(10);
+    set_sys_clock_khz(DVI_TIMING.bit_clk_khz, true);
+    stdio_init_all();
+
+    dvi0.timing = &DVI_TIMING;
+    dvi0.ser_cfg = picodvi_dvi_cfg;
+    dvi_init(&dvi0, next_striped_spin_lock_num(), next_striped_spin_lock_num());
+
+    make_assets();
+    compositor_init(&comp, FRAME_WIDTH, FRAME_HEIGHT);
+    comp.sprites = sprites;
+    comp.bg = &bg;
+    comp.atrans = sprite_atrans_ptr;
+
+    for (int i = 0; i < N_SCANLINE_BUFFERS; ++i) {
+        uint16_t *buf = scanbuf[i];
+        queue_add_blocking(&dvi0.q_colour_free, &buf);
+    }
+
+    // SysTick livre a clk_sys, só para medir
+    systick_hw->rvr = 0xffffff;
+    systick_hw->csr = 0x5;
+
+    hw_set_bits(&bus_ctrl_hw->priority, BUSCTRL_BUS_PRIORITY_PROC1_BITS);
+    multicore_launch_core1(core1_main);
+
+    // Uma linha renderizada é mostrada DVI_VERTICAL_REPEAT vezes, e clk_sys
+    // é o clock de bits (10 ciclos por pixel de vídeo)
+    const struct dvi_timing *t = &DVI_TIMING;
+    uint32_t line_budget = 10 * DVI_VERTICAL_REPEAT *
+        (t->h_front_porch + t->h_sync_width + t->h_back_porch + t->h_active_pixels);
+
+    while (true) {
+        static void (*const fill_blend[3])(uint16_t *, uint16_t, uint) = {
+            sprite_fill16_blend25, sprite_fill16_blend50, sprite_fill16_blend75,
+        };
+        for (uint i = 0; i < 3; ++i) {
+            uint32_t t0 = systick_hw->cvr;
+            fill_blend[i](panel_buf, rgab5515(0, 0, 31, true), FRAME_WIDTH);
+            uint32_t t = (t0 - systick_hw->cvr) & 0xffffff;
+            printf("Painel translúcido %u%%, %u px: %lu ciclos\n", 25 * (i + 1), FRAME_WIDTH, (unsigned long)t);
+        }
+        run_layers(false, line_budget);
+        run_layers(true, line_budget);
+        for (uint run = 0; run < N_RUNS; ++run) {
+            uint sustainable = 0;
+            printf("\nsprites %s/linha  pior linha (ciclos)  orçamento %lu\n", run_names[run], (unsigned long)line_budget);
+            for (uint n = 1; n <= COMPOSITOR_MAX_SPRITES; ++n) {
+                uint32_t worst = 0;
+                for (uint frame = 0; frame < FRAMES_PER_STEP; ++frame) {
+                    place_sprites(run, n, frame);
+                    bg.xscroll = frame;
+                    uint32_t w = render_frame_timed();
+                    if (w > worst)
+                        worst = w;
+                }
+                printf("%13u  %19lu%s\n", n, (unsigned long)worst, worst <= line_budget ? "" : "  (estourou)");
+                if (worst > line_budget)
+                    break;
+                sustainable = n;
+            }
+            printf("Sustentável: %u sprites 16x16 %s por linha sobre fundo de tiles (overflows de bin: %lu)\n",
+                sustainable, run_names[run], (unsigned long)comp.bin_overflows);
+        }
+        sleep_ms(5000);
+    }
+}
@@ -1,54 +0,0 @@
-#ifndef _IMG_ASSET_SECTION
-#define _IMG_ASSET_SECTION ".data"
-#endif
-
-static const char __attribute__((aligned(4), section(_IMG_ASSET_SECTION ".font_8x8"))) font_8x8[] = {
-	0x00, 0x18, 0x66, 0x2c, 0x08, 0x42, 0x38, 0x18, 0x30, 0x08, 0x36, 0x00, 0x00, 0x00, 0x00, 0x40,
-	0x3c, 0x10, 0x3c, 0x3c, 0x38, 0x7e, 0x3c, 0x7e, 0x3c, 0x3c, 0x00, 0x00, 0x20, 0x00, 0x0c, 0x1c,
-	0x3c, 0x70, 0x1e, 0x3c, 0x3e, 0x7c, 0x7c, 0x3c, 0x62, 0x38, 0x70, 0x62, 0x06, 0x3f, 0x3e, 0x3c,
-	0x3e, 0x3c, 0x3e, 0x3c, 0x7e, 0x42, 0x62, 0x49, 0x62, 0x62, 0x7e, 0x1c, 0x01, 0x38, 0x08, 0x00,
-	0x08, 0x00, 0x02, 0x00, 0x40, 0x00, 0x70, 0x00, 0x02, 0x08, 0x20, 0x02, 0x0c, 0x00, 0x00, 0x00,
-	0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x18, 0x0c, 0x00, 0x00,
-	0x18, 0x22, 0x7e, 0x3c, 0x25, 0x64, 0x18, 0x18, 0x10, 0x18, 0x10, 0x00, 0x00, 0x00, 0x20, 0x46,
-	0x18, 0x62, 0x46, 0x24, 0x06, 0x46, 0x46, 0x62, 0x46, 0x08, 0x10, 0x10, 0x00, 0x18, 0x32, 0x42,
-	0x48, 0x22, 0x46, 0x46, 0x04, 0x04, 0x46, 0x62, 0x10, 0x60, 0x62, 0x06, 0x4b, 0x46, 0x46, 0x62,
-	0x46, 0x62, 0x62, 0x5a, 0x42, 0x62, 0x49, 0x62, 0x62, 0x46, 0x04, 0x02, 0x20, 0x14, 0x00, 0x10,
-	0x00, 0x02, 0x00, 0x40, 0x00, 0x18, 0x00, 0x02, 0x00, 0x00, 0x02, 0x08, 0x00, 0x00, 0x00, 0x00,
-	0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x18, 0x18, 0x00, 0x00, 0x18,
-	0x22, 0x2c, 0x06, 0x12, 0x24, 0x10, 0x0c, 0x30, 0x7f, 0x10, 0x00, 0x00, 0x00, 0x18, 0x46, 0x1c,
-	0x60, 0x40, 0x26, 0x3e, 0x06, 0x20, 0x62, 0x46, 0x00, 0x00, 0x08, 0x7e, 0x30, 0x30, 0x99, 0x44,
-	0x22, 0x06, 0x46, 0x04, 0x04, 0x06, 0x62, 0x10, 0x60, 0x32, 0x06, 0x4b, 0x46, 0x46, 0x62, 0x46,
-	0x62, 0x06, 0x18, 0x62, 0x62, 0x69, 0x62, 0x62, 0x20, 0x04, 0x04, 0x20, 0x22, 0x00, 0x00, 0x3c,
-	0x3e, 0x3c, 0x7c, 0x3c, 0x3c, 0x7c, 0x3e, 0x18, 0x30, 0x66, 0x08, 0x3f, 0x3e, 0x3c, 0x3e, 0x7c,
-	0x7a, 0x7c, 0x3c, 0x42, 0x62, 0x49, 0x62, 0x46, 0x7e, 0x18, 0x18, 0x18, 0x06, 0x00, 0x08, 0x00,
-	0x24, 0x1c, 0x08, 0x18, 0x00, 0x0c, 0x30, 0x0c, 0x7e, 0x00, 0x7e, 0x00, 0x0c, 0x66, 0x18, 0x38,
-	0x38, 0x26, 0x60, 0x3e, 0x10, 0x3c, 0x7c, 0x00, 0x00, 0x0c, 0x00, 0x60, 0x18, 0xa5, 0x46, 0x3e,
-	0x06, 0x46, 0x3e, 0x3e, 0x76, 0x7e, 0x18, 0x60, 0x1e, 0x06, 0x4b, 0x46, 0x42, 0x62, 0x46, 0x62,
-	0x3c, 0x18, 0x62, 0x22, 0x69, 0x3c, 0x3c, 0x18, 0x04, 0x08, 0x20, 0x00, 0x00, 0x00, 0x40, 0x42,
-	0x06, 0x42, 0x62, 0x18, 0x46, 0x46, 0x08, 0x30, 0x36, 0x18, 0x4b, 0x46, 0x46, 0x62, 0x46, 0x06,
-	0x06, 0x18, 0x42, 0x62, 0x69, 0x34, 0x46, 0x30, 0x0c, 0x18, 0x30, 0x6b, 0x00, 0x08, 0x00, 0x34,
-	0x30, 0x2c, 0xac, 0x00, 0x0c, 0x30, 0x36, 0x08, 0x18, 0x00, 0x00, 0x06, 0x62, 0x18, 0x04, 0x60,
-	0x7e, 0x60, 0x62, 0x18, 0x46, 0x60, 0x08, 0x10, 0x18, 0x7e, 0x20, 0x08, 0xa5, 0x7e, 0x62, 0x02,
-	0x42, 0x06, 0x06, 0x42, 0x46, 0x18, 0x42, 0x26, 0x02, 0x4b, 0x46, 0x62, 0x3e, 0x62, 0x3e, 0x60,
-	0x08, 0x62, 0x12, 0x69, 0x46, 0x18, 0x04, 0x04, 0x10, 0x20, 0x00, 0x00, 0x00, 0x7c, 0x46, 0x06,
-	0x62, 0x3e, 0x18, 0x46, 0x46, 0x0c, 0x30, 0x1e, 0x18, 0x4b, 0x46, 0x66, 0x62, 0x46, 0x06, 0x3c,
-	0x18, 0x62, 0x22, 0x69, 0x18, 0x46, 0x18, 0x18, 0x18, 0x18, 0x30, 0x00, 0x00, 0x00, 0x7e, 0x1e,
-	0x56, 0x46, 0x00, 0x08, 0x18, 0x00, 0x08, 0x18, 0x00, 0x00, 0x03, 0x62, 0x18, 0x06, 0x62, 0x30,
-	0x62, 0x62, 0x18, 0x46, 0x62, 0x00, 0x08, 0x30, 0x00, 0x10, 0x00, 0x79, 0x46, 0x62, 0x42, 0x42,
-	0x06, 0x06, 0x42, 0x46, 0x18, 0x42, 0x46, 0x02, 0x49, 0x42, 0x62, 0x06, 0x62, 0x46, 0x46, 0x08,
-	0x62, 0x0a, 0x69, 0x46, 0x18, 0x62, 0x04, 0x20, 0x20, 0x00, 0x00, 0x00, 0x62, 0x46, 0x02, 0x62,
-	0x06, 0x10, 0x7c, 0x46, 0x0c, 0x20, 0x26, 0x18, 0x4b, 0x46, 0x62, 0x62, 0x46, 0x06, 0x60, 0x08,
-	0x62, 0x12, 0x69, 0x2c, 0x7c, 0x0c, 0x18, 0x18, 0x18, 0x00, 0x00, 0x08, 0x00, 0x34, 0x08, 0x23,
-	0xbc, 0x00, 0x10, 0x0c, 0x00, 0x00, 0x08, 0x00, 0x08, 0x01, 0x3c, 0x7e, 0x7e, 0x3c, 0x30, 0x3c,
-	0x3c, 0x18, 0x3c, 0x3c, 0x00, 0x00, 0x60, 0x00, 0x08, 0x08, 0x02, 0x46, 0x3e, 0x3c, 0x3e, 0x7e,
-	0x06, 0x3c, 0x46, 0x3c, 0x3c, 0x46, 0x7e, 0x49, 0x42, 0x3c, 0x06, 0x6c, 0x46, 0x3c, 0x1c, 0x7c,
-	0x06, 0x7e, 0x46, 0x18, 0x7e, 0x1c, 0x40, 0x38, 0x00, 0x00, 0x00, 0x7c, 0x3e, 0x3c, 0x7c, 0x7c,
-	0x0c, 0x60, 0x42, 0x1c, 0x22, 0x46, 0x3c, 0x49, 0x42, 0x3c, 0x3e, 0x7c, 0x02, 0x3e, 0x30, 0x7c,
-	0x0e, 0x7e, 0x46, 0x60, 0x7e, 0x30, 0x18, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00,
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	0x3c, 0x00, 0x00, 0x1c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00,
-	0x00, 0x00, 0x3c, 0x00, 0x00, 0x18, 0x00, 0x00, 
-};
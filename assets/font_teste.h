@@ -1,55 +0,0 @@
-#ifndef _IMG_ASSET_SECTION
-#define _IMG_ASSET_SECTION ".data"
-#endif
-
-static const char __attribute__((aligned(4), section(_IMG_ASSET_SECTION ".font_8x8"))) font_8x8[] = {
-    0x00, 0x18, 0x36, 0x36, 0x18, 0x00, 0x1C, 0x0C, 0x30, 0x0C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x60,
-    0x3E, 0x18, 0x3E, 0x3F, 0x30, 0x7F, 0x3E, 0x7F, 0x3E, 0x3E, 0x00, 0x00, 0x30, 0x00, 0x0C, 0x3C,
-    0x3E, 0x1C, 0x3F, 0x3E, 0x1F, 0x7F, 0x7F, 0x3E, 0x63, 0x7E, 0x60, 0x63, 0x03, 0x63, 0x63, 0x3E,
-    0x3F, 0x3E, 0x3F, 0x3E, 0xFF, 0x63, 0x63, 0x63, 0x63, 0x63, 0x7F, 0x3C, 0x03, 0x3C, 0x08, 0x00,
-    0x18, 0x00, 0x03, 0x00, 0x60, 0x00, 0x38, 0x00, 0x03, 0x18, 0x60, 0x03, 0x1C, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x70, 0x18, 0x0E, 0x6E, 0x00,
-    0x18, 0x36, 0x36, 0x7E, 0x63, 0x36, 0x0C, 0x18, 0x18, 0x66, 0x18, 0x00, 0x00, 0x00, 0x30, 0x73,
-    0x1C, 0x63, 0x60, 0x33, 0x03, 0x03, 0x60, 0x63, 0x63, 0x18, 0x18, 0x18, 0x00, 0x18, 0x66, 0x63,
-    0x36, 0x63, 0x63, 0x33, 0x03, 0x03, 0x63, 0x63, 0x18, 0x60, 0x33, 0x03, 0x77, 0x67, 0x63, 0x63,
-    0x63, 0x63, 0x63, 0x18, 0x63, 0x63, 0x63, 0x63, 0x63, 0x60, 0x0C, 0x06, 0x30, 0x1C, 0x00, 0x18,
-    0x00, 0x03, 0x00, 0x60, 0x00, 0x6C, 0x00, 0x03, 0x00, 0x00, 0x03, 0x18, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x18, 0x18, 0x3B, 0x00, 0x18,
-    0x36, 0x7F, 0x03, 0x33, 0x1C, 0x06, 0x0C, 0x30, 0x3C, 0x18, 0x00, 0x00, 0x00, 0x18, 0x7B, 0x18,
-    0x60, 0x60, 0x33, 0x3F, 0x03, 0x60, 0x63, 0x63, 0x18, 0x18, 0x0C, 0x7E, 0x30, 0x30, 0x7B, 0x63,
-    0x63, 0x03, 0x63, 0x03, 0x03, 0x03, 0x63, 0x18, 0x60, 0x1B, 0x03, 0x7F, 0x6F, 0x63, 0x63, 0x63,
-    0x63, 0x03, 0x18, 0x63, 0x63, 0x63, 0x36, 0x63, 0x30, 0x0C, 0x0C, 0x30, 0x36, 0x00, 0x30, 0x3E,
-    0x03, 0x3E, 0x60, 0x3E, 0x0C, 0x7E, 0x3F, 0x1C, 0x60, 0x33, 0x18, 0x33, 0x3F, 0x3E, 0x3F, 0x7E,
-    0x3F, 0x7E, 0x7E, 0x63, 0x63, 0x63, 0x63, 0x63, 0x7F, 0x18, 0x18, 0x18, 0x00, 0x00, 0x18, 0x00,
-    0x36, 0x3E, 0x18, 0x6E, 0x00, 0x0C, 0x30, 0xFF, 0x7E, 0x00, 0x7E, 0x00, 0x0C, 0x6F, 0x18, 0x3E,
-    0x3C, 0x33, 0x60, 0x3F, 0x30, 0x3E, 0x7E, 0x00, 0x00, 0x06, 0x00, 0x60, 0x18, 0x7B, 0x63, 0x3F,
-    0x03, 0x63, 0x1F, 0x1F, 0x03, 0x7F, 0x18, 0x60, 0x0F, 0x03, 0x7F, 0x7B, 0x63, 0x3F, 0x63, 0x3F,
-    0x3E, 0x18, 0x63, 0x63, 0x63, 0x1C, 0x3E, 0x18, 0x0C, 0x18, 0x30, 0x63, 0x00, 0x00, 0x60, 0x3F,
-    0x63, 0x7E, 0x63, 0x1E, 0x63, 0x63, 0x18, 0x60, 0x1B, 0x18, 0x7F, 0x63, 0x63, 0x63, 0x63, 0x63,
-    0x03, 0x18, 0x63, 0x63, 0x63, 0x36, 0x63, 0x30, 0x0E, 0x00, 0x70, 0x00, 0x00, 0x18, 0x00, 0x7F,
-    0x60, 0x0C, 0x3B, 0x00, 0x0C, 0x30, 0x3C, 0x18, 0x00, 0x00, 0x00, 0x06, 0x67, 0x18, 0x03, 0x60,
-    0x7F, 0x60, 0x63, 0x18, 0x63, 0x60, 0x00, 0x00, 0x0C, 0x7E, 0x30, 0x18, 0x7B, 0x7F, 0x63, 0x03,
-    0x63, 0x03, 0x03, 0x73, 0x63, 0x18, 0x60, 0x1B, 0x03, 0x6B, 0x73, 0x63, 0x03, 0x6B, 0x1B, 0x60,
-    0x18, 0x63, 0x63, 0x6B, 0x36, 0x18, 0x0C, 0x0C, 0x30, 0x30, 0x00, 0x00, 0x00, 0x7E, 0x63, 0x03,
-    0x63, 0x7F, 0x0C, 0x63, 0x63, 0x18, 0x60, 0x1F, 0x18, 0x7F, 0x63, 0x63, 0x63, 0x63, 0x03, 0x3E,
-    0x18, 0x63, 0x63, 0x6B, 0x1C, 0x63, 0x1C, 0x18, 0x18, 0x18, 0x00, 0x00, 0x00, 0x00, 0x36, 0x3F,
-    0x66, 0x33, 0x00, 0x18, 0x18, 0x66, 0x18, 0x18, 0x00, 0x18, 0x03, 0x63, 0x18, 0x03, 0x60, 0x30,
-    0x63, 0x63, 0x0C, 0x63, 0x60, 0x18, 0x18, 0x18, 0x00, 0x18, 0x00, 0x03, 0x63, 0x63, 0x63, 0x33,
-    0x03, 0x03, 0x63, 0x63, 0x18, 0x63, 0x33, 0x03, 0x63, 0x63, 0x63, 0x03, 0x7B, 0x33, 0x63, 0x18,
-    0x63, 0x3E, 0x7F, 0x63, 0x0C, 0x06, 0x0C, 0x60, 0x30, 0x00, 0x00, 0x00, 0x63, 0x63, 0x63, 0x63,
-    0x03, 0x0C, 0x7E, 0x63, 0x18, 0x60, 0x33, 0x18, 0x6B, 0x63, 0x63, 0x3F, 0x7E, 0x03, 0x60, 0x18,
-    0x63, 0x3E, 0x7F, 0x36, 0x7E, 0x06, 0x18, 0x18, 0x18, 0x00, 0x00, 0x18, 0x00, 0x36, 0x18, 0x63,
-    0x6E, 0x00, 0x30, 0x0C, 0x00, 0x00, 0x18, 0x00, 0x18, 0x01, 0x3E, 0x7E, 0x7F, 0x3F, 0x30, 0x3E,
-    0x3E, 0x0C, 0x3E, 0x3E, 0x18, 0x18, 0x30, 0x00, 0x0C, 0x18, 0x7E, 0x63, 0x3F, 0x3E, 0x1F, 0x7F,
-    0x03, 0x3E, 0x63, 0x7E, 0x3E, 0x63, 0x7F, 0x63, 0x63, 0x3E, 0x03, 0x3E, 0x63, 0x3E, 0x18, 0x7F,
-    0x1C, 0x36, 0x63, 0x07, 0x7F, 0x3C, 0x40, 0x3C, 0x00, 0x00, 0x00, 0x7E, 0x3F, 0x3E, 0x7E, 0x3E,
-    0x1E, 0x60, 0x63, 0x3C, 0x63, 0x63, 0x3C, 0x6B, 0x63, 0x3E, 0x03, 0x60, 0x03, 0x3F, 0x70, 0x7E,
-    0x1C, 0x36, 0x63, 0x60, 0x7F, 0x70, 0x18, 0x0E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x0C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x3F, 0x00, 0x00, 0x3E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x3F, 0x00, 0x00, 0x00, 0x00, 0x00
-};
-
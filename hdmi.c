@@ -15,30 +15,37 @@
 #include "hardware/adc.h" 
 #include "dvi.h"
 #include "dvi_serialiser.h"
+#include "dvi_clock.h"
 #include "./include/common_dvi_pin_configs.h"
 #include "tmds_encode_font_2bpp.h"
+#include "telemetry.h"
+#include "keypad_proto.h"
+#include "text_screen.h"
+#include "ui.h"
 
 #include "pico/stdlib.h"
 #include "hardware/uart.h"
 #include "hardware/watchdog.h"
 #include "pico/time.h"
 
-// Inclusão do arquivo de fonte
-#include "./assets/font_teste.h"
-#define FONT_N_CHARS 95
-#define FONT_FIRST_ASCII 32
+// Fonte gerada no build por tools/font_gen.py (ver text_screen.c)
+#include "font_8x8.h"
 
-// AJUSTES PRINCIPAIS PARA DUPLICAÇÃO 3X (8x24)
-#define FONT_CHAR_WIDTH 8        
-#define FONT_CHAR_HEIGHT 24         
-#define FONT_ORIGINAL_HEIGHT 8      
-#define FONT_SCALE_FACTOR (FONT_CHAR_HEIGHT / FONT_ORIGINAL_HEIGHT) // Fator 3
-
-#define FRAME_WIDTH 640
-#define FRAME_HEIGHT 480
-#define VREG_VSEL VREG_VOLTAGE_1_20
+#define FRAME_WIDTH TEXT_SCREEN_WIDTH
+#define FRAME_HEIGHT TEXT_SCREEN_HEIGHT
 #define DVI_TIMING dvi_timing_640x480p_60hz
 
+// DVI_MIRROR=1 (opção HDMI_MIRROR do CMake): a mesma tela também sai numa
+// segunda saída DVI, para um painel remoto. Cada linha é codificada uma vez e
+// os dois DMAs leem o mesmo buffer TMDS (dvi_mirror_init). O CMake passa
+// também DVI_N_TMDS_BUFFERS=5 nesse modo.
+#ifndef DVI_MIRROR
+#define DVI_MIRROR 0
+#endif
+#ifndef DVI_MIRROR_CFG
+#define DVI_MIRROR_CFG picodvi_dvi_cfg_remoto
+#endif
+
 // Watchdog configuration
 #define WATCHDOG_TIMEOUT_MS 1000         
 #define HEARTBEAT_THRESHOLD_MS 100        
@@ -47,131 +54,320 @@
 static volatile uint32_t hb_core0_ms = 0;
 static volatile uint32_t hb_core1_ms = 0;
 
+// Telemetria: cada histograma tem um único escritor (ver telemetry.h)
+static tel_hist_t tel_core0_loop   = TEL_HIST_INIT("core0 laco");     // Core 0
+static tel_hist_t tel_core1_frame  = TEL_HIST_INIT("core1 quadro");   // Core 1
+static tel_hist_t tel_hb_age       = TEL_HIST_INIT("idade heartbeat"); // timer do WD
+static tel_hist_t tel_feed_period  = TEL_HIST_INIT("periodo WD");      // timer do WD
+static tel_boot_info_t boot_info;
+// Pedidos de zerar a telemetria: o comando 'r' liga, e o escritor de cada
+// histograma zera o seu (o Core 1 no fim do próximo quadro, o timer do WD na
+// próxima execução), então cada histograma continua com um único escritor
+static volatile bool tel_core1_reset_req;
+static volatile bool tel_wd_reset_req;
+
+static inline uint32_t heartbeat_age_ms(uint32_t now, uint32_t hb) {
+    // O heartbeat pode ser atualizado pelo outro núcleo depois de lermos now
+    int32_t age = (int32_t)(now - hb);
+    return age > 0 ? (uint32_t)age : 0;
+}
+
 // Timer para alimentar o watchdog somente quando ambos os núcleos estão saudáveis
 static repeating_timer_t wd_timer;
+static uint32_t wd_last_feed_us;
 static bool feed_watchdog_cb(repeating_timer_t *t) {
     uint32_t now = to_ms_since_boot(get_absolute_time());
-    if ((now - hb_core0_ms) < HEARTBEAT_THRESHOLD_MS &&
-        (now - hb_core1_ms) < HEARTBEAT_THRESHOLD_MS) {
+    uint32_t age0 = heartbeat_age_ms(now, hb_core0_ms);
+    uint32_t age1 = heartbeat_age_ms(now, hb_core1_ms);
+    if (tel_wd_reset_req) {
+        tel_hist_reset(&tel_hb_age);
+        tel_hist_reset(&tel_feed_period);
+        tel_wd_reset_req = false;
+    }
+    tel_hist_add(&tel_hb_age, MAX(age0, age1) * 1000);
+    tel_note_heartbeat_ages(age0, age1);
+    if (age0 < HEARTBEAT_THRESHOLD_MS && age1 < HEARTBEAT_THRESHOLD_MS) {
         watchdog_update();
+        uint32_t now_us = time_us_32();
+        if (wd_last_feed_us)
+            tel_hist_add(&tel_feed_period, now_us - wd_last_feed_us);
+        wd_last_feed_us = now_us;
+        tel_note_watchdog_fed(now);
     }
     return true; // continua repetindo
 }
 
-// UART configuration
-#define UART_ID uart0
-#define UART_BAUD 115200
-#define UART_RX_PIN 0
-#define UART_TX_PIN 1
+// Enlace com o teclado (quadros de keypad_proto.h), só no Core 0
+static kp_decoder_t link_decoder;
+static kp_link_t link_state;
+static uint64_t link_rx_us;     // último byte recebido
+
+static void print_link_stats(void) {
+    printf("Enlace teclado: %lu quadros, %lu eventos, %lu perdidos, %lu duplicados, %lu reinícios\n",
+        (unsigned long)link_state.frames, (unsigned long)link_state.events,
+        (unsigned long)link_state.lost_events, (unsigned long)link_state.dup_events,
+        (unsigned long)link_state.restarts);
+    printf("  erros de CRC %lu, tamanhos inválidos %lu, bytes descartados %lu, quadros expirados %lu\n",
+        (unsigned long)link_decoder.crc_errors, (unsigned long)link_decoder.bad_lengths,
+        (unsigned long)link_decoder.skipped_bytes, (unsigned long)link_decoder.timeouts);
+}
 
-// Password configuration
-#define PASSWORD_LEN 4
-#define MAX_ATTEMPTS 3
-#define LOCKOUT_MS 30000
-static const char PASSWORD[PASSWORD_LEN + 1] = "3333";
+// Relatório sob demanda pela USB
+static void print_telemetry(void) {
+    printf("\n--- Telemetria (WATCHDOG_TIMEOUT_MS=%d, HEARTBEAT_THRESHOLD_MS=%d) ---\n",
+        WATCHDOG_TIMEOUT_MS, HEARTBEAT_THRESHOLD_MS);
+    tel_boot_print(&boot_info);
+    tel_hist_print(&tel_core0_loop);
+    tel_hist_print(&tel_core1_frame);
+    tel_hist_print(&tel_hb_age);
+    tel_hist_print(&tel_feed_period);
+    print_link_stats();
+    // Margens: quanto falta para o pior caso observado atingir cada limite
+    if (tel_hb_age.count) {
+        printf("Margem heartbeat: %ld ms (p99 %ld ms)\n",
+            (long)HEARTBEAT_THRESHOLD_MS - (long)(tel_hb_age.max_us / 1000),
+            (long)HEARTBEAT_THRESHOLD_MS - (long)(tel_hist_percentile_us(&tel_hb_age, 990) / 1000));
+    }
+    if (tel_feed_period.count) {
+        printf("Margem watchdog:  %ld ms\n",
+            (long)WATCHDOG_TIMEOUT_MS - (long)(tel_feed_period.max_us / 1000));
+    }
+}
 
 struct dvi_inst dvi0;
+#if DVI_MIRROR
+struct dvi_inst dvi1;
+#endif
+
+// ----------------------------------------------------------------------------
+// Sonda de latência tecla -> tela (analisada por tools/latency_report.py)
+//
+// Um dígito por vez é acompanhado até aparecer na tela. Cada instante é
+// marcado por quem o observa, no relógio do receptor:
+//  - Core 0: quadro decodificado (rx) e '*' escrito em charbuf (write);
+//  - Core 1: primeira linha de pixels da linha de texto codificada depois da
+//    escrita (encode), guardando o buffer TMDS que ela usou;
+//  - IRQ do DMA (scanline_callback): esse buffer sai de q_tmds_valid e é
+//    carregado para a próxima linha de saída (scanout), com o v_ctr do
+//    estado de temporização do DVI.
+// Os instantes do emissor (evento e montagem do quadro) vêm no próprio
+// quadro. Com 'l' no terminal USB, cada medida completa vira uma linha "LAT".
+#define LAT_TIMEOUT_US 200000
+
+typedef enum {
+    LAT_IDLE,
+    LAT_ARMED,      // Core 0 escreveu em charbuf
+    LAT_ENCODED,    // Core 1 codificou a linha de texto
+    LAT_DONE        // a IRQ do DMA carregou a linha para saída
+} lat_state_t;
+
+static struct {
+    volatile lat_state_t state;
+    uint row;                   // linha de texto que mudou
+    uint16_t seq;               // sequência do evento no enlace
+    uint8_t key;
+    uint8_t frame_bytes;
+    uint32_t event_us;          // relógio do emissor
+    uint32_t frame_us;          // relógio do emissor
+    uint32_t rx_us;
+    uint32_t write_us;
+    uint32_t encode_us;
+    uint encode_line;
+    const uint32_t *tmdsbuf;
+    uint32_t scanout_us;
+    uint scanout_line;
+} lat_probe;
+static bool lat_log_enabled;
+static uint32_t lat_busy, lat_timeouts;
+
+// Core 0, depois de escrever em charbuf
+static void lat_arm(uint row, const kp_frame_t *frame, uint i, uint32_t rx_us) {
+    if (!lat_log_enabled)
+        return;
+    if (lat_probe.state != LAT_IDLE) {
+        ++lat_busy;
+        return;
+    }
+    lat_probe.row = row;
+    lat_probe.seq = (uint16_t)(frame->seq + i);
+    lat_probe.key = frame->events[i].key;
+    lat_probe.frame_bytes = (uint8_t)KP_FRAME_BYTES(frame->n_events);
+    lat_probe.event_us = frame->events[i].time_us;
+    lat_probe.frame_us = frame->time_us;
+    lat_probe.rx_us = rx_us;
+    lat_probe.write_us = time_us_32();
+    __dmb();
+    lat_probe.state = LAT_ARMED;
+}
 
-// Definições do terminal de caracteres
-// CHAR_COLS: 640 / 8 = 80 
-// CHAR_ROWS: 480 / 24 = 20 
-#define CHAR_COLS (FRAME_WIDTH / FONT_CHAR_WIDTH)
-#define CHAR_ROWS (FRAME_HEIGHT / FONT_CHAR_HEIGHT) 
-
-// Buffers para caracteres e cores
-#define COLOUR_PLANE_SIZE_WORDS (CHAR_ROWS * CHAR_COLS * 4 / 32)
-char charbuf[CHAR_ROWS * CHAR_COLS];
-uint32_t colourbuf[3 * COLOUR_PLANE_SIZE_WORDS];
+// Core 1, antes de codificar a linha de pixels y (da linha de texto row)
+static inline bool lat_wants_line(uint row) {
+    return lat_probe.state == LAT_ARMED && lat_probe.row == row;
+}
 
-// Uso do botão B para o BOOTSEL
-#define botaoB 6
-void gpio_irq_handler(uint gpio, uint32_t events) {
-    reset_usb_boot(0, 0);
+// Core 1, depois de codificar e antes de pôr o buffer em q_tmds_valid
+static inline void lat_note_encoded(const uint32_t *tmdsbuf, uint32_t encode_us, uint y) {
+    lat_probe.encode_us = encode_us;
+    lat_probe.encode_line = y;
+    lat_probe.tmdsbuf = tmdsbuf;
+    // Os campos acima são escritas comuns: sem a barreira o compilador pode
+    // movê-las para depois de state, e a IRQ compararia um tmdsbuf antigo
+    __dmb();
+    lat_probe.state = LAT_ENCODED;
 }
 
-// Função para definir um caractere na tela
-static inline void set_char(uint x, uint y, char c) {
-    if (x >= CHAR_COLS || y >= CHAR_ROWS)
-        return;
-    charbuf[x + y * CHAR_COLS] = c;
+// IRQ do DMA no Core 1: tmds_buf_release_next é o buffer que acabou de ser
+// carregado para a linha v_ctr
+static void __not_in_flash_func(lat_scanline_cb)(void) {
+    if (lat_probe.state == LAT_ENCODED && dvi0.tmds_buf_release_next == lat_probe.tmdsbuf) {
+        lat_probe.scanout_us = time_us_32();
+        lat_probe.scanout_line = dvi0.timing_state.v_ctr;
+        __dmb();
+        lat_probe.state = LAT_DONE;
+    }
 }
 
-// Função para definir a cor de um caractere (formato RGB222)
-static inline void set_colour(uint x, uint y, uint8_t fg, uint8_t bg) {
-    if (x >= CHAR_COLS || y >= CHAR_ROWS)
+// Core 0: imprime a medida completa ou descarta uma que ficou presa (linha
+// descartada por atraso do Core 1, por exemplo)
+static void lat_poll(void) {
+    lat_state_t state = lat_probe.state;
+    if (state == LAT_IDLE)
+        return;
+    if (state != LAT_DONE) {
+        if (time_us_32() - lat_probe.write_us > LAT_TIMEOUT_US) {
+            ++lat_timeouts;
+            lat_probe.state = LAT_IDLE;
+        }
         return;
-    uint char_index = x + y * CHAR_COLS;
-    uint bit_index = char_index % 8 * 4;
-    uint word_index = char_index / 8;
-    for (int plane = 0; plane < 3; ++plane) {
-        uint32_t fg_bg_combined = (fg & 0x3) | (bg << 2 & 0xc);
-        colourbuf[word_index] = (colourbuf[word_index] & ~(0xfu << bit_index)) | (fg_bg_combined << bit_index);
-        fg >>= 2;
-        bg >>= 2;
-        word_index += COLOUR_PLANE_SIZE_WORDS;
     }
+    __dmb();
+    printf("LAT seq=%u key=%c bytes=%u ev=%lu fr=%lu rx=%lu wr=%lu enc=%lu line=%u out=%lu vline=%u\n",
+        lat_probe.seq, lat_probe.key, lat_probe.frame_bytes,
+        (unsigned long)lat_probe.event_us, (unsigned long)lat_probe.frame_us,
+        (unsigned long)lat_probe.rx_us, (unsigned long)lat_probe.write_us,
+        (unsigned long)lat_probe.encode_us, lat_probe.encode_line,
+        (unsigned long)lat_probe.scanout_us, lat_probe.scanout_line);
+    lat_probe.state = LAT_IDLE;
 }
 
-static inline void clear_line(uint y, uint8_t bg) {
-    if (y >= CHAR_ROWS) return;
-    for (uint x = 1; x < CHAR_COLS - 1; ++x) {
-        set_char(x, y, ' ');
-        set_colour(x, y, 0x00, bg);
+// 't' imprime o relatório, 'r' zera os histogramas, 'l' liga/desliga a sonda
+static void poll_telemetry_console(void) {
+    int c = getchar_timeout_us(0);
+    if (c == 't') {
+        print_telemetry();
+    }
+    else if (c == 'l') {
+        lat_log_enabled = !lat_log_enabled;
+        printf("Sonda de latência %s (%lu ignoradas com medida em curso, %lu expiradas)\n",
+            lat_log_enabled ? "ligada" : "desligada",
+            (unsigned long)lat_busy, (unsigned long)lat_timeouts);
+    }
+    else if (c == 'r') {
+        tel_hist_reset(&tel_core0_loop);
+        tel_core1_reset_req = true;
+        tel_wd_reset_req = true;
+        printf("Telemetria zerada\n");
     }
 }
 
-static inline void write_text(int start_x, int y, const char *text, uint8_t fg, uint8_t bg) {
-    if (y < 0 || y >= (int)CHAR_ROWS || !text) return;
-    for (int i = 0; text[i] != '\0'; ++i) {
-        int x = start_x + i;
-        if (x <= 0 || x >= (int)CHAR_COLS - 1) continue;
-        set_char((uint)x, (uint)y, text[i]);
-        set_colour((uint)x, (uint)y, fg, bg);
-    }
+// UART configuration
+#define UART_ID uart0
+#define UART_BAUD 115200
+#define UART_RX_PIN 0
+#define UART_TX_PIN 1
+
+// Linha parada por mais que um quadro máximo (10 bits por byte): o emissor
+// manda cada quadro de uma vez por DMA, então um quadro incompleto no
+// decodificador não vai mais ser completado
+#define LINK_IDLE_US (KP_FRAME_MAX_BYTES * 10 * 1000000ull / UART_BAUD)
+
+// Período de polling do laço principal. Nenhum estado da IHM bloqueia por
+// mais que isso, então a latência de entrada e o heartbeat do Core 0 ficam
+// limitados a UI_POLL_US em todos os estados.
+#define UI_POLL_US 1000
+
+// Uso do botão B para o BOOTSEL
+#define botaoB 6
+void gpio_irq_handler(uint gpio, uint32_t events) {
+    reset_usb_boot(0, 0);
 }
 
-static inline void write_centered(int y, const char *text, uint8_t fg, uint8_t bg) {
-    int len = (int)strlen(text);
-    int start_x = (CHAR_COLS / 2) - (len / 2);
-    write_text(start_x, y, text, fg, bg);
+static void __not_in_flash_func(encode_text_line)(uint32_t *tmdsbuf, uint row, uint attr, uint font_row) {
+    const uint8_t *chars = (const uint8_t*)&charbuf[row * CHAR_COLS];
+    const uint8_t *font_line = (const uint8_t*)&font_8x8[font_row * FONT_N_CHARS] - FONT_FIRST_CHAR;
+    // Linhas com largura dupla usam o codificador com pixels duplicados
+    // (320 pixels lógicos, uma busca na tabela a cada 16 px), que custa cerca
+    // de 3/4 de uma linha de 80 colunas
+    bool hdouble = attr & TEXT_ROW_HDOUBLE;
+    for (int plane = 0; plane < 3; ++plane) {
+        const uint32_t *colours = &colourbuf[row * COLOUR_ROW_WORDS + plane * COLOUR_PLANE_SIZE_WORDS];
+        uint32_t *plane_buf = tmdsbuf + plane * (FRAME_WIDTH / DVI_SYMBOLS_PER_WORD);
+        if (hdouble)
+            tmds_encode_font_2bpp_2x(chars, colours, plane_buf, FRAME_WIDTH / 2, font_line);
+        else
+            tmds_encode_font_2bpp(chars, colours, plane_buf, FRAME_WIDTH, font_line);
+    }
 }
 
 // Função principal do Core 1 (renderização DVI)
 void core1_main() {
     dvi_register_irqs_this_core(&dvi0, DMA_IRQ_0);
     dvi_start(&dvi0);
+#if DVI_MIRROR
+    // Logo depois da primeira, no mesmo núcleo: a defasagem entre as saídas
+    // fica abaixo de uma linha (ver dvi_mirror_init em dvi.h)
+    dvi_start(&dvi1);
+#endif
+    uint32_t last_frame_us = time_us_32();
     while (true) {
+        text_raster_t r;
+        text_raster_start(&r);
         for (uint y = 0; y < FRAME_HEIGHT; ++y) {
-            
-            // Lógica de Duplicação Vertical (Fator 3)
-            // Calcula a linha do pixel da fonte original (0 a 7), repetindo 3 vezes
-            uint font_row = (y % FONT_CHAR_HEIGHT) / FONT_SCALE_FACTOR; 
-
-            uint32_t *tmdsbuf;
-            queue_remove_blocking(&dvi0.q_tmds_free, &tmdsbuf);
-            for (int plane = 0; plane < 3; ++plane) {
-                tmds_encode_font_2bpp(
-                    (const uint8_t*)&charbuf[y / FONT_CHAR_HEIGHT * CHAR_COLS],
-                    &colourbuf[y / FONT_CHAR_HEIGHT * (COLOUR_PLANE_SIZE_WORDS / CHAR_ROWS) + plane * COLOUR_PLANE_SIZE_WORDS],
-                    tmdsbuf + plane * (FRAME_WIDTH / DVI_SYMBOLS_PER_WORD),
-                    FRAME_WIDTH,
-                    
-                    (const uint8_t*)&font_8x8[font_row * FONT_N_CHARS] - FONT_FIRST_ASCII
-                );
+            uint32_t *tmdsbuf = dvi_get_tmds_free(&dvi0);
+            if (lat_wants_line(r.row)) {
+                uint32_t encode_us = time_us_32();
+                encode_text_line(tmdsbuf, r.row, r.attr, r.font_row);
+                lat_note_encoded(tmdsbuf, encode_us, y);
             }
-            queue_add_blocking(&dvi0.q_tmds_valid, &tmdsbuf);
+            else {
+                encode_text_line(tmdsbuf, r.row, r.attr, r.font_row);
+            }
+            dvi_put_tmds_valid(&dvi0, tmdsbuf);
+            text_raster_next(&r);
         }
         // Heartbeat do Core 1 por frame completo
         hb_core1_ms = to_ms_since_boot(get_absolute_time());
+        uint32_t frame_us = time_us_32();
+        if (tel_core1_reset_req) {
+            tel_hist_reset(&tel_core1_frame);
+            tel_core1_reset_req = false;
+        }
+        else {
+            tel_hist_add(&tel_core1_frame, frame_us - last_frame_us);
+        }
+        last_frame_us = frame_us;
     }
 }
 
 // Função principal do Core 0 (lógica principal)
 int __not_in_flash("main") main() {
-    vreg_set_voltage(VREG_VSEL);
+    // Roda o sistema no clock de bits do TMDS, com PLL e tensão do plano de
+    // clock da temporização (host/clock_plan mostra o de cada modo)
+    dvi_clock_plan_t clock_plan;
+    if (!dvi_clock_plan(&DVI_TIMING, &clock_plan))
+        panic("Sem PLL para %u kHz", DVI_TIMING.bit_clk_khz);
+    // vreg_voltage vai de 50 em 50 mV
+    vreg_set_voltage(VREG_VOLTAGE_1_10 + (clock_plan.vreg_mv - 1100) / 50);
     sleep_ms(10);
-    // Roda o sistema no clock de bits do TMDS
-    set_sys_clock_khz(DVI_TIMING.bit_clk_khz, true);
+    set_sys_clock_pll(clock_plan.vco_khz * 1000, clock_plan.postdiv1, clock_plan.postdiv2);
+    stdio_init_all();
+
+    // Registra a causa deste reset antes de religar o watchdog
+    tel_boot_record(&boot_info);
+    printf("Clock: %lu kHz (VCO %lu kHz / %u / %u), %u mV, %lu.%03lu Hz\n",
+        (unsigned long)clock_plan.sys_khz, (unsigned long)clock_plan.vco_khz,
+        clock_plan.postdiv1, clock_plan.postdiv2, clock_plan.vreg_mv,
+        (unsigned long)(clock_plan.refresh_mhz / 1000), (unsigned long)(clock_plan.refresh_mhz % 1000));
 
     // --- CONFIGURAÇÃO DO BOTÃO BOOTSEL ---
     gpio_init(botaoB);
@@ -182,7 +378,14 @@ int __not_in_flash("main") main() {
 
     dvi0.timing = &DVI_TIMING;
     dvi0.ser_cfg = picodvi_dvi_cfg;
+    dvi0.scanline_callback = lat_scanline_cb;
     dvi_init(&dvi0, next_striped_spin_lock_num(), next_striped_spin_lock_num());
+#if DVI_MIRROR
+    dvi1.timing = &DVI_TIMING;
+    dvi1.ser_cfg = DVI_MIRROR_CFG;
+    dvi_init(&dvi1, next_striped_spin_lock_num(), next_striped_spin_lock_num());
+    dvi_mirror_init(&dvi0, &dvi1);
+#endif
 
     // Inicializa heartbeat de ambos os núcleos para evitar reset precoce
     uint32_t now_ms = to_ms_since_boot(get_absolute_time());
@@ -194,122 +397,79 @@ int __not_in_flash("main") main() {
     // Timer periódico para tentar alimentar o WD somente se ambos estiverem operantes
     add_repeating_timer_ms(50, feed_watchdog_cb, NULL, &wd_timer);
 
-    // Limpa a tela inteira com fundo preto uma única vez no início
-    for (uint y = 0; y < CHAR_ROWS; ++y) {
-        for (uint x = 0; x < CHAR_COLS; ++x) {
-            set_char(x, y, ' ');
-            set_colour(x, y, 0x00, 0x00); // Fundo preto
-        }
-    }
+    // Define a escala de cada linha e limpa a tela com fundo preto
+    ui_setup_layout();
 
     // Inicializa UART para receber senha
     uart_init(UART_ID, UART_BAUD);
     gpio_set_function(UART_TX_PIN, GPIO_FUNC_UART);
     gpio_set_function(UART_RX_PIN, GPIO_FUNC_UART);
+    kp_decoder_init(&link_decoder);
+    kp_link_init(&link_state);
+
+#if DVI_MIRROR
+    // O IRQ da segunda saída fica no Core 0 (DMA_IRQ_1), para não somar outro
+    // IRQ por linha ao Core 1, que já gasta a maior parte da linha codificando.
+    // No Core 0 ele divide o núcleo com a USB e o timer do watchdog; com a
+    // prioridade padrão pode esperar atrás deles mais que uma linha (31,7 us)
+    // e a saída espelhada falha, então fica com a mais alta.
+    dvi_register_irqs_this_core(&dvi1, DMA_IRQ_1);
+    irq_set_priority(DMA_IRQ_1, 0);
+#endif
 
     // Inicia o Core 1 para renderização
     hw_set_bits(&bus_ctrl_hw->priority, BUSCTRL_BUS_PRIORITY_PROC1_BITS);
     multicore_launch_core1(core1_main);
 
-    // Lógica de validação de senha via UART
-    const char *prompt_msg = "Digite a senha (4 digitos):";
-    const char *title = "COFRE ELETRONICO";
-    int prompt_y = (CHAR_ROWS / 2) - 1;
-    int input_y = prompt_y + 1;
-    int attempts = 0;
-    char input[PASSWORD_LEN + 1] = {0};
-    int input_index = 0;
-
-    clear_line(prompt_y, 0x00);
-    clear_line(input_y, 0x00);
-    write_centered(prompt_y - 2, title, 0x3f, 0x00); // branco sobre preto
-    write_centered(prompt_y, prompt_msg, 0x3f, 0x00); // branco sobre preto
-
-    int input_base_x = (CHAR_COLS / 2) - (PASSWORD_LEN / 2);
-
-    // Detecta reinicialização por watchdog e gerencia a contagem
-    if (watchdog_caused_reboot())
-    {
-        // Recupera o valor salvo no registrador scratch[0], incrementa e salva novamente
-        uint32_t reset_count = watchdog_hw->scratch[0];
-        reset_count++;
-        watchdog_hw->scratch[0] = reset_count;
-
-        printf("\n\n>>> Reiniciado pelo Watchdog! Contagem de resets: %d\n", reset_count);
-    }
+    // Detecta reinicialização por watchdog (contagem e histórico nos scratch)
+    if (boot_info.watchdog_reset_count)
+        printf("\n\n>>> Reiniciado pelo Watchdog! Contagem de resets: %lu\n", (unsigned long)boot_info.watchdog_reset_count);
     else
-    {
-        // Reset normal (energia ligada agora): zera o contador
-        printf(">>> Reset normal (Power On). Iniciando contador em 0.\n");
-        watchdog_hw->scratch[0] = 0;
-    }
+        printf(">>> Reset normal (%s). Iniciando contador em 0.\n", tel_reset_cause_str(boot_info.cause));
+
+    // Lógica de validação de senha via UART
+    ui_t ui = {
+        .watchdog_resets = boot_info.watchdog_reset_count,
+        .reset_cause = tel_reset_cause_str(boot_info.cause),
+    };
+    ui_start(&ui, time_us_64());
 
+    uint32_t last_loop_us = time_us_32();
     while (true) {
+        uint64_t now_us = time_us_64();
         // Heartbeat do Core 0 por laço principal
-        hb_core0_ms = to_ms_since_boot(get_absolute_time());
-        if (uart_is_readable(UART_ID)) {
-            char ch = (char)uart_getc(UART_ID);
-            if (ch >= '0' && ch <= '9') {
-                if (input_index < PASSWORD_LEN) {
-                    input[input_index] = ch;
-                    // Mostrar '*' para cada dígito
-                    set_char((uint)(input_base_x + input_index), (uint)input_y, '*');
-                    set_colour((uint)(input_base_x + input_index), (uint)input_y, 0x3C, 0x00); // amarelo sobre preto
-                    input_index++;
-                }
-                if (input_index == PASSWORD_LEN) {
-                    input[PASSWORD_LEN] = '\0';
-                    // Verifica senha
-                    if (strncmp(input, PASSWORD, PASSWORD_LEN) == 0) {
-                         // Limpa a tela inteira com fundo preto uma única vez no início
-                        for (uint y = 0; y < CHAR_ROWS; ++y) {
-                            for (uint x = 0; x < CHAR_COLS; ++x) {
-                                set_char(x, y, ' ');
-                                set_colour(x, y, 0x0C, 0x0C); // Fundo verde
-                            }
-                        }
-                        write_centered(prompt_y - 2, title, 0x3f, 0x0c); // branco sobre verde
-                        write_centered(prompt_y, "Bem vindo", 0x3f, 0x0c); // branco sobre verde
-                        // Sucesso: permanece mostrando mensagem
-                    } else {
-                         // Limpa a tela inteira com fundo preto uma única vez no início
-                        for (uint y = 0; y < CHAR_ROWS; ++y) {
-                            for (uint x = 0; x < CHAR_COLS; ++x) {
-                                set_char(x, y, ' ');
-                                set_colour(x, y, 0x30, 0x30); // Fundo vermelho
-                            }
-                        }
-                        attempts++;
-                        write_centered(prompt_y - 2, title, 0x3f, 0x30); // branco sobre vermelho escuro
-                        write_centered(prompt_y, "Senha incorreta. Tente novamente.", 0x3f, 0x30); // branco sobre vermelho escuro
-                        sleep_ms(3000);
-
-                        if (attempts >= MAX_ATTEMPTS) {
-                            write_centered(input_y+2, "Bloqueado por 30 segundos...", 0x3f, 0x30);
-                            sleep_ms(LOCKOUT_MS);
-                            attempts = 0;
-                            clear_line(prompt_y, 0x00);
-                            clear_line(input_y+2, 0x00);
-                        }
-
-                        // Reinicia entrada
-                        memset(input, 0, sizeof(input));
-                        input_index = 0;
-                         // Limpa a tela inteira com fundo preto
-                        for (uint y = 0; y < CHAR_ROWS; ++y) {
-                            for (uint x = 0; x < CHAR_COLS; ++x) {
-                                set_char(x, y, ' ');
-                                set_colour(x, y, 0x00, 0x00); // Fundo preto
-                            }
-                        }
-                        write_centered(prompt_y - 2, title, 0x3f, 0x00); // branco sobre preto
-                        write_centered(prompt_y, prompt_msg, 0x3f, 0x00);
-                    }
-                }
+        hb_core0_ms = (uint32_t)(now_us / 1000);
+        uint32_t loop_us = time_us_32();
+        tel_hist_add(&tel_core0_loop, loop_us - last_loop_us);
+        last_loop_us = loop_us;
+        poll_telemetry_console();
+        // Consome todos os bytes disponíveis (a FIFO da UART tem só 32
+        // posições). Cada quadro válido entrega suas teclas pressionadas,
+        // menos as que já tinham chegado num quadro repetido. Com a linha
+        // parada por LINK_IDLE_US e bytes no decodificador, o quadro
+        // incompleto é descartado para não segurar os que vêm atrás dele.
+        while (true) {
+            kp_frame_t frame;
+            if (uart_is_readable(UART_ID)) {
+                link_rx_us = now_us;
+                if (!kp_decoder_feed(&link_decoder, (uint8_t)uart_getc(UART_ID), &frame))
+                    continue;
+            }
+            else if (link_decoder.len && now_us - link_rx_us >= LINK_IDLE_US) {
+                if (!kp_decoder_idle(&link_decoder, &frame))
+                    continue;
             }
+            else {
+                break;
+            }
+            uint32_t rx_us = time_us_32();
+            uint32_t shown = ui_on_frame(&ui, &link_state, &frame, now_us);
+            // A sonda acompanha o primeiro dígito que mudou a tela
+            if (shown)
+                lat_arm(UI_INPUT_Y, &frame, (uint)__builtin_ctz(shown), rx_us);
         }
-        sleep_ms(10);
+        ui_tick(&ui, now_us);
+        lat_poll();
+        sleep_us(UI_POLL_US);
     }
 }
-
-
@@ -0,0 +1,140 @@
+// Substitutos em C dos laços de libsprite/sprite.S para o build de host.
+// Mesma semântica pixel a pixel do assembly: o bit de alfa é o bit 5
+// (RAGB2132 e RGAB5515), as misturas usam a mesma média truncada por canal,
+// e os laços afins leem OVERF de CTRL_LANE0 antes de cada POP_FULL do
+// interp0, percorrendo o span da direita para a esquerda.
+
+#include "hardware/interp.h"
+#include "sprite.h"
+
+#define ALPHA_BIT (1u << 5)
+
+void sprite_fill8(uint8_t *dst, uint8_t colour, uint len) {
+    for (uint i = 0; i < len; ++i)
+        dst[i] = colour;
+}
+
+void sprite_fill16(uint16_t *dst, uint16_t colour, uint len) {
+    for (uint i = 0; i < len; ++i)
+        dst[i] = colour;
+}
+
+void sprite_blit8(uint8_t *dst, const uint8_t *src, uint len) {
+    for (uint i = 0; i < len; ++i)
+        dst[i] = src[i];
+}
+
+void sprite_blit8_alpha(uint8_t *dst, const uint8_t *src, uint len) {
+    for (uint i = 0; i < len; ++i)
+        if (src[i] & ALPHA_BIT)
+            dst[i] = src[i];
+}
+
+void sprite_blit16(uint16_t *dst, const uint16_t *src, uint len) {
+    for (uint i = 0; i < len; ++i)
+        dst[i] = src[i];
+}
+
+void sprite_blit16_alpha(uint16_t *dst, const uint16_t *src, uint len) {
+    for (uint i = 0; i < len; ++i)
+        if (src[i] & ALPHA_BIT)
+            dst[i] = src[i];
+}
+
+// ----------------------------------------------------------------------------
+// Misturas RGB565 (BLEND_MASK de sprite.S, por pixel)
+
+static inline uint16_t blend_avg2(uint16_t a, uint16_t b) {
+    return (uint16_t)((a & b) + (((a ^ b) & 0xf7deu) >> 1));
+}
+
+// percent é o peso de src
+static inline uint16_t blend_op(uint16_t src, uint16_t dst, int percent) {
+    switch (percent) {
+        case 25: return blend_avg2(blend_avg2(src, dst), dst);
+        case 50: return blend_avg2(src, dst);
+        default: return blend_avg2(blend_avg2(dst, src), src);
+    }
+}
+
+static void fill16_blend(uint16_t *dst, uint16_t colour, uint len, int percent) {
+    for (uint i = 0; i < len; ++i)
+        dst[i] = blend_op(colour, dst[i], percent);
+}
+
+void sprite_fill16_blend25(uint16_t *dst, uint16_t colour, uint len) {
+    fill16_blend(dst, colour, len, 25);
+}
+
+void sprite_fill16_blend50(uint16_t *dst, uint16_t colour, uint len) {
+    fill16_blend(dst, colour, len, 50);
+}
+
+void sprite_fill16_blend75(uint16_t *dst, uint16_t colour, uint len) {
+    fill16_blend(dst, colour, len, 75);
+}
+
+static void blit16_blend_alpha(uint16_t *dst, const uint16_t *src, uint len, int percent) {
+    for (uint i = 0; i < len; ++i)
+        if (src[i] & ALPHA_BIT)
+            dst[i] = blend_op(src[i], dst[i], percent);
+}
+
+void sprite_blit16_blend25_alpha(uint16_t *dst, const uint16_t *src, uint len) {
+    blit16_blend_alpha(dst, src, len, 25);
+}
+
+void sprite_blit16_blend50_alpha(uint16_t *dst, const uint16_t *src, uint len) {
+    blit16_blend_alpha(dst, src, len, 50);
+}
+
+void sprite_blit16_blend75_alpha(uint16_t *dst, const uint16_t *src, uint len) {
+    blit16_blend_alpha(dst, src, len, 75);
+}
+
+// ----------------------------------------------------------------------------
+// Laços internos dos sprites afins (interp0 configurado por sprite.c)
+
+// Retorna o texel da próxima coordenada, ou NULL se ela estiver fora da
+// textura. O POP acontece nos dois casos, como no assembly.
+static inline const void *ablit_next_texel(interp_hw_t *interp) {
+    bool overf = interp_read_ctrl(interp, 0) & SIO_INTERP0_CTRL_LANE0_OVERF_BITS;
+    uint32_t addr = interp_pop_full_result(interp);
+    return overf ? NULL : interp_result_ptr(addr);
+}
+
+void sprite_ablit8_loop(uint8_t *dst, uint len) {
+    interp_hw_t *interp = interp0_hw;
+    for (uint i = len; i-- > 0;) {
+        const uint8_t *texel = ablit_next_texel(interp);
+        if (texel)
+            dst[i] = *texel;
+    }
+}
+
+void sprite_ablit8_alpha_loop(uint8_t *dst, uint len) {
+    interp_hw_t *interp = interp0_hw;
+    for (uint i = len; i-- > 0;) {
+        const uint8_t *texel = ablit_next_texel(interp);
+        if (texel && (*texel & ALPHA_BIT))
+            dst[i] = *texel;
+    }
+}
+
+void sprite_ablit16_loop(uint16_t *dst, uint len) {
+    interp_hw_t *interp = interp0_hw;
+    for (uint i = len; i-- > 0;) {
+        const uint16_t *texel = ablit_next_texel(interp);
+        if (texel)
+            dst[i] = *texel;
+    }
+}
+
+void sprite_ablit16_alpha_loop(uint16_t *dst, uint len) {
+    interp_hw_t *interp = interp0_hw;
+    for (uint i = len; i-- > 0;) {
+        const uint16_t *texel = ablit_next_texel(interp);
+        if (texel && (*texel & ALPHA_BIT))
+            dst[i] = *texel;
+    }
+}
@@ -0,0 +1,68 @@
+// Substitutos em C dos laços de libsprite/tile.S para o build de host. O
+// interp1 fornece, a cada POP_FULL, o ponteiro para o próximo índice do
+// mapa de tiles (configurado por tile.c); como no assembly, há um POP no
+// início de cada tile, inclusive dos parciais nas pontas do span.
+
+#include "hardware/interp.h"
+#include "tile.h"
+
+#define ALPHA_BIT (1u << 5)
+
+static inline const uint8_t *next_tile_img(const uint8_t *tileset, uint img_shift) {
+    const uint8_t *map_entry = interp_result_ptr(interp_pop_full_result(interp1_hw));
+    return tileset + ((uint)*map_entry << img_shift);
+}
+
+static inline void copy_px(uint8_t **dst, const uint8_t **src, uint pixel_bytes, bool alpha) {
+    uint32_t pix = pixel_bytes == 2 ? *(const uint16_t*)*src : **src;
+    if (!alpha || (pix & ALPHA_BIT)) {
+        if (pixel_bytes == 2)
+            *(uint16_t*)*dst = (uint16_t)pix;
+        else
+            **dst = (uint8_t)pix;
+    }
+    *src += pixel_bytes;
+    *dst += pixel_bytes;
+}
+
+// pixel_bytes 1 ou 2; x0/x1 em pixels no espaço dos tiles. Mesma estrutura
+// do macro tile_loop: pixels avulsos até alinhar com um tile (sem olhar x1,
+// então um span que termina antes disso escreve além de x1), tiles inteiros,
+// e o tile parcial do fim.
+static void tile_loop(uint8_t *dst, const uint8_t *tileset, uint x0, uint x1,
+    uint log_tile, uint pixel_bytes, bool alpha) {
+    uint pixshift = pixel_bytes - 1;
+    uint img_shift = 2 * log_tile + pixshift;
+    uint tile_mask = (1u << log_tile) - 1;
+    const uint8_t *src;
+    uint x = x0;
+    if (x & tile_mask) {
+        src = next_tile_img(tileset, img_shift) + ((x & tile_mask) << pixshift);
+        do {
+            copy_px(&dst, &src, pixel_bytes, alpha);
+        } while (++x & tile_mask);
+    }
+    int count = (int)(x1 - x);
+    for (int t = 0; t < count >> log_tile; ++t) {
+        src = next_tile_img(tileset, img_shift);
+        for (uint i = 0; i <= tile_mask; ++i)
+            copy_px(&dst, &src, pixel_bytes, alpha);
+    }
+    src = next_tile_img(tileset, img_shift);
+    for (int i = 0; i < (count > 0 ? count & (int)tile_mask : 0); ++i)
+        copy_px(&dst, &src, pixel_bytes, alpha);
+}
+
+#define TILE_LOOP(name, pixel_t, log_tile, alpha) \
+void name(pixel_t *dst, const pixel_t *tileset, uint x0, uint x1) { \
+    tile_loop((uint8_t*)dst, (const uint8_t*)tileset, x0, x1, log_tile, sizeof(pixel_t), alpha); \
+}
+
+TILE_LOOP(tile16_16px_alpha_loop, uint16_t, 4, true)
+TILE_LOOP(tile16_16px_loop,       uint16_t, 4, false)
+TILE_LOOP(tile16_8px_alpha_loop,  uint16_t, 3, true)
+TILE_LOOP(tile16_8px_loop,        uint16_t, 3, false)
+TILE_LOOP(tile8_16px_alpha_loop,  uint8_t,  4, true)
+TILE_LOOP(tile8_16px_loop,        uint8_t,  4, false)
+TILE_LOOP(tile8_8px_alpha_loop,   uint8_t,  3, true)
+TILE_LOOP(tile8_8px_loop,         uint8_t,  3, false)
@@ -0,0 +1,218 @@
+// Substitutos em C dos laços de libdvi/tmds_encode.S para o build de host.
+// Cada função faz os mesmos acessos aos interpoladores que o assembly (mesma
+// ordem de escritas em ACCUM e leituras de PEEK), então o que se testa aqui
+// é a configuração feita por tmds_encode.c e as tabelas. Os laços em
+// assembly e o seu tempo de execução só podem ser conferidos no RP2040.
+
+#include "hardware/interp.h"
+#include "tmds_encode.h"
+
+static inline uint32_t lut_peek_lane(interp_hw_t *interp, uint lane) {
+    return *(const uint32_t*)interp_result_ptr(interp_peek_lane_result(interp, lane));
+}
+
+static inline uint32_t lut_peek_full(interp_hw_t *interp) {
+    return *(const uint32_t*)interp_result_ptr(interp_peek_full_result(interp));
+}
+
+// O assembly termina quando o ponteiro de saída chega exatamente ao fim, e
+// processa TMDS_ENCODE_UNROLL corpos por volta
+static inline void check_unroll(size_t n_words, size_t words_per_body) {
+    assert(n_words % (words_per_body * TMDS_ENCODE_UNROLL) == 0);
+    (void)n_words;
+    (void)words_per_body;
+}
+
+// ----------------------------------------------------------------------------
+// Codificadores com pixels duplicados
+
+static void encode_loop_16bpp(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix, uint leftshift) {
+    interp_hw_t *interp = interp0_hw;
+    check_unroll(n_pix, 4);
+    const uint32_t *end = symbuf + n_pix;
+    while (symbuf != end) {
+        for (int i = 0; i < 2; ++i) {
+            interp->accum[0] = *pixbuf++ << leftshift;
+            *symbuf++ = lut_peek_lane(interp, 0);
+            *symbuf++ = lut_peek_lane(interp, 1);
+        }
+    }
+}
+
+void tmds_encode_loop_16bpp(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix) {
+    encode_loop_16bpp(pixbuf, symbuf, n_pix, 0);
+}
+
+void tmds_encode_loop_16bpp_leftshift(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix, uint leftshift) {
+    encode_loop_16bpp(pixbuf, symbuf, n_pix, leftshift);
+}
+
+static void encode_loop_8bpp(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_words, uint leftshift) {
+    interp_hw_t *i0 = interp0_hw;
+    interp_hw_t *i1 = interp1_hw;
+    check_unroll(n_words, 4);
+    const uint32_t *end = symbuf + n_words;
+    while (symbuf != end) {
+        uint32_t pix = *pixbuf++;
+        // Só os pixels 0 e 1 (interp0) recebem o deslocamento
+        i1->accum[0] = pix;
+        i0->accum[0] = pix << leftshift;
+        *symbuf++ = lut_peek_lane(i0, 0);
+        *symbuf++ = lut_peek_lane(i0, 1);
+        *symbuf++ = lut_peek_lane(i1, 0);
+        *symbuf++ = lut_peek_lane(i1, 1);
+    }
+}
+
+void tmds_encode_loop_8bpp(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix) {
+    encode_loop_8bpp(pixbuf, symbuf, n_pix, 0);
+}
+
+// Como no assembly, o limite é n_pix * 8 bytes, o dobro da versão sem
+// deslocamento: o canal seguinte do buffer TMDS é escrito a mais e depois
+// sobrescrito pela sua própria codificação
+void tmds_encode_loop_8bpp_leftshift(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix, uint leftshift) {
+    encode_loop_8bpp(pixbuf, symbuf, 2 * n_pix, leftshift);
+}
+
+// ----------------------------------------------------------------------------
+// 1bpp e 2bpp em resolução total (tabelas copiadas de tmds_encode.S)
+
+static const uint32_t tmds_1bpp_table[32] = {
+#if !DVI_1BPP_BIT_REVERSE
+    0x7fd00, 0x7fd00, 0x7fe00, 0x7fd00, 0xbfd00, 0x7fd00, 0xbfe00, 0x7fd00,
+    0x7fd00, 0x7fe00, 0x7fe00, 0x7fe00, 0xbfd00, 0x7fe00, 0xbfe00, 0x7fe00,
+    0x7fd00, 0xbfd00, 0x7fe00, 0xbfd00, 0xbfd00, 0xbfd00, 0xbfe00, 0xbfd00,
+    0x7fd00, 0xbfe00, 0x7fe00, 0xbfe00, 0xbfd00, 0xbfe00, 0xbfe00, 0xbfe00,
+#else
+    0x7fd00, 0x7fd00, 0x7fd00, 0xbfd00, 0x7fd00, 0x7fe00, 0x7fd00, 0xbfe00,
+    0xbfd00, 0x7fd00, 0xbfd00, 0xbfd00, 0xbfd00, 0x7fe00, 0xbfd00, 0xbfe00,
+    0x7fe00, 0x7fd00, 0x7fe00, 0xbfd00, 0x7fe00, 0x7fe00, 0x7fe00, 0xbfe00,
+    0xbfe00, 0x7fd00, 0xbfe00, 0xbfd00, 0xbfe00, 0x7fe00, 0xbfe00, 0xbfe00,
+#endif
+};
+
+void tmds_encode_1bpp(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix) {
+    // Ordem dos nibbles de cada palavra de entrada, como nos pares de
+    // deslocamentos de tmds_encode_1bpp_body
+#if !DVI_1BPP_BIT_REVERSE
+    static const uint8_t nibble_order[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+#else
+    static const uint8_t nibble_order[8] = {1, 0, 3, 2, 5, 4, 7, 6};
+#endif
+    const uint32_t *end = symbuf + n_pix / 2;
+    while (symbuf < end) {
+        uint32_t pix = *pixbuf++;
+        for (int i = 0; i < 8; ++i) {
+            const uint32_t *entry = &tmds_1bpp_table[2 * (pix >> 4 * nibble_order[i] & 0xfu)];
+            *symbuf++ = entry[0];
+            *symbuf++ = entry[1];
+        }
+    }
+}
+
+static const uint32_t tmds_2bpp_table[16] = {
+    0x7f103, 0x7f130, 0x7f230, 0x7f203,
+    0x73d03, 0x73d30, 0x73e30, 0x73e03,
+    0xb3d03, 0xb3d30, 0xb3e30, 0xb3e03,
+    0xbf103, 0xbf130, 0xbf230, 0xbf203,
+};
+
+void tmds_encode_2bpp(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix) {
+    const uint32_t *end = symbuf + n_pix / 2;
+    while (symbuf < end) {
+        uint32_t pix = *pixbuf++;
+        for (int i = 0; i < 8; ++i)
+            *symbuf++ = tmds_2bpp_table[pix >> 4 * i & 0xfu];
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Resolução total com disparidade corrente em ACCUM1
+
+static void fullres_encode_loop_16bpp(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix, uint leftshift) {
+    interp_hw_t *i0 = interp0_hw;
+    interp_hw_t *i1 = interp1_hw;
+    const uint32_t *end = symbuf + n_pix;
+    i0->accum[1] = 0;
+#if TMDS_FULLRES_NO_DC_BALANCE
+    i1->accum[1] = ~0u;
+#else
+    i1->accum[1] = 0;
+#endif
+    while (symbuf != end) {
+        uint32_t pix = *pixbuf++;
+        i1->accum[0] = pix;
+        i0->accum[0] = pix << leftshift;
+        uint32_t sym0 = lut_peek_full(i0);
+#if !TMDS_FULLRES_NO_DC_BALANCE
+        interp_add_accumulater(i0, 1, sym0);
+#endif
+        uint32_t sym1 = lut_peek_full(i1);
+#if !TMDS_FULLRES_NO_DC_BALANCE
+        interp_add_accumulater(i1, 1, sym1);
+#endif
+        *symbuf++ = sym0;
+        *symbuf++ = sym1;
+    }
+}
+
+void tmds_fullres_encode_loop_16bpp_x(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix) {
+    fullres_encode_loop_16bpp(pixbuf, symbuf, n_pix, 0);
+}
+
+void tmds_fullres_encode_loop_16bpp_y(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix) {
+    fullres_encode_loop_16bpp(pixbuf, symbuf, n_pix, 0);
+}
+
+void tmds_fullres_encode_loop_16bpp_leftshift_x(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix, uint leftshift) {
+    fullres_encode_loop_16bpp(pixbuf, symbuf, n_pix, leftshift);
+}
+
+void tmds_fullres_encode_loop_16bpp_leftshift_y(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix, uint leftshift) {
+    fullres_encode_loop_16bpp(pixbuf, symbuf, n_pix, leftshift);
+}
+
+// ----------------------------------------------------------------------------
+// 8bpp com paleta, dois símbolos por palavra de saída
+
+static inline uint32_t palette_encode_body(interp_hw_t *i0, interp_hw_t *i1, uint32_t pix) {
+    i0->accum[0] = pix;
+    i1->accum[0] = pix;
+    uint32_t sym0 = lut_peek_full(i0);
+#if !TMDS_FULLRES_NO_DC_BALANCE
+    interp_add_accumulater(i0, 1, sym0);
+#endif
+    uint32_t sym1 = lut_peek_full(i1);
+#if !TMDS_FULLRES_NO_DC_BALANCE
+    interp_add_accumulater(i1, 1, sym1);
+#endif
+    return sym0 | sym1 << 10;
+}
+
+static void palette_encode_loop(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix) {
+    interp_hw_t *i0 = interp0_hw;
+    interp_hw_t *i1 = interp1_hw;
+    const uint32_t *end = symbuf + n_pix / 2;
+    i0->accum[1] = 0;
+#if TMDS_FULLRES_NO_DC_BALANCE
+    i1->accum[1] = ~0u;
+#else
+    i1->accum[1] = 0;
+#endif
+    while (symbuf != end) {
+        for (int i = 0; i < 2; ++i) {
+            uint32_t pix = *pixbuf++;
+            *symbuf++ = palette_encode_body(i0, i1, pix << 2);
+            *symbuf++ = palette_encode_body(i0, i1, pix >> 14);
+        }
+    }
+}
+
+void tmds_palette_encode_loop_x(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix) {
+    palette_encode_loop(pixbuf, symbuf, n_pix);
+}
+
+void tmds_palette_encode_loop_y(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix) {
+    palette_encode_loop(pixbuf, symbuf, n_pix);
+}
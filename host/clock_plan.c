@@ -0,0 +1,116 @@
+// Plano de clock de cada temporização de libdvi (dvi_clock_plan()): PLL a
+// partir do cristal de 12 MHz, taxa de quadros exata, tensão do núcleo e o
+// orçamento de ciclos por linha, com quanto dele cada codificador TMDS gasta.
+// No fim, para cada codificador, o modo mais rápido que não é arriscado e
+// cuja codificação cabe em um e em dois núcleos.
+//
+// Uso:
+//   clock_plan            todas as temporizações
+//   clock_plan 1600x900   só as que contêm o texto no nome
+//
+// Os custos são ciclos por pixel de saída e por canal, contados nos laços de
+// tmds_encode.S e tmds_encode_font_2bpp.S (sem o IRQ de DMA e o resto do
+// trabalho por linha, então a folga real é menor).
+
+#include <stdio.h>
+#include <string.h>
+
+#include "dvi_clock.h"
+
+static const struct {
+    const char *name;
+    const struct dvi_timing *t;
+} timings[] = {
+    { "640x480p_60hz",           &dvi_timing_640x480p_60hz },
+    { "800x480p_60hz",           &dvi_timing_800x480p_60hz },
+    { "800x600p_60hz",           &dvi_timing_800x600p_60hz },
+    { "800x600p_reduced_60hz",   &dvi_timing_800x600p_reduced_60hz },
+    { "960x540p_60hz",           &dvi_timing_960x540p_60hz },
+    { "1280x720p_30hz",          &dvi_timing_1280x720p_30hz },
+    { "1280x720p_reduced_30hz",  &dvi_timing_1280x720p_reduced_30hz },
+    { "1600x900p_reduced_30hz",  &dvi_timing_1600x900p_reduced_30hz },
+};
+#define N_TIMINGS (sizeof(timings) / sizeof(timings[0]))
+
+static const struct {
+    const char *name;
+    double cyc_per_pix;     // por canal e por pixel de saída
+    unsigned channels;      // quantas vezes a linha é codificada
+} encoders[] = {
+    // 22 ciclos (24 com deslocamento) por 8 pixels de saída
+    { "16bpp x2",      3.0,   3 },
+    // 20 ciclos (22 com deslocamento) por 8 pixels de saída
+    { "8bpp x2",       2.75,  3 },
+    // ~2000 ciclos por linha de 640 px
+    { "fonte 2bpp",    3.125, 3 },
+    // ~1450 ciclos por linha de 640 px
+    { "fonte 2bpp x2", 2.27,  3 },
+    { "16bpp cheio",   7.0,   3 },
+    // 60 ciclos por 8 pixels, com o balanço DC
+    { "paleta 8bpp",   7.5,   3 },
+    // Monocromático: os três canais recebem os mesmos símbolos
+    { "1bpp",          2.125, 1 },
+};
+#define N_ENCODERS (sizeof(encoders) / sizeof(encoders[0]))
+
+static double encode_cycles(unsigned e, const struct dvi_timing *t) {
+    return encoders[e].cyc_per_pix * encoders[e].channels * t->h_active_pixels;
+}
+
+int main(int argc, char **argv) {
+    const char *filter = argc > 1 ? argv[1] : "";
+    dvi_clock_plan_t plans[N_TIMINGS];
+    bool ok[N_TIMINGS];
+    int status = 0;
+
+    for (unsigned i = 0; i < N_TIMINGS; ++i) {
+        const struct dvi_timing *t = timings[i].t;
+        ok[i] = dvi_clock_plan(t, &plans[i]);
+        if (!strstr(timings[i].name, filter))
+            continue;
+        const dvi_clock_plan_t *p = &plans[i];
+        printf("%s: %ux%u, total %ux%u, bit clock %u kHz\n", timings[i].name,
+            t->h_active_pixels, t->v_active_lines, dvi_timing_h_total(t), dvi_timing_v_total(t),
+            t->bit_clk_khz);
+        if (!ok[i]) {
+            printf("  sem PLL a menos de 1%% do bit clock\n\n");
+            status = 1;
+            continue;
+        }
+        printf("  PLL: 12 MHz x %u = VCO %lu kHz, / %u / %u = %lu kHz (%+ld ppm)\n",
+            p->fbdiv, (unsigned long)p->vco_khz, p->postdiv1, p->postdiv2,
+            (unsigned long)p->sys_khz, (long)p->error_ppm);
+        printf("  quadro: %lu.%03lu Hz, tensão %u mV%s\n",
+            (unsigned long)(p->refresh_mhz / 1000), (unsigned long)(p->refresh_mhz % 1000),
+            p->vreg_mv, p->risky ? " (ARRISCADO: acima do que 1,30 V costuma aguentar)" : "");
+        printf("  orçamento: %lu ciclos por linha por núcleo\n", (unsigned long)p->line_cycles);
+        for (unsigned e = 0; e < N_ENCODERS; ++e) {
+            double cyc = encode_cycles(e, t);
+            printf("    %-14s %7.0f ciclos/linha  %5.1f%% de um núcleo\n",
+                encoders[e].name, cyc, 100.0 * cyc / p->line_cycles);
+        }
+        printf("\n");
+    }
+
+    // Mais rápido = mais pixels ativos por segundo
+    printf("Modo mais rápido não arriscado em que a codificação cabe:\n");
+    for (unsigned e = 0; e < N_ENCODERS; ++e) {
+        int best[2] = {-1, -1};
+        for (unsigned cores = 1; cores <= 2; ++cores) {
+            double best_rate = 0;
+            for (unsigned i = 0; i < N_TIMINGS; ++i) {
+                const struct dvi_timing *t = timings[i].t;
+                if (!ok[i] || plans[i].risky || encode_cycles(e, t) > (double)cores * plans[i].line_cycles)
+                    continue;
+                double rate = (double)t->h_active_pixels * t->v_active_lines * plans[i].refresh_mhz;
+                if (rate > best_rate) {
+                    best_rate = rate;
+                    best[cores - 1] = (int)i;
+                }
+            }
+        }
+        printf("  %-14s  1 núcleo: %-24s  2 núcleos: %s\n", encoders[e].name,
+            best[0] >= 0 ? timings[best[0]].name : "-", best[1] >= 0 ? timings[best[1]].name : "-");
+    }
+    return status;
+}
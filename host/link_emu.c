@@ -0,0 +1,406 @@
+// Emulador do enlace teclado -> receptor no host, por um par de
+// pseudo-terminais.
+//
+// Uma thread faz o papel do emissor (teclado.c): um gerador de carga produz
+// eventos de pressionar/soltar a uma taxa fixa, o kp_sender_t os junta em
+// quadros e eles são escritos no lado mestre do pty, opcionalmente no ritmo
+// de uma UART (--baud) e com bits trocados (--corrupt). Outra thread faz o
+// papel do receptor (hdmi.c): lê o lado escravo, decodifica os quadros e os
+// entrega à IHM (ui.c), que escreve em charbuf/colourbuf.
+//
+// O relógio da IHM é o instante de cada quadro (relógio do emissor,
+// acelerado por --time-scale para que erro e bloqueio passem depressa), então
+// o resultado não depende do escalonamento das threads. No fim a tela e o
+// estado da IHM são comparados com uma referência: a mesma IHM alimentada
+// direto, sem enlace, só com os quadros que o emissor enviou intactos. Os
+// contadores do enlace também têm de bater com as falhas injetadas.
+//
+// Uso:
+//   link_emu [--rate 5000] [--seconds 5] [--baud 0] [--corrupt 0]
+//            [--time-scale 100] [--seed 1] [--dump]
+//
+// Retorna 0 se tela, estado e contadores baterem.
+
+#define _GNU_SOURCE
+#include <getopt.h>
+#include <poll.h>
+#include <pthread.h>
+#include <pty.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "keypad_proto.h"
+#include "text_screen.h"
+#include "ui.h"
+
+static struct {
+    double rate;            // eventos por segundo (pressionar e soltar contam)
+    double seconds;
+    unsigned baud;          // 0: sem limite além do pty
+    double corrupt;         // probabilidade de corromper cada quadro
+    unsigned time_scale;    // relógio do emissor / relógio real
+    unsigned seed;
+    bool dump;
+} cfg = {
+    .rate = 5000,
+    .seconds = 5,
+    .baud = 0,
+    .corrupt = 0,
+    .time_scale = 100,
+    .seed = 1,
+    .dump = false,
+};
+
+// Quadros na ordem de envio, para a referência e para conferir o enlace
+typedef struct {
+    uint8_t bytes[KP_FRAME_MAX_BYTES];
+    uint8_t len;
+    uint8_t n_events;
+    bool corrupted;
+} sent_frame_t;
+
+static sent_frame_t *sent;
+static size_t n_sent, sent_cap;
+static uint64_t sent_events;
+
+static int pty_master, pty_slave;
+static atomic_ullong bytes_written, bytes_read;
+static atomic_bool emitter_done;
+
+static uint64_t mono_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static void sleep_us(uint64_t us) {
+    struct timespec ts = { .tv_sec = (time_t)(us / 1000000u), .tv_nsec = (long)(us % 1000000u) * 1000 };
+    nanosleep(&ts, NULL);
+}
+
+static void write_all(int fd, const uint8_t *buf, size_t len) {
+    while (len) {
+        ssize_t n = write(fd, buf, len);
+        if (n < 0) {
+            perror("write");
+            exit(2);
+        }
+        buf += n;
+        len -= (size_t)n;
+        bytes_written += (uint64_t)n;
+    }
+}
+
+// Estende o relógio de 32 bits do emissor (com --time-scale 100 ele dá a
+// volta em ~43 s reais)
+typedef struct {
+    uint32_t last;
+    uint64_t now_us;
+} clock_unwrap_t;
+
+static uint64_t clock_unwrap(clock_unwrap_t *c, uint32_t t) {
+    c->now_us += (uint32_t)(t - c->last);
+    c->last = t;
+    return c->now_us;
+}
+
+// ----------------------------------------------------------------------------
+// Emissor
+
+static const char keys[] = "0123456789ABCD*#";
+
+static void send_frame(kp_sender_t *sender, uint32_t time_us) {
+    if (n_sent == sent_cap) {
+        sent_cap = sent_cap ? sent_cap * 2 : 1024;
+        sent = realloc(sent, sent_cap * sizeof(*sent));
+        if (!sent) {
+            perror("realloc");
+            exit(2);
+        }
+    }
+    sent_frame_t *f = &sent[n_sent++];
+    f->n_events = (uint8_t)sender->n_pending;
+    f->len = (uint8_t)kp_sender_build(sender, f->bytes, time_us);
+    f->corrupted = (double)rand() / RAND_MAX < cfg.corrupt;
+    uint8_t bytes[KP_FRAME_MAX_BYTES];
+    memcpy(bytes, f->bytes, f->len);
+    if (f->corrupted)
+        bytes[rand() % f->len] ^= (uint8_t)(1u << rand() % 8);
+    write_all(pty_master, bytes, f->len);
+}
+
+static void *emitter_main(void *arg) {
+    (void)arg;
+    kp_sender_t sender;
+    kp_sender_init(&sender);
+    const uint64_t n_total = (uint64_t)(cfg.rate * cfg.seconds) & ~1ull;
+    const double period_us = 1e6 / cfg.rate;
+    uint64_t start = mono_us();
+    uint64_t line_free_us = 0;
+    uint64_t k = 0;
+    char held = 0;
+    while (k < n_total || sender.n_pending) {
+        uint64_t now = mono_us() - start;
+        // Eventos vencidos; pressionar e soltar se alternam
+        while (k < n_total && (double)k * period_us <= (double)now) {
+            uint32_t t = (uint32_t)((uint64_t)((double)k * period_us) * cfg.time_scale);
+            bool press = !(k & 1);
+            if (press)
+                held = keys[rand() % (sizeof(keys) - 1)];
+            if (!kp_sender_queue(&sender, (uint8_t)held, press ? KP_EVENT_PRESSED : 0, t))
+                break;      // quadro cheio: espera a "UART" liberar
+            ++sent_events;
+            ++k;
+        }
+        if (sender.n_pending && now >= line_free_us) {
+            send_frame(&sender, (uint32_t)(now * cfg.time_scale));
+            if (cfg.baud)
+                line_free_us = now + (uint64_t)sent[n_sent - 1].len * 10 * 1000000u / cfg.baud;
+            continue;
+        }
+        // Dorme até o próximo evento ou até a linha ficar livre
+        uint64_t next = k < n_total ? (uint64_t)((double)k * period_us) : now;
+        if (sender.n_pending && line_free_us > now)
+            next = next > now && next < line_free_us ? next : line_free_us;
+        if (next > now + 50)
+            sleep_us(next - now);
+    }
+    emitter_done = true;
+    return NULL;
+}
+
+// ----------------------------------------------------------------------------
+// Receptor
+
+static kp_decoder_t rx_decoder;
+static kp_link_t rx_link;
+static ui_t rx_ui;
+
+static void rx_deliver(clock_unwrap_t *clock, const kp_frame_t *frame) {
+    uint64_t now_us = clock_unwrap(clock, frame->time_us);
+    ui_tick(&rx_ui, now_us);
+    ui_on_frame(&rx_ui, &rx_link, frame, now_us);
+}
+
+static void *receiver_main(void *arg) {
+    (void)arg;
+    clock_unwrap_t clock = {0};
+    uint8_t buf[512];
+    while (true) {
+        struct pollfd pfd = { .fd = pty_slave, .events = POLLIN };
+        if (poll(&pfd, 1, 20) > 0) {
+            ssize_t n = read(pty_slave, buf, sizeof(buf));
+            if (n <= 0)
+                break;
+            for (ssize_t i = 0; i < n; ++i) {
+                kp_frame_t frame;
+                if (kp_decoder_feed(&rx_decoder, buf[i], &frame))
+                    rx_deliver(&clock, &frame);
+            }
+            bytes_read += (uint64_t)n;
+            continue;
+        }
+        // Linha parada, como o laço do hdmi.c: um quadro corrompido com n
+        // inflado pode estar esperando bytes que não vêm
+        while (rx_decoder.len) {
+            kp_frame_t frame;
+            if (kp_decoder_idle(&rx_decoder, &frame))
+                rx_deliver(&clock, &frame);
+        }
+        if (emitter_done && bytes_read == bytes_written)
+            break;
+    }
+    return NULL;
+}
+
+// ----------------------------------------------------------------------------
+// Referência e comparação
+
+typedef struct {
+    char chars[TEXT_MAX_ROWS * CHAR_COLS];
+    uint32_t colours[3 * COLOUR_PLANE_SIZE_WORDS];
+    uint8_t attr[TEXT_MAX_ROWS];
+} screen_snapshot_t;
+
+static void snapshot(screen_snapshot_t *s) {
+    memcpy(s->chars, charbuf, sizeof(s->chars));
+    memcpy(s->colours, colourbuf, sizeof(s->colours));
+    for (unsigned y = 0; y < TEXT_MAX_ROWS; ++y)
+        s->attr[y] = text_row_attr[y];
+}
+
+static void replay_reference(ui_t *ui, kp_link_t *link) {
+    ui_setup_layout();
+    *ui = (ui_t){ .reset_cause = "host" };
+    ui_start(ui, 0);
+    kp_link_init(link);
+    kp_decoder_t decoder;
+    kp_decoder_init(&decoder);
+    clock_unwrap_t clock = {0};
+    for (size_t i = 0; i < n_sent; ++i) {
+        if (sent[i].corrupted)
+            continue;
+        kp_frame_t frame;
+        for (unsigned b = 0; b < sent[i].len; ++b) {
+            if (!kp_decoder_feed(&decoder, sent[i].bytes[b], &frame))
+                continue;
+            uint64_t now_us = clock_unwrap(&clock, frame.time_us);
+            ui_tick(ui, now_us);
+            ui_on_frame(ui, link, &frame, now_us);
+        }
+    }
+}
+
+// Renderização em texto de charbuf/colourbuf: uma linha por linha de texto
+// visível, com escala, largura dupla e as cores da primeira célula útil
+static void dump_screen(FILE *f, const char *title) {
+    fprintf(f, "--- %s ---\n", title);
+    unsigned py = 0;
+    for (unsigned y = 0; y < TEXT_MAX_ROWS && py < TEXT_SCREEN_HEIGHT; ++y) {
+        unsigned attr = text_row_attr[y];
+        py += FONT_ORIGINAL_HEIGHT * row_attr_scale(attr);
+        uint8_t fg, bg;
+        get_colour(1, y, &fg, &bg);
+        fprintf(f, "%2u %ux%c %02x/%02x |", y, row_attr_scale(attr),
+            attr & TEXT_ROW_HDOUBLE ? 'D' : ' ', fg, bg);
+        for (unsigned x = 0; x < row_cols(y); ++x) {
+            uint8_t c = (uint8_t)charbuf[y * CHAR_COLS + x];
+            // Os glifos são indexados por Latin-1
+            if (c >= 0xa0)
+                fprintf(f, "%c%c", 0xc0 | c >> 6, 0x80 | (c & 0x3f));
+            else
+                fputc(c >= 0x20 && c < 0x7f ? c : '.', f);
+        }
+        fprintf(f, "|\n");
+    }
+}
+
+static const char *state_name(ui_state_t s) {
+    static const char *const names[] = { "PROMPT", "ENTRY", "SUCCESS", "ERROR", "LOCKOUT" };
+    return s <= UI_STATE_LOCKOUT ? names[s] : "?";
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "uso: %s [--rate eventos/s] [--seconds s] [--baud b] [--corrupt p]\n"
+        "          [--time-scale k] [--seed n] [--dump]\n", prog);
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    static const struct option opts[] = {
+        { "rate", required_argument, NULL, 'r' },
+        { "seconds", required_argument, NULL, 's' },
+        { "baud", required_argument, NULL, 'b' },
+        { "corrupt", required_argument, NULL, 'c' },
+        { "time-scale", required_argument, NULL, 't' },
+        { "seed", required_argument, NULL, 'S' },
+        { "dump", no_argument, NULL, 'd' },
+        { NULL, 0, NULL, 0 },
+    };
+    int opt;
+    while ((opt = getopt_long(argc, argv, "", opts, NULL)) != -1) {
+        switch (opt) {
+            case 'r': cfg.rate = atof(optarg); break;
+            case 's': cfg.seconds = atof(optarg); break;
+            case 'b': cfg.baud = (unsigned)atoi(optarg); break;
+            case 'c': cfg.corrupt = atof(optarg); break;
+            case 't': cfg.time_scale = (unsigned)atoi(optarg); break;
+            case 'S': cfg.seed = (unsigned)atoi(optarg); break;
+            case 'd': cfg.dump = true; break;
+            default: usage(argv[0]);
+        }
+    }
+    if (cfg.rate <= 0 || cfg.seconds <= 0 || cfg.time_scale == 0)
+        usage(argv[0]);
+    srand(cfg.seed);
+
+    if (openpty(&pty_master, &pty_slave, NULL, NULL, NULL) < 0) {
+        perror("openpty");
+        return 2;
+    }
+    struct termios tio;
+    tcgetattr(pty_slave, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(pty_slave, TCSANOW, &tio);
+
+    ui_setup_layout();
+    rx_ui = (ui_t){ .reset_cause = "host" };
+    ui_start(&rx_ui, 0);
+    kp_decoder_init(&rx_decoder);
+    kp_link_init(&rx_link);
+
+    uint64_t t0 = mono_us();
+    pthread_t emitter, receiver;
+    pthread_create(&receiver, NULL, receiver_main, NULL);
+    pthread_create(&emitter, NULL, emitter_main, NULL);
+    pthread_join(emitter, NULL);
+    pthread_join(receiver, NULL);
+    double elapsed = (double)(mono_us() - t0) / 1e6;
+
+    // Eventos dos quadros corrompidos; os anteriores ao primeiro quadro
+    // intacto não aparecem como perdidos (o receptor ainda não sincronizou)
+    uint64_t expected_lost = 0, corrupted_frames = 0;
+    bool synced = false;
+    for (size_t i = 0; i < n_sent; ++i) {
+        if (sent[i].corrupted) {
+            ++corrupted_frames;
+            if (synced)
+                expected_lost += sent[i].n_events;
+        }
+        else {
+            synced = true;
+        }
+    }
+    // Corrompidos no fim, sem quadro intacto depois, também não aparecem
+    for (size_t i = n_sent; i-- > 0 && sent[i].corrupted; )
+        expected_lost -= synced ? sent[i].n_events : 0;
+
+    screen_snapshot_t rx_screen, ref_screen;
+    snapshot(&rx_screen);
+    if (cfg.dump)
+        dump_screen(stdout, "receptor");
+    ui_t ref_ui;
+    kp_link_t ref_link;
+    replay_reference(&ref_ui, &ref_link);
+    snapshot(&ref_screen);
+
+    printf("link_emu: %llu eventos em %.2f s (%.0f/s), %zu quadros (%.1f eventos/quadro), %llu bytes\n",
+        (unsigned long long)sent_events, elapsed, (double)sent_events / elapsed, n_sent,
+        n_sent ? (double)sent_events / (double)n_sent : 0.0, (unsigned long long)bytes_written);
+    printf("  emissor: %llu quadros corrompidos\n", (unsigned long long)corrupted_frames);
+    printf("  receptor: %lu quadros, %lu eventos, %lu perdidos (esperados %llu), %lu duplicados, %lu reinícios\n",
+        (unsigned long)rx_link.frames, (unsigned long)rx_link.events,
+        (unsigned long)rx_link.lost_events, (unsigned long long)expected_lost,
+        (unsigned long)rx_link.dup_events, (unsigned long)rx_link.restarts);
+    printf("  erros de CRC %lu, tamanhos inválidos %lu, bytes descartados %lu, quadros expirados %lu\n",
+        (unsigned long)rx_decoder.crc_errors, (unsigned long)rx_decoder.bad_lengths,
+        (unsigned long)rx_decoder.skipped_bytes, (unsigned long)rx_decoder.timeouts);
+    printf("  IHM: %s, %d tentativas (referência: %s, %d)\n",
+        state_name(rx_ui.state), rx_ui.attempts, state_name(ref_ui.state), ref_ui.attempts);
+
+    bool ok = true;
+    if (memcmp(&rx_screen, &ref_screen, sizeof(rx_screen)) != 0) {
+        printf("ERRO: tela do receptor diferente da referência\n");
+        if (cfg.dump)
+            dump_screen(stdout, "referência");
+        ok = false;
+    }
+    if (rx_ui.state != ref_ui.state || rx_ui.attempts != ref_ui.attempts ||
+        rx_ui.input_index != ref_ui.input_index) {
+        printf("ERRO: estado da IHM diferente da referência\n");
+        ok = false;
+    }
+    if (rx_link.lost_events != expected_lost || rx_link.dup_events || rx_link.restarts ||
+        rx_link.events != ref_link.events) {
+        printf("ERRO: contadores do enlace não batem com as falhas injetadas\n");
+        ok = false;
+    }
+    printf("%s\n", ok ? "OK" : "FALHOU");
+    free(sent);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,108 @@
+#ifndef _HARDWARE_DMA_H
+#define _HARDWARE_DMA_H
+
+#include "pico.h"
+
+// Configuração de canal com os mesmos campos de CTRL_TRIG do RP2040, para
+// que as listas de blocos de controle de dvi_timing.c possam ser conferidas.
+// Os endereços são ponteiros nativos (64 bits no host), então o bloco de
+// controle não tem o tamanho do hardware, só a mesma ordem de campos.
+
+#define DMA_CH0_CTRL_TRIG_EN_BITS            0x00000001u
+#define DMA_CH0_CTRL_TRIG_HIGH_PRIORITY_BITS 0x00000002u
+#define DMA_CH0_CTRL_TRIG_DATA_SIZE_LSB      2
+#define DMA_CH0_CTRL_TRIG_DATA_SIZE_BITS     0x0000000cu
+#define DMA_CH0_CTRL_TRIG_INCR_READ_BITS     0x00000010u
+#define DMA_CH0_CTRL_TRIG_INCR_WRITE_BITS    0x00000020u
+#define DMA_CH0_CTRL_TRIG_RING_SIZE_LSB      6
+#define DMA_CH0_CTRL_TRIG_RING_SIZE_BITS     0x000003c0u
+#define DMA_CH0_CTRL_TRIG_RING_SEL_BITS      0x00000400u
+#define DMA_CH0_CTRL_TRIG_CHAIN_TO_LSB       11
+#define DMA_CH0_CTRL_TRIG_CHAIN_TO_BITS      0x00007800u
+#define DMA_CH0_CTRL_TRIG_TREQ_SEL_LSB       15
+#define DMA_CH0_CTRL_TRIG_TREQ_SEL_BITS      0x001f8000u
+#define DMA_CH0_CTRL_TRIG_IRQ_QUIET_BITS     0x00200000u
+#define DMA_CH0_CTRL_TRIG_BSWAP_BITS         0x00400000u
+#define DMA_CH0_CTRL_TRIG_SNIFF_EN_BITS      0x00800000u
+
+#define DREQ_FORCE 0x3fu
+
+enum dma_channel_transfer_size {
+    DMA_SIZE_8 = 0,
+    DMA_SIZE_16 = 1,
+    DMA_SIZE_32 = 2
+};
+
+typedef struct {
+    const volatile void *read_addr;
+    volatile void *write_addr;
+    volatile uint32_t transfer_count;
+    volatile uint32_t ctrl_trig;
+} dma_channel_hw_t;
+
+typedef struct {
+    uint32_t ctrl;
+} dma_channel_config;
+
+static inline void channel_config_set_read_increment(dma_channel_config *c, bool incr) {
+    c->ctrl = incr ? c->ctrl | DMA_CH0_CTRL_TRIG_INCR_READ_BITS : c->ctrl & ~DMA_CH0_CTRL_TRIG_INCR_READ_BITS;
+}
+
+static inline void channel_config_set_write_increment(dma_channel_config *c, bool incr) {
+    c->ctrl = incr ? c->ctrl | DMA_CH0_CTRL_TRIG_INCR_WRITE_BITS : c->ctrl & ~DMA_CH0_CTRL_TRIG_INCR_WRITE_BITS;
+}
+
+static inline void channel_config_set_dreq(dma_channel_config *c, uint dreq) {
+    assert(dreq <= DREQ_FORCE);
+    c->ctrl = (c->ctrl & ~DMA_CH0_CTRL_TRIG_TREQ_SEL_BITS) | (dreq << DMA_CH0_CTRL_TRIG_TREQ_SEL_LSB);
+}
+
+static inline void channel_config_set_chain_to(dma_channel_config *c, uint chain_to) {
+    assert(chain_to < NUM_DMA_CHANNELS);
+    c->ctrl = (c->ctrl & ~DMA_CH0_CTRL_TRIG_CHAIN_TO_BITS) | (chain_to << DMA_CH0_CTRL_TRIG_CHAIN_TO_LSB);
+}
+
+static inline void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size) {
+    c->ctrl = (c->ctrl & ~DMA_CH0_CTRL_TRIG_DATA_SIZE_BITS) | ((uint)size << DMA_CH0_CTRL_TRIG_DATA_SIZE_LSB);
+}
+
+static inline void channel_config_set_ring(dma_channel_config *c, bool write, uint size_bits) {
+    assert(size_bits < 32);
+    c->ctrl = (c->ctrl & ~(DMA_CH0_CTRL_TRIG_RING_SIZE_BITS | DMA_CH0_CTRL_TRIG_RING_SEL_BITS)) |
+        (size_bits << DMA_CH0_CTRL_TRIG_RING_SIZE_LSB) |
+        (write ? DMA_CH0_CTRL_TRIG_RING_SEL_BITS : 0);
+}
+
+static inline void channel_config_set_bswap(dma_channel_config *c, bool bswap) {
+    c->ctrl = bswap ? c->ctrl | DMA_CH0_CTRL_TRIG_BSWAP_BITS : c->ctrl & ~DMA_CH0_CTRL_TRIG_BSWAP_BITS;
+}
+
+static inline void channel_config_set_irq_quiet(dma_channel_config *c, bool irq_quiet) {
+    c->ctrl = irq_quiet ? c->ctrl | DMA_CH0_CTRL_TRIG_IRQ_QUIET_BITS : c->ctrl & ~DMA_CH0_CTRL_TRIG_IRQ_QUIET_BITS;
+}
+
+static inline void channel_config_set_high_priority(dma_channel_config *c, bool high_priority) {
+    c->ctrl = high_priority ? c->ctrl | DMA_CH0_CTRL_TRIG_HIGH_PRIORITY_BITS : c->ctrl & ~DMA_CH0_CTRL_TRIG_HIGH_PRIORITY_BITS;
+}
+
+static inline void channel_config_set_enable(dma_channel_config *c, bool enable) {
+    c->ctrl = enable ? c->ctrl | DMA_CH0_CTRL_TRIG_EN_BITS : c->ctrl & ~DMA_CH0_CTRL_TRIG_EN_BITS;
+}
+
+// Mesmos padrões do SDK
+static inline dma_channel_config dma_channel_get_default_config(uint channel) {
+    dma_channel_config c = {0};
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, DREQ_FORCE);
+    channel_config_set_chain_to(&c, channel);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_ring(&c, false, 0);
+    channel_config_set_bswap(&c, false);
+    channel_config_set_irq_quiet(&c, false);
+    channel_config_set_enable(&c, true);
+    channel_config_set_high_priority(&c, false);
+    return c;
+}
+
+#endif
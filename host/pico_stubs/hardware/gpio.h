@@ -0,0 +1,6 @@
+#ifndef _HARDWARE_GPIO_H
+#define _HARDWARE_GPIO_H
+
+#include "pico.h"
+
+#endif
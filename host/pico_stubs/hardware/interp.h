@@ -0,0 +1,147 @@
+#ifndef _HARDWARE_INTERP_H
+#define _HARDWARE_INTERP_H
+
+#include "pico.h"
+#include "hardware/regs/sio.h"
+
+// Modelo em software dos interpoladores do SIO, com a API do SDK.
+//
+// Os registradores de configuração (accum, base, ctrl) são memória comum,
+// escrita direto como no firmware. Os de resultado (PEEK/POP) e o ACCUMx_ADD
+// têm efeito colateral, então no host são funções: os substitutos em C dos
+// laços em assembly (host/asm_ports/) as chamam onde o assembly lê ou
+// escreve esses registradores. Shift, máscara, SIGNED, CROSS_INPUT,
+// CROSS_RESULT, ADD_RAW, FORCE_MSB e os bits OVERF seguem o datasheet; os
+// modos BLEND e CLAMP, que ninguém aqui usa, não estão modelados.
+//
+// Os resultados têm 32 bits como no hardware, e são usados como endereços
+// (tabelas de TMDS, texturas, mapas de tiles). O build de host/ é sem PIE
+// para que dados estáticos fiquem abaixo de 4 GiB; o que passar por um
+// interpolador como endereço precisa ser estático, não pilha nem heap.
+
+typedef struct {
+    uint32_t accum[2];
+    uint32_t base[3];
+    uint32_t ctrl[2];
+} interp_hw_t;
+
+// Um par de interpoladores por núcleo, como no RP2040
+extern interp_hw_t host_interp_hw[NUM_CORES][2];
+
+#define interp0_hw (&host_interp_hw[get_core_num()][0])
+#define interp1_hw (&host_interp_hw[get_core_num()][1])
+#define interp0 interp0_hw
+#define interp1 interp1_hw
+
+typedef struct {
+    uint32_t ctrl;
+} interp_config;
+
+typedef struct {
+    uint32_t accum[2];
+    uint32_t base[3];
+    uint32_t ctrl[2];
+} interp_hw_save_t;
+
+static inline void interp_config_set_shift(interp_config *c, uint shift) {
+    assert(shift < 32);
+    c->ctrl = (c->ctrl & ~SIO_INTERP0_CTRL_LANE0_SHIFT_BITS) | (shift << SIO_INTERP0_CTRL_LANE0_SHIFT_LSB);
+}
+
+static inline void interp_config_set_mask(interp_config *c, uint mask_lsb, uint mask_msb) {
+    assert(mask_msb < 32 && mask_lsb <= mask_msb);
+    c->ctrl = (c->ctrl & ~(SIO_INTERP0_CTRL_LANE0_MASK_LSB_BITS | SIO_INTERP0_CTRL_LANE0_MASK_MSB_BITS)) |
+        (mask_lsb << SIO_INTERP0_CTRL_LANE0_MASK_LSB_LSB) |
+        (mask_msb << SIO_INTERP0_CTRL_LANE0_MASK_MSB_LSB);
+}
+
+static inline void interp_config_set_cross_input(interp_config *c, bool cross_input) {
+    c->ctrl = (c->ctrl & ~SIO_INTERP0_CTRL_LANE0_CROSS_INPUT_BITS) | (cross_input ? SIO_INTERP0_CTRL_LANE0_CROSS_INPUT_BITS : 0);
+}
+
+static inline void interp_config_set_cross_result(interp_config *c, bool cross_result) {
+    c->ctrl = (c->ctrl & ~SIO_INTERP0_CTRL_LANE0_CROSS_RESULT_BITS) | (cross_result ? SIO_INTERP0_CTRL_LANE0_CROSS_RESULT_BITS : 0);
+}
+
+static inline void interp_config_set_signed(interp_config *c, bool _signed) {
+    c->ctrl = (c->ctrl & ~SIO_INTERP0_CTRL_LANE0_SIGNED_BITS) | (_signed ? SIO_INTERP0_CTRL_LANE0_SIGNED_BITS : 0);
+}
+
+static inline void interp_config_set_add_raw(interp_config *c, bool add_raw) {
+    c->ctrl = (c->ctrl & ~SIO_INTERP0_CTRL_LANE0_ADD_RAW_BITS) | (add_raw ? SIO_INTERP0_CTRL_LANE0_ADD_RAW_BITS : 0);
+}
+
+static inline void interp_config_set_force_bits(interp_config *c, uint bits) {
+    assert(bits <= 3);
+    c->ctrl = (c->ctrl & ~SIO_INTERP0_CTRL_LANE0_FORCE_MSB_BITS) | (bits << SIO_INTERP0_CTRL_LANE0_FORCE_MSB_LSB);
+}
+
+static inline interp_config interp_default_config(void) {
+    interp_config c = {0};
+    interp_config_set_mask(&c, 0, 31);
+    return c;
+}
+
+static inline void interp_set_config(interp_hw_t *interp, uint lane, interp_config *config) {
+    assert(lane < 2);
+    interp->ctrl[lane] = config->ctrl;
+}
+
+static inline void interp_save(interp_hw_t *interp, interp_hw_save_t *saver) {
+    saver->accum[0] = interp->accum[0];
+    saver->accum[1] = interp->accum[1];
+    saver->base[0] = interp->base[0];
+    saver->base[1] = interp->base[1];
+    saver->base[2] = interp->base[2];
+    saver->ctrl[0] = interp->ctrl[0];
+    saver->ctrl[1] = interp->ctrl[1];
+}
+
+static inline void interp_restore(interp_hw_t *interp, interp_hw_save_t *saver) {
+    interp->accum[0] = saver->accum[0];
+    interp->accum[1] = saver->accum[1];
+    interp->base[0] = saver->base[0];
+    interp->base[1] = saver->base[1];
+    interp->base[2] = saver->base[2];
+    interp->ctrl[0] = saver->ctrl[0];
+    interp->ctrl[1] = saver->ctrl[1];
+}
+
+static inline void interp_set_base(interp_hw_t *interp, uint lane, uint32_t val) {
+    interp->base[lane] = val;
+}
+
+static inline uint32_t interp_get_base(interp_hw_t *interp, uint lane) {
+    return interp->base[lane];
+}
+
+static inline void interp_set_accumulator(interp_hw_t *interp, uint lane, uint32_t val) {
+    interp->accum[lane] = val;
+}
+
+static inline uint32_t interp_get_accumulator(interp_hw_t *interp, uint lane) {
+    return interp->accum[lane];
+}
+
+// ACCUMx_ADD (o nome com a grafia do SDK)
+static inline void interp_add_accumulater(interp_hw_t *interp, uint lane, uint32_t val) {
+    interp->accum[lane] += val;
+}
+
+// PEEK_LANEx / POP_LANEx / PEEK_FULL / POP_FULL. Um POP de qualquer
+// resultado escreve os resultados das duas lanes de volta nos acumuladores.
+uint32_t interp_peek_lane_result(interp_hw_t *interp, uint lane);
+uint32_t interp_pop_lane_result(interp_hw_t *interp, uint lane);
+uint32_t interp_peek_full_result(interp_hw_t *interp);
+uint32_t interp_pop_full_result(interp_hw_t *interp);
+
+// Leitura de CTRL_LANEx: a configuração mais os bits OVERF0/OVERF1/OVERF
+// (só no CTRL_LANE0), calculados do estado atual dos acumuladores
+uint32_t interp_read_ctrl(interp_hw_t *interp, uint lane);
+
+// Converte um resultado de 32 bits no endereço que ele representa
+static inline const void *interp_result_ptr(uint32_t result) {
+    return (const void*)(uintptr_t)result;
+}
+
+#endif
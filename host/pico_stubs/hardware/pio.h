@@ -0,0 +1,10 @@
+#ifndef _HARDWARE_PIO_H
+#define _HARDWARE_PIO_H
+
+#include "pico.h"
+
+// Só o tipo, para struct dvi_serialiser_cfg; o serializador não roda no host
+typedef struct pio_hw pio_hw_t;
+typedef pio_hw_t *PIO;
+
+#endif
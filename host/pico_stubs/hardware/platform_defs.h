@@ -0,0 +1,8 @@
+#ifndef _HARDWARE_PLATFORM_DEFS_H
+#define _HARDWARE_PLATFORM_DEFS_H
+
+#define NUM_CORES 2u
+#define NUM_DMA_CHANNELS 12u
+#define NUM_PIOS 2u
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef _HARDWARE_REGS_SIO_H
+#define _HARDWARE_REGS_SIO_H
+
+// Campos dos registradores CTRL dos interpoladores (valores do RP2040).
+// LANE1 tem o mesmo layout de LANE0, sem BLEND; CLAMP só existe no INTERP1.
+
+#define SIO_INTERP0_CTRL_LANE0_SHIFT_LSB        0
+#define SIO_INTERP0_CTRL_LANE0_SHIFT_BITS       0x0000001fu
+#define SIO_INTERP0_CTRL_LANE0_MASK_LSB_LSB     5
+#define SIO_INTERP0_CTRL_LANE0_MASK_LSB_BITS    0x000003e0u
+#define SIO_INTERP0_CTRL_LANE0_MASK_MSB_LSB     10
+#define SIO_INTERP0_CTRL_LANE0_MASK_MSB_BITS    0x00007c00u
+#define SIO_INTERP0_CTRL_LANE0_SIGNED_BITS      0x00008000u
+#define SIO_INTERP0_CTRL_LANE0_CROSS_INPUT_BITS 0x00010000u
+#define SIO_INTERP0_CTRL_LANE0_CROSS_RESULT_BITS 0x00020000u
+#define SIO_INTERP0_CTRL_LANE0_ADD_RAW_BITS     0x00040000u
+#define SIO_INTERP0_CTRL_LANE0_FORCE_MSB_LSB    19
+#define SIO_INTERP0_CTRL_LANE0_FORCE_MSB_BITS   0x00180000u
+#define SIO_INTERP0_CTRL_LANE0_BLEND_BITS       0x00200000u
+#define SIO_INTERP1_CTRL_LANE0_CLAMP_BITS       0x00400000u
+#define SIO_INTERP0_CTRL_LANE0_OVERF0_BITS      0x00800000u
+#define SIO_INTERP0_CTRL_LANE0_OVERF1_BITS      0x01000000u
+#define SIO_INTERP0_CTRL_LANE0_OVERF_LSB        25
+#define SIO_INTERP0_CTRL_LANE0_OVERF_BITS       0x02000000u
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef _HARDWARE_SYNC_H
+#define _HARDWARE_SYNC_H
+
+#include "pico.h"
+
+// Um único fluxo de execução no host: spinlocks e eventos não fazem nada
+typedef volatile uint32_t spin_lock_t;
+
+static inline void __sev(void) {}
+static inline void __wfe(void) {}
+static inline void __dmb(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+
+static inline uint32_t save_and_disable_interrupts(void) { return 0; }
+static inline void restore_interrupts(uint32_t status) { (void)status; }
+
+static inline uint32_t spin_lock_blocking(spin_lock_t *lock) {
+    (void)lock;
+    return 0;
+}
+
+static inline void spin_unlock(spin_lock_t *lock, uint32_t saved_irq) {
+    (void)lock;
+    (void)saved_irq;
+}
+
+#endif
@@ -0,0 +1,81 @@
+#include "hardware/interp.h"
+
+interp_hw_t host_interp_hw[NUM_CORES][2];
+
+typedef struct {
+    uint32_t lane[2];   // Resultados PEEK_LANE0/1
+    uint32_t full;      // Resultado PEEK_FULL
+    bool overf[2];
+} interp_result_t;
+
+static uint32_t ctrl_field(uint32_t ctrl, uint32_t bits, unsigned lsb) {
+    return (ctrl & bits) >> lsb;
+}
+
+static interp_result_t interp_compute(const interp_hw_t *interp) {
+    interp_result_t r;
+    uint32_t masked[2];
+    for (unsigned i = 0; i < 2; ++i) {
+        uint32_t ctrl = interp->ctrl[i];
+        assert(!(ctrl & (SIO_INTERP0_CTRL_LANE0_BLEND_BITS | SIO_INTERP1_CTRL_LANE0_CLAMP_BITS)));
+        uint32_t input = interp->accum[ctrl & SIO_INTERP0_CTRL_LANE0_CROSS_INPUT_BITS ? 1 - i : i];
+        unsigned shift = ctrl_field(ctrl, SIO_INTERP0_CTRL_LANE0_SHIFT_BITS, SIO_INTERP0_CTRL_LANE0_SHIFT_LSB);
+        unsigned lsb = ctrl_field(ctrl, SIO_INTERP0_CTRL_LANE0_MASK_LSB_BITS, SIO_INTERP0_CTRL_LANE0_MASK_LSB_LSB);
+        unsigned msb = ctrl_field(ctrl, SIO_INTERP0_CTRL_LANE0_MASK_MSB_BITS, SIO_INTERP0_CTRL_LANE0_MASK_MSB_LSB);
+        uint32_t shifted = input >> shift;
+        uint32_t upper = msb == 31 ? 0xffffffffu : (2u << msb) - 1;
+        uint32_t mask = upper & ~((1u << lsb) - 1);
+        // Bits acima da máscara que se perdem: é o que os bits OVERF indicam
+        r.overf[i] = (shifted & ~upper) != 0;
+        masked[i] = shifted & mask;
+        if ((ctrl & SIO_INTERP0_CTRL_LANE0_SIGNED_BITS) && (masked[i] >> msb & 1u))
+            masked[i] |= ~upper;
+        r.lane[i] = interp->base[i] +
+            (ctrl & SIO_INTERP0_CTRL_LANE0_ADD_RAW_BITS ? input : masked[i]);
+        r.lane[i] |= ctrl_field(ctrl, SIO_INTERP0_CTRL_LANE0_FORCE_MSB_BITS, SIO_INTERP0_CTRL_LANE0_FORCE_MSB_LSB) << 28;
+    }
+    r.full = interp->base[2] + masked[0] + masked[1];
+    return r;
+}
+
+static void interp_writeback(interp_hw_t *interp, const interp_result_t *r) {
+    for (unsigned i = 0; i < 2; ++i)
+        interp->accum[i] = r->lane[interp->ctrl[i] & SIO_INTERP0_CTRL_LANE0_CROSS_RESULT_BITS ? 1 - i : i];
+}
+
+uint32_t interp_peek_lane_result(interp_hw_t *interp, uint lane) {
+    assert(lane < 2);
+    return interp_compute(interp).lane[lane];
+}
+
+uint32_t interp_pop_lane_result(interp_hw_t *interp, uint lane) {
+    assert(lane < 2);
+    interp_result_t r = interp_compute(interp);
+    interp_writeback(interp, &r);
+    return r.lane[lane];
+}
+
+uint32_t interp_peek_full_result(interp_hw_t *interp) {
+    return interp_compute(interp).full;
+}
+
+uint32_t interp_pop_full_result(interp_hw_t *interp) {
+    interp_result_t r = interp_compute(interp);
+    interp_writeback(interp, &r);
+    return r.full;
+}
+
+uint32_t interp_read_ctrl(interp_hw_t *interp, uint lane) {
+    assert(lane < 2);
+    uint32_t ctrl = interp->ctrl[lane];
+    if (lane)
+        return ctrl;
+    interp_result_t r = interp_compute(interp);
+    if (r.overf[0])
+        ctrl |= SIO_INTERP0_CTRL_LANE0_OVERF0_BITS;
+    if (r.overf[1])
+        ctrl |= SIO_INTERP0_CTRL_LANE0_OVERF1_BITS;
+    if (r.overf[0] || r.overf[1])
+        ctrl |= SIO_INTERP0_CTRL_LANE0_OVERF_BITS;
+    return ctrl;
+}
@@ -0,0 +1,11 @@
+#ifndef _PICO_H
+#define _PICO_H
+
+// Substituto mínimo do Pico SDK para o build de host/ (ver host/CMakeLists.txt).
+// Só existe o que libdvi, libsprite e os módulos portáveis da IHM usam.
+
+#include "pico/types.h"
+#include "pico/config.h"
+#include "pico/platform.h"
+
+#endif
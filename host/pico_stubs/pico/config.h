@@ -0,0 +1,7 @@
+#ifndef _PICO_CONFIG_H
+#define _PICO_CONFIG_H
+
+// Sem board header: valem os padrões de dvi_config_defs.h, que podem ser
+// trocados com target_compile_definitions() como no firmware.
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef _PICO_PLATFORM_H
+#define _PICO_PLATFORM_H
+
+#include <assert.h>
+
+#include "pico/types.h"
+#include "hardware/platform_defs.h"
+
+// No host tudo roda da RAM: as seções de código e dados só importam no RP2040
+#define __not_in_flash(group)
+#define __not_in_flash_func(func_name) func_name
+#define __time_critical_func(func_name) func_name
+#define __scratch_x(group)
+#define __scratch_y(group)
+#define __no_inline_not_in_flash_func(func_name) __attribute__((noinline)) func_name
+
+#ifndef MIN
+#define MIN(a, b) ((b) > (a) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+
+// Núcleo "atual" do host, para as estruturas por núcleo (interpoladores,
+// util_interp_owner). Os testes trocam de núcleo com host_set_core_num().
+extern uint host_core_num;
+
+static inline uint get_core_num(void) {
+    return host_core_num;
+}
+
+static inline void host_set_core_num(uint core) {
+    assert(core < NUM_CORES);
+    host_core_num = core;
+}
+
+#endif
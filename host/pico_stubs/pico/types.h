@@ -0,0 +1,10 @@
+#ifndef _PICO_TYPES_H
+#define _PICO_TYPES_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef unsigned int uint;
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef _PICO_UTIL_QUEUE_H
+#define _PICO_UTIL_QUEUE_H
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "pico.h"
+#include "hardware/sync.h"
+
+// Mesmo layout do SDK (util_queue_u32_inline.h acessa os campos direto)
+typedef struct {
+    spin_lock_t *spin_lock;
+} lock_core_t;
+
+typedef struct {
+    lock_core_t core;
+    uint8_t *data;
+    uint16_t wptr;
+    uint16_t rptr;
+    uint16_t element_size;
+    uint16_t element_count;
+} queue_t;
+
+static inline uint queue_get_level_unsafe(queue_t *q) {
+    int32_t rc = (int32_t)q->wptr - (int32_t)q->rptr;
+    if (rc < 0)
+        rc += q->element_count + 1;
+    return (uint)rc;
+}
+
+// Só para testes de uma thread: não há outro núcleo para esvaziar ou encher
+// a fila, então esperar seria travar, e "blocking" aborta no lugar
+static inline void queue_init(queue_t *q, uint element_size, uint element_count) {
+    q->core.spin_lock = NULL;
+    q->data = (uint8_t*)calloc(element_count + 1, element_size);
+    q->wptr = q->rptr = 0;
+    q->element_size = (uint16_t)element_size;
+    q->element_count = (uint16_t)element_count;
+}
+
+static inline void queue_free(queue_t *q) {
+    free(q->data);
+    q->data = NULL;
+}
+
+static inline void queue_add_blocking(queue_t *q, const void *data) {
+    if (queue_get_level_unsafe(q) == q->element_count)
+        abort();
+    memcpy(q->data + q->wptr * q->element_size, data, q->element_size);
+    q->wptr = (uint16_t)((q->wptr + 1) % (q->element_count + 1));
+}
+
+static inline void queue_remove_blocking(queue_t *q, void *data) {
+    if (queue_get_level_unsafe(q) == 0)
+        abort();
+    memcpy(data, q->data + q->rptr * q->element_size, q->element_size);
+    q->rptr = (uint16_t)((q->rptr + 1) % (q->element_count + 1));
+}
+
+#endif
@@ -0,0 +1,3 @@
+#include "pico/platform.h"
+
+uint host_core_num;
@@ -0,0 +1,93 @@
+// Benchmark no host: ns por pixel das rotinas de linha (codificação TMDS pelo
+// modelo do interpolador, sprites, tiles) e da escrita de texto da IHM.
+//
+// Os números são do PC rodando as versões em C de asm_ports/ e o modelo do
+// interpolador, então não dizem quantos ciclos a rotina gasta no RP2040. Servem
+// para comparar uma mudança contra a anterior no mesmo PC e para pegar
+// regressões grosseiras (um laço que virou quadrático, uma cópia a mais).
+//
+//   bench_host          repetições completas
+//   bench_host --quick  poucas repetições (é o que o ctest roda)
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "sprite.h"
+#include "text_screen.h"
+#include "tile.h"
+#include "tmds_encode.h"
+
+#define LINE_W 640
+
+static uint16_t line16[LINE_W];
+static uint32_t tmds_buf[LINE_W];
+static uint16_t sprite_img[32 * 32];
+static uint16_t tileset16[16 * 16 * 16];
+static uint8_t tilemap[(1024 / 16) * (256 / 16)];
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void report(const char *name, double t0, unsigned reps, unsigned pix_per_rep) {
+    double ns = now_ns() - t0;
+    printf("%-28s %8.2f ns/pixel\n", name, ns / ((double)reps * pix_per_rep));
+}
+
+int main(int argc, char **argv) {
+    unsigned reps = argc > 1 && !strcmp(argv[1], "--quick") ? 20 : 5000;
+    uint32_t seed = 1;
+    for (unsigned i = 0; i < LINE_W; ++i)
+        line16[i] = (uint16_t)(seed = seed * 1103515245u + 12345u) >> 16;
+    for (unsigned i = 0; i < sizeof(sprite_img) / sizeof(sprite_img[0]); ++i)
+        sprite_img[i] = (uint16_t)(i * 0x9e37u) | 0x20;
+    for (unsigned i = 0; i < sizeof(tileset16) / sizeof(tileset16[0]); ++i)
+        tileset16[i] = (uint16_t)(i * 0x2f1u);
+    for (unsigned i = 0; i < sizeof(tilemap); ++i)
+        tilemap[i] = (uint8_t)(i % 16);
+
+    double t0 = now_ns();
+    for (unsigned r = 0; r < reps; ++r)
+        for (uint ch = 0; ch < 3; ++ch)
+            tmds_encode_data_channel_16bpp((const uint32_t*)line16, tmds_buf, LINE_W / 2, 4 + 5 * ch, 5 * ch);
+    report("tmds 16bpp (3 canais)", t0, reps, LINE_W / 2);
+
+    t0 = now_ns();
+    for (unsigned r = 0; r < reps; ++r)
+        for (uint ch = 0; ch < 3; ++ch)
+            tmds_encode_data_channel_fullres_16bpp((const uint32_t*)line16, tmds_buf, LINE_W, 4 + 5 * ch, 5 * ch);
+    report("tmds fullres (3 canais)", t0, reps, LINE_W);
+
+    sprite_t sp = {.x = 0, .y = 0, .img = sprite_img, SPRITE_DIMS(32, 32, 32)};
+    t0 = now_ns();
+    for (unsigned r = 0; r < reps; ++r)
+        for (int x = -16; x < LINE_W; x += 40) {
+            sp.x = (int16_t)x;
+            sprite_sprite16(line16, &sp, r & 31, LINE_W);
+        }
+    report("sprite16 32x32 alfa", t0, reps, (LINE_W + 16) / 40 * 32);
+
+    tilebg_t bg = {
+        .tileset = tileset16, .tilemap = tilemap, .log_size_x = 10, .log_size_y = 8,
+        .tilesize = TILESIZE_16, .fill_loop = (tile_loop_t)tile16_16px_loop,
+    };
+    t0 = now_ns();
+    for (unsigned r = 0; r < reps; ++r) {
+        bg.xscroll = (uint16_t)r;
+        tile16(line16, &bg, r & 255, LINE_W);
+    }
+    report("tile16 16px", t0, reps, LINE_W);
+
+    // Uma tela de texto inteira por repetição; "pixel" aqui é a célula
+    t0 = now_ns();
+    for (unsigned r = 0; r < reps; ++r) {
+        clear_screen(0x00);
+        for (int y = 0; y < TEXT_MAX_ROWS; ++y)
+            write_text(1, y, "Acesso liberado: código 1234, até às 18h", 0x3f, 0x01);
+    }
+    report("texto (por célula)", t0, reps, TEXT_MAX_ROWS * CHAR_COLS);
+    return 0;
+}
@@ -0,0 +1,47 @@
+#ifndef _CHECK_H
+#define _CHECK_H
+
+// Verificações mínimas para os testes de host/: cada falha é impressa com
+// arquivo e linha, o teste continua, e check_exit() dá o código de saída
+// para o ctest.
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static int check_failures;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        printf("%s:%d: falhou: %s\n", __FILE__, __LINE__, #cond); \
+        ++check_failures; \
+    } \
+} while (0)
+
+#define CHECK_EQ(a, b) do { \
+    uint64_t check_a_ = (uint64_t)(a), check_b_ = (uint64_t)(b); \
+    if (check_a_ != check_b_) { \
+        printf("%s:%d: falhou: %s == %s (0x%" PRIx64 " != 0x%" PRIx64 ")\n", \
+            __FILE__, __LINE__, #a, #b, check_a_, check_b_); \
+        ++check_failures; \
+    } \
+} while (0)
+
+static inline int check_exit(const char *name) {
+    printf("%s: %s (%d falhas)\n", name, check_failures ? "FALHOU" : "OK", check_failures);
+    return check_failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+// Gerador determinístico (xorshift32), para os casos aleatórios serem
+// reproduzíveis
+static uint32_t check_rand_state = 0x2545f491u;
+
+static inline uint32_t check_rand(void) {
+    uint32_t x = check_rand_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return check_rand_state = x;
+}
+
+#endif
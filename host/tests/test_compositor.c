@@ -0,0 +1,381 @@
+// compositor.c: ordem por profundidade (e a volta à ordem do array sem
+// profundidades), estouro dos bins, pares de colisão, o limite de spans da
+// colisão e a varredura contra a sobreposição de retângulos, e a pilha de
+// camadas com recorte contra o desenho ingênuo de trás para frente.
+
+#include <string.h>
+
+#include "check.h"
+#include "compositor.h"
+
+#define W 128
+#define H 64
+#define ALPHA (1u << 5)
+#define LOG_MAP_W 7 // Mapa de 128 x 64 pixels, tiles de 8 px
+#define LOG_MAP_H 6
+#define N_TILES 8
+
+// Tudo o que passa pelos interpoladores como endereço é estático
+static compositor_t comp;
+static uint16_t flat_img[4][16 * 16];
+static uint16_t tileset[N_TILES * 8 * 8];
+static uint8_t tilemaps[3][(1 << LOG_MAP_W) / 8 * (1 << LOG_MAP_H) / 8];
+static uint16_t frame[H][W];
+
+static void make_flat_images(void) {
+    static const uint16_t colours[4] = {0xf800, 0x07c0, 0x001f, 0xffc0};
+    for (int i = 0; i < 4; ++i)
+        for (int p = 0; p < 16 * 16; ++p)
+            flat_img[i][p] = colours[i] | ALPHA;
+}
+
+static sprite_t flat_sprite(int i, int x, int y, int size) {
+    return (sprite_t){
+        .x = (int16_t)x, .y = (int16_t)y, .img = flat_img[i], SPRITE_DIMS(size, size, 16),
+        .flags = SPRITE_FLAG_OPAQUE,
+    };
+}
+
+// ----------------------------------------------------------------------------
+
+static void test_order(void) {
+    sprite_t sp[4];
+    for (int i = 0; i < 4; ++i)
+        sp[i] = flat_sprite(i, 10 + 2 * i, 0, 16);
+    uint8_t depth[4] = {3, 1, 2, 1};
+    compositor_init(&comp, W, H);
+    comp.sprites = sp;
+    comp.n_sprites = 4;
+    comp.depth = depth;
+    compositor_build_bins(&comp);
+    static const uint8_t by_depth[4] = {1, 3, 2, 0};
+    CHECK(memcmp(comp.order, by_depth, 4) == 0);
+    // x = 16 está sob os quatro: o de maior profundidade fica por cima
+    uint16_t line[W];
+    compositor_render_line16(&comp, line, 5);
+    CHECK_EQ(line[16], flat_img[0][0]);
+
+    // Sem profundidades, mesmo número de sprites: volta à ordem do array
+    comp.depth = NULL;
+    compositor_build_bins(&comp);
+    static const uint8_t identity[4] = {0, 1, 2, 3};
+    CHECK(memcmp(comp.order, identity, 4) == 0);
+    compositor_render_line16(&comp, line, 5);
+    CHECK_EQ(line[16], flat_img[3][0]);
+}
+
+static void test_bins(void) {
+    sprite_t sp[COMPOSITOR_BIN_SIZE + 5];
+    uint n = 0;
+    // Todos na faixa 0 (linhas 0 a 7): os três últimos não cabem
+    for (; n < COMPOSITOR_BIN_SIZE + 3; ++n)
+        sp[n] = flat_sprite(n & 3, (int)n, 0, 8);
+    // Um nas faixas 1 e 2, e um fora da tela
+    sp[n++] = flat_sprite(0, 0, 8, 16);
+    sp[n++] = flat_sprite(0, -20, 30, 8);
+    compositor_init(&comp, W, H);
+    comp.sprites = sp;
+    comp.n_sprites = n;
+    compositor_build_bins(&comp);
+    CHECK_EQ(comp.bin_count[0], COMPOSITOR_BIN_SIZE);
+    CHECK_EQ(comp.bin_overflows, 3);
+    CHECK_EQ(comp.bin_count[1], 1);
+    CHECK_EQ(comp.bin_count[2], 1);
+    CHECK_EQ(comp.bin_count[3], 0);
+    CHECK_EQ(comp.bin[1][0], COMPOSITOR_BIN_SIZE + 3);
+}
+
+static void test_collisions(void) {
+    sprite_t sp[6] = {
+        flat_sprite(0, 0, 0, 8),
+        flat_sprite(1, 4, 4, 8),     // sobre o 0, mesma máscara
+        flat_sprite(2, 4, 0, 8),     // sobre o 0 e o 1, máscara diferente
+        flat_sprite(3, 100, 40, 8),
+        flat_sprite(0, 104, 44, 8),  // sobre o 3, máscaras com um bit em comum
+        flat_sprite(1, 8, 0, 8),     // encosta no 0 sem sobrepor, sobre o 1
+    };
+    const uint8_t mask[6] = {1, 1, 2, 3, 2, 1};
+    compositor_init(&comp, W, H);
+    comp.sprites = sp;
+    comp.n_sprites = 6;
+    comp.collide_mask = mask;
+
+    // Um quadro inteiro pelas filas, como o Core 0 faz
+    queue_t q_free, q_valid;
+    queue_init(&q_free, sizeof(uint16_t*), H);
+    queue_init(&q_valid, sizeof(uint16_t*), H);
+    for (int y = 0; y < H; ++y) {
+        uint16_t *buf = frame[y];
+        queue_add_blocking(&q_free, &buf);
+    }
+    compositor_render_frame16(&comp, &q_free, &q_valid);
+    CHECK_EQ(queue_get_level_unsafe(&q_valid), H);
+    queue_free(&q_free);
+    queue_free(&q_valid);
+
+    compositor_pair_t pairs[4];
+    CHECK_EQ(compositor_get_collisions(&comp, pairs, 4), 3);
+    CHECK(pairs[0].a == 0 && pairs[0].b == 1);
+    CHECK(pairs[1].a == 1 && pairs[1].b == 5);
+    CHECK(pairs[2].a == 3 && pairs[2].b == 4);
+    // Com pouco espaço devolve o total mesmo assim
+    CHECK_EQ(compositor_get_collisions(&comp, pairs, 1), 3);
+    CHECK(pairs[0].a == 0 && pairs[0].b == 1);
+    CHECK_EQ(comp.collide_overflows, 0);
+}
+
+// Sprite de uma linha com três spans opacos (X.X.X.), com os metadados de
+// SPRITE_FLAG_SPAN_METADATA logo depois dos pixels
+static struct {
+    uint16_t px[6];
+    uint16_t row_start[2];
+    uint32_t spans[3];
+} three_spans;
+
+static void test_collide_span_limit(void) {
+    for (int x = 0; x < 6; ++x)
+        three_spans.px[x] = x & 1 ? 0 : 0xffff;
+    three_spans.row_start[0] = 0;
+    three_spans.row_start[1] = 3;
+    for (uint32_t s = 0; s < 3; ++s)
+        three_spans.spans[s] = 1u << 31 | (2 * s) << 16 | (2 * s + 1);
+
+    enum { N_FIT = COMPOSITOR_COLLIDE_MAX_SPANS / 3 };
+    sprite_t sp[N_FIT + 1];
+    uint8_t mask[N_FIT + 1];
+    for (int i = 0; i <= N_FIT; ++i) {
+        sp[i] = (sprite_t){.x = 0, .y = 10, .img = &three_spans, SPRITE_DIMS(6, 1, 6),
+            .flags = SPRITE_FLAG_SPAN_METADATA};
+        mask[i] = 1;
+    }
+    uint16_t line[W];
+    compositor_init(&comp, W, H);
+    comp.sprites = sp;
+    comp.collide_mask = mask;
+
+    // Todos cabem inteiros
+    comp.n_sprites = N_FIT;
+    compositor_build_bins(&comp);
+    compositor_render_line16(&comp, line, 10);
+    CHECK_EQ(comp.collide_overflows, 0);
+    CHECK_EQ(compositor_get_collisions(&comp, NULL, 0), N_FIT * (N_FIT - 1) / 2);
+
+    // O último só tem espaço para parte dos spans e conta como estouro
+    comp.n_sprites = N_FIT + 1;
+    compositor_build_bins(&comp);
+    compositor_render_line16(&comp, line, 10);
+    CHECK_EQ(comp.collide_overflows, 1);
+}
+
+// Sprites opacos inteiros de tamanhos aleatórios: os pares da varredura
+// contra a sobreposição dos retângulos recortados na tela
+static void test_collide_sweep(void) {
+    enum { N = 24 };
+    for (int iter = 0; iter < 50; ++iter) {
+        sprite_t sp[N];
+        uint8_t mask[N];
+        for (int i = 0; i < N; ++i) {
+            sp[i] = flat_sprite(i & 3, (int)(check_rand() % (W + 16)) - 16,
+                (int)(check_rand() % (H + 16)) - 16, 1 + (int)(check_rand() % 16));
+            mask[i] = (uint8_t)(check_rand() % 4);
+        }
+        compositor_init(&comp, W, H);
+        comp.sprites = sp;
+        comp.n_sprites = N;
+        comp.collide_mask = mask;
+        compositor_build_bins(&comp);
+        uint16_t line[W];
+        for (uint y = 0; y < H; ++y)
+            compositor_render_line16(&comp, line, y);
+
+        compositor_pair_t pairs[N * (N - 1) / 2];
+        uint n_pairs = compositor_get_collisions(&comp, pairs, count_of(pairs));
+        uint n_ref = 0;
+        for (int a = 0; a < N; ++a) {
+            for (int b = a + 1; b < N; ++b) {
+                int x0 = MAX(MAX(sp[a].x, sp[b].x), 0);
+                int x1 = MIN(MIN(sp[a].x + (int)sprite_w(&sp[a]), sp[b].x + (int)sprite_w(&sp[b])), W);
+                int y0 = MAX(MAX(sp[a].y, sp[b].y), 0);
+                int y1 = MIN(MIN(sp[a].y + (int)sprite_h(&sp[a]), sp[b].y + (int)sprite_h(&sp[b])), H);
+                if (x0 >= x1 || y0 >= y1 || !(mask[a] & mask[b]))
+                    continue;
+                CHECK(n_ref < n_pairs && pairs[n_ref].a == a && pairs[n_ref].b == b);
+                ++n_ref;
+            }
+        }
+        CHECK_EQ(n_pairs, n_ref);
+        CHECK_EQ(comp.collide_overflows, 0);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Pilha de camadas
+
+static uint16_t holed_img[16 * 16];
+
+// Metade de cima opaca com metadado de um span sólido, metade de baixo com
+// buracos e sem span sólido
+static struct {
+    uint16_t px[16 * 16];
+    uint32_t meta[16];
+} meta_img;
+
+static void make_stack_assets(void) {
+    for (int t = 0; t < N_TILES; ++t) {
+        for (int p = 0; p < 64; ++p) {
+            uint16_t v = (uint16_t)check_rand();
+            // Tiles 0 a 3 opacos, os outros com transparência
+            tileset[t * 64 + p] = t < 4 || check_rand() % 3 ? v | ALPHA : v & ~ALPHA;
+        }
+    }
+    for (int m = 0; m < 3; ++m)
+        for (unsigned i = 0; i < sizeof(tilemaps[m]); ++i)
+            tilemaps[m][i] = (uint8_t)(check_rand() % N_TILES);
+    for (int p = 0; p < 16 * 16; ++p) {
+        uint16_t v = (uint16_t)check_rand();
+        holed_img[p] = check_rand() % 4 ? v | ALPHA : v & ~ALPHA;
+        meta_img.px[p] = p < 8 * 16 || check_rand() % 4 ? v | ALPHA : v & ~ALPHA;
+    }
+    for (int y = 0; y < 16; ++y)
+        meta_img.meta[y] = (y < 8 ? 1u << 31 : 0) | 16;
+}
+
+static sprite_t random_sprite(void) {
+    sprite_t sp = {
+        .x = (int16_t)(check_rand() % (W + 16)) - 16, .y = (int16_t)(check_rand() % (H + 16)) - 16,
+        SPRITE_DIMS(16, 16, 16),
+    };
+    switch (check_rand() % 4) {
+        case 0: sp.img = flat_img[check_rand() % 4]; sp.flags = SPRITE_FLAG_OPAQUE; break;
+        case 1: sp.img = holed_img; break;
+        case 2: sp.img = meta_img.px; sp.flags = SPRITE_FLAG_OPACITY_METADATA; break;
+        default: sp.img = flat_img[check_rand() % 4]; sp.flags = SPRITE_FLAG_OPAQUE | SPRITE_FLAG_BLEND_50; break;
+    }
+    return sp;
+}
+
+static uint ref_layer(uint16_t *line, const tilebg_t *bg, uint y) {
+    if (!tilebg_line_enabled(bg, y))
+        return 0;
+    tile16(line, bg, y, W);
+    return W;
+}
+
+// Tudo desenhado por inteiro, de trás para frente; devolve os pixels
+// desenhados
+static uint ref_stack_line(const compositor_t *c, uint16_t *line, uint y) {
+    uint drawn = W;
+    if (c->bg && tilebg_line_enabled(c->bg, y))
+        tile16(line, c->bg, y, W);
+    else
+        sprite_fill16(line, c->bg_colour, W);
+    uint8_t sorted_sp[COMPOSITOR_MAX_SPRITES], sorted_l[COMPOSITOR_MAX_LAYERS];
+    for (uint i = 0; i < c->n_sprites; ++i) {
+        uint j = i;
+        for (; j > 0 && c->depth[sorted_sp[j - 1]] > c->depth[i]; --j)
+            sorted_sp[j] = sorted_sp[j - 1];
+        sorted_sp[j] = (uint8_t)i;
+    }
+    for (uint i = 0; i < c->n_layers; ++i) {
+        uint j = i;
+        for (; j > 0 && c->layers[sorted_l[j - 1]].depth > c->layers[i].depth; --j)
+            sorted_l[j] = sorted_l[j - 1];
+        sorted_l[j] = (uint8_t)i;
+    }
+    uint l = 0;
+    for (uint k = 0; k < c->n_sprites; ++k) {
+        uint i = sorted_sp[k];
+        while (l < c->n_layers && c->layers[sorted_l[l]].depth <= c->depth[i])
+            drawn += ref_layer(line, c->layers[sorted_l[l++]].bg, y);
+        const sprite_t *sp = &c->sprites[i];
+        sprite_sprite16(line, sp, y, W);
+        if ((uint)((int)y - sp->y) < sprite_h(sp))
+            drawn += MIN(sp->x + (int)sprite_w(sp), W) - MAX(sp->x, 0);
+    }
+    while (l < c->n_layers)
+        drawn += ref_layer(line, c->layers[sorted_l[l++]].bg, y);
+    return drawn;
+}
+
+static void test_stack(void) {
+    make_stack_assets();
+    uint32_t opaque_tiles[1] = {0};
+    tile16_opaque_tiles(tileset, N_TILES, TILESIZE_8, opaque_tiles);
+    CHECK_EQ(opaque_tiles[0] & 0xf, 0xf);
+
+    static uint32_t line_enable[2];
+    tilebg_t bgs[3];
+    for (int m = 0; m < 3; ++m) {
+        bgs[m] = (tilebg_t){
+            .tileset = tileset, .tilemap = tilemaps[m], .log_size_x = LOG_MAP_W, .log_size_y = LOG_MAP_H,
+            .tilesize = TILESIZE_8, .fill_loop = (tile_loop_t)tile16_8px_alpha_loop,
+        };
+    }
+    // O fundo sem transparência, para a referência não depender do que havia
+    // na linha
+    bgs[0].fill_loop = (tile_loop_t)tile16_8px_loop;
+
+    uint32_t culled = 0, naive = 0;
+    for (int iter = 0; iter < 30; ++iter) {
+        for (int m = 0; m < 3; ++m) {
+            bgs[m].xscroll = (uint16_t)check_rand();
+            bgs[m].yscroll = (uint16_t)check_rand();
+        }
+        line_enable[0] = check_rand();
+        line_enable[1] = check_rand();
+        bgs[2].line_enable = iter & 1 ? line_enable : NULL;
+        compositor_layer_t layers[2] = {
+            {.bg = &bgs[1], .depth = (uint8_t)(check_rand() % 4), .opaque_tiles = opaque_tiles},
+            {.bg = &bgs[2], .depth = (uint8_t)(check_rand() % 4), .opaque_tiles = iter & 2 ? opaque_tiles : NULL},
+        };
+        // Às vezes uma camada inteira opaca por cima de tudo
+        if (iter % 5 == 4) {
+            bgs[2].fill_loop = (tile_loop_t)tile16_8px_loop;
+            layers[1].flags = COMPOSITOR_LAYER_OPAQUE;
+            layers[1].depth = 3;
+        }
+        else {
+            bgs[2].fill_loop = (tile_loop_t)tile16_8px_alpha_loop;
+        }
+
+        sprite_t sp[12];
+        uint8_t depth[12];
+        uint n = 4 + check_rand() % 9;
+        for (uint i = 0; i < n; ++i) {
+            sp[i] = random_sprite();
+            depth[i] = (uint8_t)(check_rand() % 4);
+        }
+        compositor_init(&comp, W, H);
+        comp.sprites = sp;
+        comp.n_sprites = n;
+        comp.depth = depth;
+        comp.bg = iter & 4 ? &bgs[0] : NULL;
+        comp.bg_colour = 0x1234;
+        comp.layers = layers;
+        comp.n_layers = 2;
+        compositor_build_bins(&comp);
+
+        for (uint y = 0; y < H; ++y) {
+            uint16_t line[W + 16], ref[W + 16];
+            for (int x = 0; x < W + 16; ++x)
+                line[x] = ref[x] = (uint16_t)(0xabcd + x);
+            compositor_render_line16(&comp, line, y);
+            naive += ref_stack_line(&comp, ref, y);
+            CHECK(memcmp(line, ref, sizeof(line)) == 0);
+        }
+        culled += comp.stack_pixels;
+    }
+    // O recorte tem que poupar alguma coisa com camadas opacas na pilha
+    CHECK(culled < naive);
+}
+
+int main(void) {
+    make_flat_images();
+    test_order();
+    test_bins();
+    test_collisions();
+    test_collide_span_limit();
+    test_collide_sweep();
+    test_stack();
+    return check_exit("compositor");
+}
@@ -0,0 +1,65 @@
+// dvi_clock.c: a busca de PLL contra os limites do RP2040 e os valores
+// derivados (taxa de quadros, ciclos por linha, tensão).
+
+#include "check.h"
+#include "dvi_clock.h"
+
+static const struct dvi_timing *const timings[] = {
+    &dvi_timing_640x480p_60hz,
+    &dvi_timing_800x480p_60hz,
+    &dvi_timing_800x600p_60hz,
+    &dvi_timing_960x540p_60hz,
+    &dvi_timing_1280x720p_30hz,
+    &dvi_timing_800x600p_reduced_60hz,
+    &dvi_timing_1280x720p_reduced_30hz,
+    &dvi_timing_1600x900p_reduced_30hz,
+};
+
+int main(void) {
+    dvi_clock_plan_t p;
+
+    // 252 MHz: o VCO mais alto é 12 MHz x 126 = 1512 MHz / 6 / 1, como o SDK
+    CHECK(dvi_clock_plan(&dvi_timing_640x480p_60hz, &p));
+    CHECK_EQ(p.sys_khz, 252000);
+    CHECK_EQ(p.fbdiv, 126);
+    CHECK_EQ(p.postdiv1, 6);
+    CHECK_EQ(p.postdiv2, 1);
+    CHECK_EQ(p.error_ppm, 0);
+    CHECK_EQ(p.refresh_mhz, 60000);
+    CHECK_EQ(p.line_cycles, 8000);
+    CHECK_EQ(p.vreg_mv, 1200);
+    CHECK(!p.risky);
+
+    CHECK(dvi_clock_plan(&dvi_timing_1600x900p_reduced_30hz, &p));
+    CHECK_EQ(p.sys_khz, 488000);
+    CHECK_EQ(p.vreg_mv, 1300);
+    CHECK(p.risky);
+
+    for (unsigned i = 0; i < sizeof(timings) / sizeof(timings[0]); ++i) {
+        const struct dvi_timing *t = timings[i];
+        CHECK(dvi_clock_plan(t, &p));
+        CHECK_EQ(p.vco_khz, p.fbdiv * DVI_CLOCK_XOSC_KHZ);
+        CHECK(p.vco_khz >= DVI_CLOCK_VCO_MIN_KHZ && p.vco_khz <= DVI_CLOCK_VCO_MAX_KHZ);
+        CHECK(p.postdiv2 >= 1 && p.postdiv2 <= p.postdiv1 && p.postdiv1 <= DVI_CLOCK_POSTDIV_MAX);
+        CHECK_EQ(p.vco_khz % (p.postdiv1 * p.postdiv2), 0);
+        CHECK_EQ(p.sys_khz, p.vco_khz / (p.postdiv1 * p.postdiv2));
+        // Todos os modos de libdvi têm PLL exato
+        CHECK_EQ(p.error_ppm, 0);
+        // ~60 ou ~30 Hz
+        CHECK((p.refresh_mhz > 59000 && p.refresh_mhz < 61000) ||
+            (p.refresh_mhz > 29000 && p.refresh_mhz < 31000));
+        CHECK(p.vreg_mv >= 1100 && p.vreg_mv <= 1300 && p.vreg_mv % 50 == 0);
+    }
+
+    // Sem ajuste exato fica o mais próximo, com o erro informado
+    struct dvi_timing odd = dvi_timing_640x480p_60hz;
+    odd.bit_clk_khz = 251999;
+    CHECK(dvi_clock_plan(&odd, &p));
+    CHECK(p.error_ppm != 0);
+    CHECK(p.error_ppm > -100 && p.error_ppm < 100);
+    // Nenhuma saída perto de 10 MHz (o mínimo é 750 MHz / 49)
+    odd.bit_clk_khz = 10000;
+    CHECK(!dvi_clock_plan(&odd, &p));
+
+    return check_exit("dvi_clock");
+}
@@ -0,0 +1,116 @@
+// Temporizações de dvi_timing.c: estados verticais de um quadro completo e
+// as listas de blocos de controle de DMA de cada tipo de linha.
+
+#include "check.h"
+#include "dvi.h"
+
+static const struct dvi_timing *const timings[] = {
+    &dvi_timing_640x480p_60hz,
+    &dvi_timing_800x480p_60hz,
+    &dvi_timing_800x600p_60hz,
+    &dvi_timing_960x540p_60hz,
+    &dvi_timing_1280x720p_30hz,
+    &dvi_timing_800x600p_reduced_60hz,
+    &dvi_timing_1280x720p_reduced_30hz,
+    &dvi_timing_1600x900p_reduced_30hz,
+};
+
+static uint32_t fifo[N_TMDS_LANES];
+
+static const struct dvi_lane_dma_cfg dma_cfg[N_TMDS_LANES] = {
+    {.chan_ctrl = 0, .chan_data = 1, .tx_fifo = &fifo[0], .dreq = 0},
+    {.chan_ctrl = 2, .chan_data = 3, .tx_fifo = &fifo[1], .dreq = 1},
+    {.chan_ctrl = 4, .chan_data = 5, .tx_fifo = &fifo[2], .dreq = 2},
+};
+
+static unsigned ctrl_field(uint32_t ctrl, uint32_t bits, unsigned lsb) {
+    return (ctrl & bits) >> lsb;
+}
+
+static void test_frame_states(const struct dvi_timing *t) {
+    const uint lines[DVI_STATE_COUNT] = {t->v_front_porch, t->v_sync_width, t->v_back_porch, t->v_active_lines};
+    struct dvi_timing_state s;
+    dvi_timing_state_init(&s);
+    uint total = lines[0] + lines[1] + lines[2] + lines[3];
+    uint count[DVI_STATE_COUNT] = {0};
+    for (uint i = 0; i < 2 * total; ++i) {
+        CHECK(s.v_ctr < lines[s.v_state]);
+        ++count[s.v_state];
+        dvi_timing_state_advance(t, &s);
+    }
+    for (int i = 0; i < DVI_STATE_COUNT; ++i)
+        CHECK_EQ(count[i], 2 * lines[i]);
+    // Dois quadros depois, de volta ao início
+    CHECK_EQ(s.v_state, DVI_STATE_FRONT_PORCH);
+    CHECK_EQ(s.v_ctr, 0);
+}
+
+// Soma dos transfer_count de uma lane, e conferência dos campos comuns
+static uint lane_words(struct dvi_scanline_dma_list *l, int lane) {
+    dma_cb_t *cb = dvi_lane_from_list(l, lane);
+    int n = lane == TMDS_SYNC_LANE ? DVI_SYNC_LANE_CHUNKS : DVI_NOSYNC_LANE_CHUNKS;
+    uint words = 0;
+    for (int i = 0; i < n; ++i) {
+        words += cb[i].transfer_count;
+        CHECK(cb[i].write_addr == dma_cfg[lane].tx_fifo);
+        CHECK_EQ(ctrl_field(cb[i].c.ctrl, DMA_CH0_CTRL_TRIG_CHAIN_TO_BITS, DMA_CH0_CTRL_TRIG_CHAIN_TO_LSB), dma_cfg[lane].chan_ctrl);
+        CHECK_EQ(ctrl_field(cb[i].c.ctrl, DMA_CH0_CTRL_TRIG_TREQ_SEL_BITS, DMA_CH0_CTRL_TRIG_TREQ_SEL_LSB), dma_cfg[lane].dreq);
+        // Só o fim do back porch da lane de sincronismo gera IRQ
+        bool irq = !(cb[i].c.ctrl & DMA_CH0_CTRL_TRIG_IRQ_QUIET_BITS);
+        CHECK_EQ(irq, lane == TMDS_SYNC_LANE && i == 2);
+    }
+    return words;
+}
+
+static void test_dma_lists(const struct dvi_timing *t) {
+    uint h_total = t->h_front_porch + t->h_sync_width + t->h_back_porch + t->h_active_pixels;
+    uint active_words = t->h_active_pixels / DVI_SYMBOLS_PER_WORD;
+    static uint32_t tmdsbuf[3 * 1600 / DVI_SYMBOLS_PER_WORD];
+    struct dvi_scanline_dma_list l;
+
+    for (int vsync = 0; vsync < 2; ++vsync) {
+        dvi_scanline_dma_list_init(&l);
+        dvi_setup_scanline_for_vblank(t, dma_cfg, vsync, &l);
+        for (int lane = 0; lane < N_TMDS_LANES; ++lane)
+            CHECK_EQ(lane_words(&l, lane) * DVI_SYMBOLS_PER_WORD, h_total);
+        // Símbolo de controle do sincronismo (bit 1 = vsync, bit 0 = hsync)
+        const uint32_t *sync_on = dvi_lane_from_list(&l, TMDS_SYNC_LANE)[1].read_addr;
+        CHECK_EQ(sync_on - dvi_ctrl_syms, (uint)(t->v_sync_polarity == vsync) << 1 | t->h_sync_polarity);
+    }
+
+    dvi_scanline_dma_list_init(&l);
+    dvi_setup_scanline_for_active(t, dma_cfg, tmdsbuf, &l);
+    for (int lane = 0; lane < N_TMDS_LANES; ++lane) {
+        CHECK_EQ(lane_words(&l, lane) * DVI_SYMBOLS_PER_WORD, h_total);
+        dma_cb_t *data = &dvi_lane_from_list(&l, lane)[lane == TMDS_SYNC_LANE ? 3 : 1];
+        CHECK(data->read_addr == tmdsbuf + lane * active_words);
+        CHECK_EQ(data->transfer_count, active_words);
+        // Dados sem anel de leitura, controle repetido com anel de 4 bytes
+        CHECK_EQ(ctrl_field(data->c.ctrl, DMA_CH0_CTRL_TRIG_RING_SIZE_BITS, DMA_CH0_CTRL_TRIG_RING_SIZE_LSB), 0);
+        CHECK_EQ(ctrl_field(dvi_lane_from_list(&l, lane)[0].c.ctrl, DMA_CH0_CTRL_TRIG_RING_SIZE_BITS, DMA_CH0_CTRL_TRIG_RING_SIZE_LSB), 2);
+    }
+    dvi_update_scanline_data_dma(t, tmdsbuf + 1, &l);
+    for (int lane = 0; lane < N_TMDS_LANES; ++lane) {
+        const dma_cb_t *data = &dvi_lane_from_list(&l, lane)[lane == TMDS_SYNC_LANE ? 3 : 1];
+        CHECK(data->read_addr == tmdsbuf + 1 + lane * active_words);
+    }
+
+    // Sem buffer: linha de cor sólida repetida com anel
+    dvi_setup_scanline_for_active(t, dma_cfg, NULL, &l);
+    for (int lane = 0; lane < N_TMDS_LANES; ++lane) {
+        const dma_cb_t *data = &dvi_lane_from_list(&l, lane)[lane == TMDS_SYNC_LANE ? 3 : 1];
+        CHECK(data->read_addr != NULL);
+        CHECK_EQ(ctrl_field(data->c.ctrl, DMA_CH0_CTRL_TRIG_RING_SIZE_BITS, DMA_CH0_CTRL_TRIG_RING_SIZE_LSB), DVI_SYMBOLS_PER_WORD == 2 ? 2 : 3);
+    }
+}
+
+int main(void) {
+    for (unsigned i = 0; i < sizeof(timings) / sizeof(timings[0]); ++i) {
+        const struct dvi_timing *t = timings[i];
+        CHECK(t->h_active_pixels % DVI_SYMBOLS_PER_WORD == 0);
+        CHECK(t->h_active_pixels <= 1600);
+        test_frame_states(t);
+        test_dma_lists(t);
+    }
+    return check_exit("dvi_timing");
+}
@@ -0,0 +1,128 @@
+// Modelo dos interpoladores (pico_stubs/interp.c) contra o comportamento
+// descrito no datasheet do RP2040, e a troca de dono de util_interp_owner.
+
+#include "check.h"
+#include "hardware/interp.h"
+#include "util_interp_owner.h"
+
+static void test_default_config(void) {
+    interp_hw_t *interp = interp0_hw;
+    interp_config c = interp_default_config();
+    interp_set_config(interp, 0, &c);
+    interp_set_config(interp, 1, &c);
+    interp->accum[0] = 10;
+    interp->accum[1] = 200;
+    interp->base[0] = 1;
+    interp->base[1] = 2;
+    interp->base[2] = 3000;
+    CHECK_EQ(interp_peek_lane_result(interp, 0), 11);
+    CHECK_EQ(interp_peek_lane_result(interp, 1), 202);
+    CHECK_EQ(interp_peek_full_result(interp), 3210);
+    // POP escreve o resultado de cada lane no seu acumulador
+    CHECK_EQ(interp_pop_full_result(interp), 3210);
+    CHECK_EQ(interp->accum[0], 11);
+    CHECK_EQ(interp->accum[1], 202);
+    interp_add_accumulater(interp, 1, 5);
+    CHECK_EQ(interp->accum[1], 207);
+}
+
+static void test_shift_mask_signed(void) {
+    interp_hw_t *interp = interp1_hw;
+    interp_config c = interp_default_config();
+    interp_config_set_shift(&c, 4);
+    interp_config_set_mask(&c, 4, 11);
+    interp_set_config(interp, 0, &c);
+    interp->accum[0] = 0x12345678;
+    interp->base[0] = 0;
+    CHECK_EQ(interp_peek_lane_result(interp, 0), 0x560);
+    // Bits acima da máscara: OVERF0 e OVERF
+    uint32_t ctrl = interp_read_ctrl(interp, 0);
+    CHECK(ctrl & SIO_INTERP0_CTRL_LANE0_OVERF0_BITS);
+    CHECK(ctrl & SIO_INTERP0_CTRL_LANE0_OVERF_BITS);
+    CHECK(!(ctrl & SIO_INTERP0_CTRL_LANE0_OVERF1_BITS));
+    interp->accum[0] = 0xff0;
+    CHECK(!(interp_read_ctrl(interp, 0) & SIO_INTERP0_CTRL_LANE0_OVERF_BITS));
+
+    c = interp_default_config();
+    interp_config_set_mask(&c, 0, 3);
+    interp_config_set_signed(&c, true);
+    interp_set_config(interp, 0, &c);
+    interp->accum[0] = 0xf;
+    interp->base[0] = 100;
+    CHECK_EQ(interp_peek_lane_result(interp, 0), 99);
+    interp_config_set_force_bits(&c, 2);
+    interp_set_config(interp, 0, &c);
+    CHECK_EQ(interp_peek_lane_result(interp, 0), 99u | 2u << 28);
+}
+
+static void test_cross_and_add_raw(void) {
+    interp_hw_t *interp = interp0_hw;
+    interp_config c0 = interp_default_config();
+    interp_config_set_cross_result(&c0, true);
+    interp_set_config(interp, 0, &c0);
+    interp_config c1 = interp_default_config();
+    interp_config_set_cross_input(&c1, true);
+    interp_config_set_shift(&c1, 8);
+    interp_set_config(interp, 1, &c1);
+    interp->accum[0] = 0x1200;
+    interp->accum[1] = 7;
+    interp->base[0] = 1;
+    interp->base[1] = 0;
+    CHECK_EQ(interp_peek_lane_result(interp, 1), 0x12);
+    interp_pop_lane_result(interp, 0);
+    // Lane 0 recebe o resultado da lane 1, e lane 1 o seu próprio
+    CHECK_EQ(interp->accum[0], 0x12);
+    CHECK_EQ(interp->accum[1], 0x12);
+
+    // ADD_RAW soma o acumulador sem deslocamento na lane, mas FULL continua
+    // usando o valor mascarado
+    interp_config c = interp_default_config();
+    interp_config_set_add_raw(&c, true);
+    interp_config_set_shift(&c, 16);
+    interp_config_set_mask(&c, 0, 3);
+    interp_set_config(interp, 0, &c);
+    interp_config zero = interp_default_config();
+    interp_config_set_mask(&zero, 0, 0);
+    interp_set_config(interp, 1, &zero);
+    interp->accum[0] = 0x30000;
+    interp->accum[1] = 0;
+    interp->base[0] = 0x10000;
+    interp->base[2] = 0;
+    CHECK_EQ(interp_peek_full_result(interp), 3);
+    CHECK_EQ(interp_pop_full_result(interp), 3);
+    CHECK_EQ(interp->accum[0], 0x40000);
+}
+
+static void test_owner(void) {
+    static interp_owner_t keeper = INTERP_OWNER_INIT("keeper", true);
+    static interp_owner_t other = INTERP_OWNER_INIT("other", false);
+    for (uint core = 0; core < NUM_CORES; ++core) {
+        host_set_core_num(core);
+        interp_owner_claim(0, &keeper);
+        interp0_hw->accum[0] = 0x1234 + core;
+        interp0_hw->base[2] = 0x5678;
+    }
+    host_set_core_num(0);
+    uint32_t switches = interp_owner_switch_count[0];
+    interp_owner_claim(0, &other);
+    interp0_hw->accum[0] = 0;
+    interp0_hw->base[2] = 0;
+    // Reclamar sem trocar de dono não conta
+    interp_owner_claim(0, &other);
+    CHECK_EQ(interp_owner_switch_count[0], switches + 1);
+    interp_owner_claim(0, &keeper);
+    CHECK_EQ(interp0_hw->accum[0], 0x1234);
+    CHECK_EQ(interp0_hw->base[2], 0x5678);
+    // O outro núcleo não foi tocado
+    host_set_core_num(1);
+    CHECK_EQ(interp0_hw->accum[0], 0x1235);
+    host_set_core_num(0);
+}
+
+int main(void) {
+    test_default_config();
+    test_shift_mask_signed();
+    test_cross_and_add_raw();
+    test_owner();
+    return check_exit("interp");
+}
@@ -0,0 +1,190 @@
+// keypad_proto.c: quadros de ida e volta pelo decodificador, ressincronização
+// depois de erros de CRC e de tamanho, o descarte por inatividade de um
+// quadro com n corrompido para um valor maior, e a contagem de eventos
+// perdidos, repetidos e de reinícios em kp_link_accept.
+
+#include <string.h>
+
+#include "check.h"
+#include "keypad_proto.h"
+
+static size_t make_frame(uint8_t *buf, uint16_t seq, unsigned n) {
+    kp_event_t ev[KP_MAX_EVENTS];
+    for (unsigned i = 0; i < n; ++i)
+        ev[i] = (kp_event_t){ .key = (uint8_t)('0' + (seq + i) % 10), .flags = KP_EVENT_PRESSED,
+            .time_us = 1000000 - 10 * i };
+    return kp_frame_encode(buf, 0, seq, 1000000, ev, n);
+}
+
+// Alimenta len bytes e retorna quantos quadros saíram; o último fica em *last
+static unsigned feed(kp_decoder_t *d, const uint8_t *bytes, size_t len, kp_frame_t *last) {
+    unsigned frames = 0;
+    for (size_t i = 0; i < len; ++i)
+        frames += kp_decoder_feed(d, bytes[i], last);
+    return frames;
+}
+
+static unsigned idle(kp_decoder_t *d, kp_frame_t *last) {
+    unsigned frames = 0;
+    while (d->len)
+        frames += kp_decoder_idle(d, last);
+    return frames;
+}
+
+static void test_round_trip(void) {
+    kp_decoder_t d;
+    kp_decoder_init(&d);
+    uint8_t buf[KP_FRAME_MAX_BYTES];
+    for (unsigned n = 1; n <= KP_MAX_EVENTS; ++n) {
+        size_t len = make_frame(buf, (uint16_t)(100 * n), n);
+        CHECK_EQ(len, KP_FRAME_BYTES(n));
+        kp_frame_t f;
+        CHECK_EQ(feed(&d, buf, len, &f), 1);
+        CHECK_EQ(f.n_events, n);
+        CHECK_EQ(f.seq, 100 * n);
+        CHECK_EQ(f.time_us, 1000000);
+        CHECK_EQ(f.events[n - 1].key, '0' + (100 * n + n - 1) % 10);
+        CHECK_EQ(f.events[n - 1].time_us, 1000000 - 10 * (n - 1));
+    }
+    CHECK_EQ(d.len, 0);
+    CHECK_EQ(d.crc_errors + d.bad_lengths + d.skipped_bytes, 0);
+}
+
+static void test_crc_resync(void) {
+    kp_decoder_t d;
+    kp_decoder_init(&d);
+    uint8_t buf[3 * KP_FRAME_MAX_BYTES];
+    size_t a = make_frame(buf, 1, 3);
+    size_t b = make_frame(buf + a, 4, 2);
+    buf[a - 1] ^= 0x10;     // CRC do primeiro
+    kp_frame_t f;
+    CHECK_EQ(feed(&d, buf, a + b, &f), 1);
+    CHECK_EQ(f.seq, 4);
+    CHECK_EQ(d.crc_errors, 1);
+    CHECK_EQ(d.skipped_bytes, a);
+
+    // n = 0 é rejeitado já no segundo byte
+    kp_decoder_init(&d);
+    size_t c = make_frame(buf, 9, 1);
+    buf[1] = 0;
+    CHECK_EQ(feed(&d, buf, c, &f), 0);
+    CHECK_EQ(d.bad_lengths, 1);
+}
+
+static void test_idle_resync(void) {
+    kp_decoder_t d;
+    kp_decoder_init(&d);
+    uint8_t buf[2 * KP_FRAME_MAX_BYTES];
+    size_t a = make_frame(buf, 1, 1);
+    size_t b = make_frame(buf + a, 2, 2);
+    buf[1] = KP_MAX_EVENTS;     // n inflado: o decodificador espera 43 bytes
+    kp_frame_t f;
+    CHECK_EQ(feed(&d, buf, a + b, &f), 0);
+    CHECK_EQ(d.len, a + b);
+
+    // A linha para: o quadro seguinte sai sem esperar mais bytes
+    CHECK(kp_decoder_idle(&d, &f));
+    CHECK_EQ(f.seq, 2);
+    CHECK_EQ(d.len, 0);
+    CHECK(!kp_decoder_idle(&d, &f));
+    CHECK_EQ(d.timeouts, 1);
+    CHECK_EQ(d.skipped_bytes, a);
+
+    // Um quadro incompleto de verdade é descartado
+    size_t e = make_frame(buf, 5, 4);
+    CHECK_EQ(feed(&d, buf, e - 3, &f), 0);
+    CHECK_EQ(idle(&d, &f), 0);
+    CHECK_EQ(d.timeouts, 2);
+    CHECK_EQ(feed(&d, buf, e, &f), 1);
+    CHECK_EQ(f.seq, 5);
+
+    // Sem bytes no buffer não há o que expirar
+    CHECK(!kp_decoder_idle(&d, &f));
+    CHECK_EQ(d.timeouts, 2);
+}
+
+static kp_frame_t link_frame(uint16_t seq, unsigned n, uint8_t flags) {
+    kp_frame_t f = { .flags = flags, .seq = seq, .n_events = (uint8_t)n };
+    return f;
+}
+
+// kp_link_accept: perdidos, repetidos (quadro reenviado inteiro ou em parte)
+// e reinícios do emissor
+static void test_link_accounting(void) {
+    kp_link_t l;
+    kp_link_init(&l);
+    kp_frame_t f = link_frame(100, 3, 0);
+    CHECK_EQ(kp_link_accept(&l, &f), 0);     // primeiro quadro sincroniza
+    CHECK_EQ(l.next_seq, 103);
+    CHECK_EQ(l.events, 3);
+
+    // O mesmo quadro de novo: os três eventos são pulados
+    CHECK_EQ(kp_link_accept(&l, &f), 3);
+    CHECK_EQ(l.dup_events, 3);
+    CHECK_EQ(l.events, 3);
+    CHECK_EQ(l.next_seq, 103);
+
+    // Quadro que repete os dois últimos e traz dois novos
+    f = link_frame(101, 4, 0);
+    CHECK_EQ(kp_link_accept(&l, &f), 2);
+    CHECK_EQ(l.dup_events, 5);
+    CHECK_EQ(l.events, 5);
+    CHECK_EQ(l.next_seq, 105);
+
+    // Um quadro de 4 eventos se perdeu
+    f = link_frame(109, 1, 0);
+    CHECK_EQ(kp_link_accept(&l, &f), 0);
+    CHECK_EQ(l.lost_events, 4);
+    CHECK_EQ(l.next_seq, 110);
+
+    // A sequência dá a volta em 16 bits sem contar nada
+    kp_link_init(&l);
+    f = link_frame(0xfffe, 2, 0);
+    kp_link_accept(&l, &f);
+    f = link_frame(0, 2, 0);
+    CHECK_EQ(kp_link_accept(&l, &f), 0);
+    CHECK_EQ(l.lost_events + l.dup_events + l.restarts, 0);
+
+    // Emissor reiniciou: com KP_FRAME_RESTART, ou um salto grande sem ele
+    // (o quadro de reinício se perdeu)
+    f = link_frame(0, 1, KP_FRAME_RESTART);
+    CHECK_EQ(kp_link_accept(&l, &f), 0);
+    CHECK_EQ(l.restarts, 1);
+    CHECK_EQ(l.next_seq, 1);
+    f = link_frame(1 + KP_LINK_RESYNC_DISTANCE + 1, 2, 0);
+    CHECK_EQ(kp_link_accept(&l, &f), 0);
+    CHECK_EQ(l.restarts, 2);
+    CHECK_EQ(l.lost_events + l.dup_events, 0);
+    CHECK_EQ(l.frames, 4);
+    CHECK_EQ(l.events, 7);
+}
+
+// Um quadro reenviado pelo fio chega duas vezes inteiro ao decodificador, e
+// o enlace entrega os eventos uma vez só
+static void test_replayed_frame(void) {
+    kp_decoder_t d;
+    kp_link_t l;
+    kp_decoder_init(&d);
+    kp_link_init(&l);
+    uint8_t buf[KP_FRAME_MAX_BYTES];
+    size_t len = make_frame(buf, 7, 5);
+    unsigned delivered = 0;
+    for (int copy = 0; copy < 2; ++copy) {
+        kp_frame_t f;
+        CHECK_EQ(feed(&d, buf, len, &f), 1);
+        delivered += f.n_events - kp_link_accept(&l, &f);
+    }
+    CHECK_EQ(delivered, 5);
+    CHECK_EQ(l.frames, 2);
+    CHECK_EQ(l.dup_events, 5);
+    CHECK_EQ(l.lost_events, 0);
+}
+
+int main(void) {
+    test_round_trip();
+    test_crc_resync();
+    test_idle_resync();
+    test_link_accounting();
+    test_replayed_frame();
+    return check_exit("keypad_proto");
+}
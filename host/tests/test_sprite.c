@@ -0,0 +1,354 @@
+// sprite.c e os laços de asm_ports/sprite_loops.c contra versões ingênuas:
+// recorte nas bordas, espelhamento vertical, metadados de opacidade (um span
+// ou vários por linha), misturas, sprites afins e os tamanhos de 256 px.
+
+#include <string.h>
+
+#include "check.h"
+#include "sprite.h"
+
+#define RASTER_W 96
+#define ALPHA (1u << 5)
+
+// ----------------------------------------------------------------------------
+// Referências
+
+static uint16_t ref_avg(uint16_t a, uint16_t b) {
+    return (uint16_t)((a & b) + (((a ^ b) & 0xf7deu) >> 1));
+}
+
+static uint16_t ref_blend(uint16_t src, uint16_t dst, uint blend) {
+    switch (blend) {
+        case SPRITE_FLAG_BLEND_25: return ref_avg(ref_avg(src, dst), dst);
+        case SPRITE_FLAG_BLEND_50: return ref_avg(src, dst);
+        case SPRITE_FLAG_BLEND_75: return ref_avg(ref_avg(dst, src), src);
+        default: return src;
+    }
+}
+
+static void ref_sprite16(uint16_t *scanbuf, const sprite_t *sp, const uint16_t *img, uint raster_y) {
+    int ly = (int)raster_y - sp->y;
+    if (ly < 0 || ly >= (int)sprite_h(sp))
+        return;
+    if (sp->flags & SPRITE_FLAG_VFLIP)
+        ly = (int)sprite_h(sp) - 1 - ly;
+    for (int lx = 0; lx < (int)sprite_w(sp); ++lx) {
+        int x = sp->x + lx;
+        uint16_t p = img[ly * (int)sprite_stride(sp) + lx];
+        if (x < 0 || x >= RASTER_W || !((sp->flags & SPRITE_FLAG_OPAQUE) || (p & ALPHA)))
+            continue;
+        scanbuf[x] = ref_blend(p, scanbuf[x], sp->flags & SPRITE_FLAG_BLEND_MASK);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Imagem com metadados, como tools/sprite_conv.py gera
+
+#define IMG_W 24
+#define IMG_H 12
+#define MAX_SPANS_PER_ROW (IMG_W / 2 + 1)
+
+typedef struct {
+    uint16_t px[IMG_W * IMG_H];
+    uint32_t meta[IMG_H + 1 + IMG_H * MAX_SPANS_PER_ROW];
+} sprite_img16_t;
+
+// Pixels opacos em blocos (para haver spans sólidos longos), mais buracos
+static void make_image16(uint16_t *px, int w, int h, int holes) {
+    for (int i = 0; i < w * h; ++i) {
+        uint16_t p = (uint16_t)check_rand();
+        px[i] = (i / 5 + i / w) % 3 || (int)(check_rand() % 100) < 100 - holes ? p | ALPHA : p & ~ALPHA;
+    }
+}
+
+static void make_opacity_meta(sprite_img16_t *img) {
+    for (int y = 0; y < IMG_H; ++y) {
+        const uint16_t *row = img->px + y * IMG_W;
+        int first = IMG_W, last = -1;
+        for (int x = 0; x < IMG_W; ++x) {
+            if (row[x] & ALPHA) {
+                first = first < x ? first : x;
+                last = x;
+            }
+        }
+        if (last < 0) {
+            img->meta[y] = 0;
+            continue;
+        }
+        bool solid = true;
+        for (int x = first; x <= last; ++x)
+            solid = solid && (row[x] & ALPHA);
+        img->meta[y] = (solid ? 1u << 31 : 0) | (uint32_t)first << 16 | (uint32_t)(last + 1);
+    }
+}
+
+static void make_span_meta(sprite_img16_t *img) {
+    uint16_t *row_start = (uint16_t*)img->meta;
+    uint32_t *spans = (uint32_t*)(row_start + ((IMG_H + 2) & ~1u));
+    uint n = 0;
+    for (int y = 0; y < IMG_H; ++y) {
+        row_start[y] = (uint16_t)n;
+        const uint16_t *row = img->px + y * IMG_W;
+        for (int x = 0; x < IMG_W;) {
+            if (!(row[x] & ALPHA)) {
+                ++x;
+                continue;
+            }
+            int start = x;
+            while (x < IMG_W && (row[x] & ALPHA))
+                ++x;
+            spans[n++] = 1u << 31 | (uint32_t)start << 16 | (uint32_t)x;
+        }
+    }
+    row_start[IMG_H] = (uint16_t)n;
+}
+
+// ----------------------------------------------------------------------------
+
+static void test_blits(void) {
+    uint16_t src[RASTER_W], dst[RASTER_W], ref[RASTER_W];
+    for (int iter = 0; iter < 200; ++iter) {
+        for (int i = 0; i < RASTER_W; ++i) {
+            src[i] = (uint16_t)check_rand();
+            dst[i] = ref[i] = (uint16_t)check_rand();
+        }
+        uint s = check_rand() % 8, d = check_rand() % 8, len = check_rand() % (RASTER_W - 8);
+        int op = iter % 5;
+        for (uint i = 0; i < len; ++i) {
+            uint16_t p = src[s + i];
+            if (op == 0)
+                ref[d + i] = p;
+            else if (op == 1 && (p & ALPHA))
+                ref[d + i] = p;
+            else if (op >= 2 && (p & ALPHA))
+                ref[d + i] = ref_blend(p, ref[d + i], (uint)(op - 1) << 5);
+        }
+        if (op == 0)
+            sprite_blit16(dst + d, src + s, len);
+        else if (op == 1)
+            sprite_blit16_alpha(dst + d, src + s, len);
+        else
+            sprite_blit16_blend_func((uint)(op - 1) << 5)(dst + d, src + s, len);
+        CHECK(memcmp(dst, ref, sizeof(dst)) == 0);
+    }
+
+    for (int i = 0; i < RASTER_W; ++i)
+        dst[i] = ref[i] = (uint16_t)check_rand();
+    sprite_fill16_blend25(dst + 1, 0xf800, 10);
+    sprite_fill16_blend75(dst + 20, 0x07e0, 11);
+    for (int i = 0; i < 10; ++i)
+        ref[1 + i] = ref_blend(0xf800, ref[1 + i], SPRITE_FLAG_BLEND_25);
+    for (int i = 0; i < 11; ++i)
+        ref[20 + i] = ref_blend(0x07e0, ref[20 + i], SPRITE_FLAG_BLEND_75);
+    CHECK(memcmp(dst, ref, sizeof(dst)) == 0);
+
+    uint8_t src8[RASTER_W], dst8[RASTER_W], ref8[RASTER_W];
+    for (int i = 0; i < RASTER_W; ++i) {
+        src8[i] = (uint8_t)check_rand();
+        dst8[i] = ref8[i] = (uint8_t)check_rand();
+    }
+    sprite_blit8_alpha(dst8 + 3, src8, 50);
+    for (int i = 0; i < 50; ++i)
+        if (src8[i] & ALPHA)
+            ref8[3 + i] = src8[i];
+    CHECK(memcmp(dst8, ref8, sizeof(dst8)) == 0);
+}
+
+static sprite_img16_t img_meta, img_spans;
+
+static void test_sprite16(void) {
+    make_image16(img_meta.px, IMG_W, IMG_H, 30);
+    memcpy(img_spans.px, img_meta.px, sizeof(img_meta.px));
+    make_opacity_meta(&img_meta);
+    make_span_meta(&img_spans);
+
+    static const uint flag_sets[] = {
+        0,
+        SPRITE_FLAG_VFLIP,
+        SPRITE_FLAG_OPAQUE,
+        SPRITE_FLAG_OPACITY_METADATA,
+        SPRITE_FLAG_SPAN_METADATA,
+        SPRITE_FLAG_SPAN_METADATA | SPRITE_FLAG_VFLIP,
+        SPRITE_FLAG_BLEND_50,
+        SPRITE_FLAG_BLEND_25 | SPRITE_FLAG_OPACITY_METADATA,
+        SPRITE_FLAG_BLEND_75 | SPRITE_FLAG_SPAN_METADATA,
+    };
+    static const int xs[] = {-30, -10, 0, 7, RASTER_W - IMG_W, RASTER_W - 5, RASTER_W};
+    for (unsigned f = 0; f < sizeof(flag_sets) / sizeof(flag_sets[0]); ++f) {
+        for (unsigned xi = 0; xi < sizeof(xs) / sizeof(xs[0]); ++xi) {
+            uint flags = flag_sets[f];
+            sprite_t sp = {
+                .x = (int16_t)xs[xi], .y = 3,
+                .img = flags & SPRITE_FLAG_SPAN_METADATA ? img_spans.px : img_meta.px,
+                SPRITE_DIMS(IMG_W, IMG_H, IMG_W), .flags = (uint8_t)flags
+            };
+            for (uint y = 0; y < IMG_H + 6; ++y) {
+                uint16_t scan[RASTER_W], ref[RASTER_W];
+                for (int i = 0; i < RASTER_W; ++i)
+                    scan[i] = ref[i] = (uint16_t)(0x1234 + 3 * i);
+                sprite_sprite16(scan, &sp, y, RASTER_W);
+                ref_sprite16(ref, &sp, img_meta.px, y);
+                CHECK(memcmp(scan, ref, sizeof(scan)) == 0);
+            }
+        }
+    }
+
+    // Spans opacos: sem buracos fora deles, e os sólidos não têm
+    // transparência nenhuma
+    for (uint y = 3; y < 3 + IMG_H; ++y) {
+        for (int meta = 0; meta < 2; ++meta) {
+            sprite_t sp = {
+                .x = -4, .y = 3, .img = meta ? img_spans.px : img_meta.px,
+                SPRITE_DIMS(IMG_W, IMG_H, IMG_W),
+                .flags = meta ? SPRITE_FLAG_SPAN_METADATA : SPRITE_FLAG_OPACITY_METADATA
+            };
+            const uint16_t *row = img_meta.px + (y - 3) * IMG_W;
+            int16_t spans[2 * MAX_SPANS_PER_ROW];
+            uint n = sprite_opaque_spans(&sp, y, RASTER_W, 1, spans, MAX_SPANS_PER_ROW);
+            int covered = 0;
+            for (uint i = 0; i < n; ++i) {
+                CHECK(spans[2 * i] >= 0 && spans[2 * i] < spans[2 * i + 1]);
+                covered += spans[2 * i + 1] - spans[2 * i];
+            }
+            int opaque = 0;
+            for (int x = 4; x < IMG_W; ++x)
+                opaque += !!(row[x] & ALPHA);
+            CHECK(covered >= opaque);
+            n = sprite_solid_spans(&sp, y, RASTER_W, 1, spans, MAX_SPANS_PER_ROW);
+            for (uint i = 0; i < n; ++i)
+                for (int x = spans[2 * i]; x < spans[2 * i + 1]; ++x)
+                    CHECK(row[x + 4] & ALPHA);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Afins: a textura passa pelo interp0 como endereço, então é estática
+
+#define TEX_LOG 4
+#define TEX_SIZE (1 << TEX_LOG)
+static uint16_t tex16[TEX_SIZE * TEX_SIZE];
+static uint8_t tex8[TEX_SIZE * TEX_SIZE];
+
+// O span é percorrido a partir do fim: o pixel local lx amostra a textura
+// em atrans * (lx + 1, ly)
+static void ref_asprite(uint16_t *scan16, uint8_t *scan8, const sprite_t *sp, const affine_transform_t a, uint raster_y) {
+    int ly = (int)raster_y - sp->y;
+    if (ly < 0 || ly >= (int)sprite_h(sp))
+        return;
+    for (int lx = 0; lx < (int)sprite_w(sp); ++lx) {
+        int x = sp->x + lx;
+        if (x < 0 || x >= RASTER_W)
+            continue;
+        uint32_t u = (uint32_t)(a[0] * (lx + 1) + a[1] * ly + a[2]) >> 16;
+        uint32_t v = (uint32_t)(a[3] * (lx + 1) + a[4] * ly + a[5]) >> 16;
+        if (u >= sprite_w(sp) || v >= sprite_h(sp))
+            continue;
+        if (scan16) {
+            uint16_t p = ((const uint16_t*)sp->img)[v * sprite_stride(sp) + u];
+            if ((sp->flags & SPRITE_FLAG_OPAQUE) || (p & ALPHA))
+                scan16[x] = p;
+        }
+        else {
+            uint8_t p = ((const uint8_t*)sp->img)[v * sprite_stride(sp) + u];
+            if ((sp->flags & SPRITE_FLAG_OPAQUE) || (p & ALPHA))
+                scan8[x] = p;
+        }
+    }
+}
+
+static void test_asprite(void) {
+    make_image16(tex16, TEX_SIZE, TEX_SIZE, 20);
+    for (int i = 0; i < TEX_SIZE * TEX_SIZE; ++i)
+        tex8[i] = (uint8_t)tex16[i];
+    // Identidade, ampliação 2x, rotação de ~30 graus com deslocamento
+    static const affine_transform_t transforms[] = {
+        {1 << 16, 0, 0, 0, 1 << 16, 0},
+        {1 << 15, 0, 0, 0, 1 << 15, 0},
+        {56756, -32768, 4 << 16, 32768, 56756, -3 << 16},
+    };
+    for (unsigned t = 0; t < sizeof(transforms) / sizeof(transforms[0]); ++t) {
+        for (int f = 0; f < 4; ++f) {
+            bool is16 = f & 1;
+            sprite_t sp = {
+                .x = (int16_t)(f & 2 ? -5 : RASTER_W - 10), .y = 2, .img = is16 ? (const void*)tex16 : (const void*)tex8,
+                SPRITE_DIMS(TEX_SIZE, TEX_SIZE, TEX_SIZE), .flags = f & 2 ? SPRITE_FLAG_OPAQUE : 0
+            };
+            asprite_cache_t cache;
+            sprite_asprite_prepare(&cache, &sp, transforms[t], is16, RASTER_W);
+            for (uint y = 0; y < TEX_SIZE + 4; ++y) {
+                uint16_t scan16[RASTER_W], ref16[RASTER_W], direct16[RASTER_W];
+                uint8_t scan8[RASTER_W], ref8[RASTER_W], direct8[RASTER_W];
+                for (int i = 0; i < RASTER_W; ++i) {
+                    scan16[i] = ref16[i] = direct16[i] = (uint16_t)i;
+                    scan8[i] = ref8[i] = direct8[i] = (uint8_t)i;
+                }
+                if (is16) {
+                    sprite_asprite16_cached(scan16, &sp, &cache, y);
+                    sprite_asprite16(direct16, &sp, transforms[t], y, RASTER_W);
+                    ref_asprite(ref16, NULL, &sp, transforms[t], y);
+                    CHECK(memcmp(scan16, ref16, sizeof(scan16)) == 0);
+                    CHECK(memcmp(direct16, ref16, sizeof(direct16)) == 0);
+                }
+                else {
+                    sprite_asprite8_cached(scan8, &sp, &cache, y);
+                    sprite_asprite8(direct8, &sp, transforms[t], y, RASTER_W);
+                    ref_asprite(NULL, ref8, &sp, transforms[t], y);
+                    CHECK(memcmp(scan8, ref8, sizeof(scan8)) == 0);
+                    CHECK(memcmp(direct8, ref8, sizeof(direct8)) == 0);
+                }
+            }
+        }
+    }
+}
+
+// 256 px, o máximo de w, h e stride: um sprite recortado de uma folha de
+// 256 px de largura, a folha inteira, e a folha como textura afim
+static uint16_t sheet[256 * 256];
+
+static void test_large(void) {
+    make_image16(sheet, 256, 256, 20);
+    static const struct { uint offs_x, offs_y, w, h; int x; } subs[] = {
+        {200, 30, 56, 40, 10},
+        {0, 0, 256, 256, -100},
+        {0, 255, 256, 1, -160},
+    };
+    for (unsigned i = 0; i < sizeof(subs) / sizeof(subs[0]); ++i) {
+        const uint16_t *img = sheet + subs[i].offs_y * 256 + subs[i].offs_x;
+        sprite_t sp = {
+            .x = (int16_t)subs[i].x, .y = 0, .img = img, SPRITE_DIMS(subs[i].w, subs[i].h, 256),
+        };
+        CHECK_EQ(sprite_w(&sp), subs[i].w);
+        CHECK_EQ(sprite_stride(&sp), 256);
+        for (uint y = 0; y < 260; y += 7) {
+            uint16_t scan[RASTER_W], ref[RASTER_W];
+            for (int x = 0; x < RASTER_W; ++x)
+                scan[x] = ref[x] = (uint16_t)x;
+            sprite_sprite16(scan, &sp, y, RASTER_W);
+            ref_sprite16(ref, &sp, img, y);
+            CHECK(memcmp(scan, ref, sizeof(scan)) == 0);
+        }
+    }
+
+    // Escala 1/2 e deslocamento: as coordenadas passam de 128 e dão a volta
+    static const affine_transform_t a = {1 << 17, 0, 100 << 16, 0, 1 << 17, 60 << 16};
+    sprite_t sp = {.x = -40, .y = 0, .img = sheet, SPRITE_DIMS(256, 256, 256)};
+    asprite_cache_t cache;
+    sprite_asprite_prepare(&cache, &sp, a, 1, RASTER_W);
+    for (uint y = 0; y < 256; y += 5) {
+        uint16_t scan[RASTER_W], ref[RASTER_W];
+        for (int x = 0; x < RASTER_W; ++x)
+            scan[x] = ref[x] = (uint16_t)x;
+        sprite_asprite16_cached(scan, &sp, &cache, y);
+        ref_asprite(ref, NULL, &sp, a, y);
+        CHECK(memcmp(scan, ref, sizeof(scan)) == 0);
+    }
+}
+
+int main(void) {
+    test_blits();
+    test_sprite16();
+    test_asprite();
+    test_large();
+    return check_exit("sprite");
+}
@@ -0,0 +1,112 @@
+// text_screen.c: ida e volta das cores em RGB222, escrita UTF-8 com bordas
+// protegidas, centralização e os atributos de linha.
+
+#include <string.h>
+
+#include "check.h"
+#include "text_screen.h"
+
+static void test_colour(void) {
+    set_row_scale(3, 1, false);
+    // Todas as combinações em algumas células, inclusive nas bordas de palavra
+    static const unsigned xs[] = {0, 7, 8, 41, CHAR_COLS - 1};
+    for (unsigned i = 0; i < sizeof(xs) / sizeof(xs[0]); ++i) {
+        for (unsigned c = 0; c < 64 * 64; c += 7) {
+            uint8_t fg = c & 0x3f, bg = c >> 6, fg2, bg2;
+            set_colour(xs[i], 3, fg, bg);
+            get_colour(xs[i], 3, &fg2, &bg2);
+            CHECK_EQ(fg2, fg);
+            CHECK_EQ(bg2, bg);
+        }
+    }
+    // Escrever uma célula não mexe nas vizinhas
+    set_colour(10, 3, 0x15, 0x2a);
+    set_colour(11, 3, 0x3f, 0x00);
+    set_colour(9, 3, 0x00, 0x3f);
+    uint8_t fg, bg;
+    get_colour(10, 3, &fg, &bg);
+    CHECK_EQ(fg, 0x15);
+    CHECK_EQ(bg, 0x2a);
+    // Fora da linha não escreve
+    set_row_scale(4, 1, true);
+    set_colour(10, 4, 0x01, 0x02);
+    set_colour(CHAR_COLS / 2, 4, 0x3f, 0x3f);
+    get_colour(CHAR_COLS / 2, 4, &fg, &bg);
+    CHECK_EQ(fg, 0x00);
+    CHECK_EQ(bg, 0x00);
+    set_row_scale(4, 1, false);
+}
+
+static void test_row_scale(void) {
+    set_row_scale(5, 0, false);
+    CHECK_EQ(text_row_attr[5], 1);
+    set_row_scale(5, 9, true);
+    CHECK_EQ(text_row_attr[5], TEXT_MAX_SCALE | TEXT_ROW_HDOUBLE);
+    CHECK_EQ(row_attr_scale(text_row_attr[5]), TEXT_MAX_SCALE);
+    CHECK_EQ(row_cols(5), CHAR_COLS / 2);
+    CHECK_EQ(row_attr_scale(0), 1);
+    set_row_scale(TEXT_MAX_ROWS, 2, false);
+    set_row_scale(5, 1, false);
+    CHECK_EQ(row_cols(5), CHAR_COLS);
+}
+
+static void test_write(void) {
+    clear_screen(0x01);
+    for (unsigned x = 0; x < CHAR_COLS; ++x)
+        CHECK_EQ(charbuf[6 * CHAR_COLS + x], ' ');
+
+    // Cada codepoint é uma célula; Latin-1 vira o próprio byte
+    CHECK_EQ(utf8_len("Olá, ação"), 9);
+    write_text(2, 6, "ação", 0x3f, 0x01);
+    CHECK(memcmp(&charbuf[6 * CHAR_COLS + 2], "a\xe7\xe3o", 4) == 0);
+    // Sequência inválida consome um byte e fora da fonte aparece '?'
+    CHECK_EQ(utf8_len("\x80z"), 2);
+    write_text(2, 7, "\xe2\x82\xac", 0x3f, 0x01);
+    CHECK(charbuf[7 * CHAR_COLS + 2] == '?' || (uint8_t)charbuf[7 * CHAR_COLS + 2] >= 0x80);
+
+    // As bordas (coluna 0 e a última) nunca são escritas
+    charbuf[8 * CHAR_COLS] = '#';
+    charbuf[9 * CHAR_COLS - 1] = '#';
+    write_text(-3, 8, "abcdef", 0x3f, 0x01);
+    CHECK_EQ(charbuf[8 * CHAR_COLS], '#');
+    CHECK(memcmp(&charbuf[8 * CHAR_COLS + 1], "ef", 2) == 0);
+    write_text(CHAR_COLS - 3, 8, "xyz", 0x3f, 0x01);
+    CHECK(memcmp(&charbuf[9 * CHAR_COLS - 3], "xy#", 3) == 0);
+
+    // clear_line também preserva as bordas
+    clear_line(8, 0x02);
+    CHECK_EQ(charbuf[8 * CHAR_COLS], '#');
+    CHECK_EQ(charbuf[9 * CHAR_COLS - 1], '#');
+    uint8_t fg, bg;
+    get_colour(1, 8, &fg, &bg);
+    CHECK_EQ(bg, 0x02);
+    get_colour(0, 8, &fg, &bg);
+    CHECK_EQ(bg, 0x01);
+}
+
+static void test_centered(void) {
+    clear_screen(0x00);
+    // Centraliza por codepoints, não por bytes
+    write_centered(10, "ção", 0x3f, 0x00);
+    unsigned start = CHAR_COLS / 2 - 1;
+    CHECK(memcmp(&charbuf[10 * CHAR_COLS + start], "\xe7\xe3o", 3) == 0);
+    CHECK_EQ(charbuf[10 * CHAR_COLS + start - 1], ' ');
+
+    // Em linha com duplicação horizontal o centro é CHAR_COLS / 4
+    set_row_scale(11, 2, true);
+    write_centered(11, "ab", 0x3f, 0x00);
+    CHECK(memcmp(&charbuf[11 * CHAR_COLS + CHAR_COLS / 4 - 1], "ab", 2) == 0);
+    set_row_scale(11, 1, false);
+
+    // Linha inválida é ignorada
+    write_centered(-1, "x", 0x3f, 0x00);
+    write_centered(TEXT_MAX_ROWS, "x", 0x3f, 0x00);
+}
+
+int main(void) {
+    test_colour();
+    test_row_scale();
+    test_write();
+    test_centered();
+    return check_exit("text_screen");
+}
@@ -0,0 +1,160 @@
+// tile.c e os laços de asm_ports/tile_loops.c contra uma versão ingênua,
+// para os 8 laços (8/16 bpp, tiles de 8/16 px, com e sem alfa), com rolagem,
+// rolagem por linha, linhas desligadas e renderização de trechos.
+
+#include <string.h>
+
+#include "check.h"
+#include "hardware/interp.h"
+#include "tile.h"
+
+#define RASTER_W 80
+#define ALPHA (1u << 5)
+#define LOG_MAP_W 7 // Mapa de 128 x 64 pixels
+#define LOG_MAP_H 6
+#define N_TILES 16
+
+// O mapa passa pelo interp1 como endereço, então é estático. Tem o tamanho
+// para tiles de 8 px, que sobra para os de 16.
+static uint8_t tilemap[(1 << LOG_MAP_W) / 8 * (1 << LOG_MAP_H) / 8];
+static uint16_t tileset16[N_TILES * 16 * 16];
+static uint8_t tileset8[N_TILES * 16 * 16];
+
+typedef struct {
+    tile_loop_t loop;
+    tilesize_t size;
+    bool is16;
+    bool alpha;
+} loop_case_t;
+
+static const loop_case_t cases[] = {
+    {(tile_loop_t)tile16_16px_alpha_loop, TILESIZE_16, true, true},
+    {(tile_loop_t)tile16_16px_loop,       TILESIZE_16, true, false},
+    {(tile_loop_t)tile16_8px_alpha_loop,  TILESIZE_8,  true, true},
+    {(tile_loop_t)tile16_8px_loop,        TILESIZE_8,  true, false},
+    {(tile_loop_t)tile8_16px_alpha_loop,  TILESIZE_16, false, true},
+    {(tile_loop_t)tile8_16px_loop,        TILESIZE_16, false, false},
+    {(tile_loop_t)tile8_8px_alpha_loop,   TILESIZE_8,  false, true},
+    {(tile_loop_t)tile8_8px_loop,         TILESIZE_8,  false, false},
+};
+
+static uint32_t ref_pixel(const tilebg_t *bg, bool is16, uint x, uint y) {
+    uint log_tile = bg->tilesize == TILESIZE_16 ? 4 : 3;
+    uint tile_mask = (1u << log_tile) - 1;
+    uint mx = x & ((1u << bg->log_size_x) - 1);
+    uint my = y & ((1u << bg->log_size_y) - 1);
+    uint t = bg->tilemap[(my >> log_tile << (bg->log_size_x - log_tile)) + (mx >> log_tile)];
+    uint idx = (t << 2 * log_tile) + ((my & tile_mask) << log_tile) + (mx & tile_mask);
+    return is16 ? tileset16[idx] : tileset8[idx];
+}
+
+static void ref_line(void *scanbuf, const tilebg_t *bg, const loop_case_t *c, uint y, uint x0, uint x1) {
+    if (!tilebg_line_enabled(bg, y))
+        return;
+    uint xs = bg->xscroll + (bg->line_xscroll ? bg->line_xscroll[y] : 0);
+    uint ys = bg->yscroll + (bg->line_yscroll ? bg->line_yscroll[y] : 0);
+    for (uint x = x0; x < x1; ++x) {
+        uint32_t p = ref_pixel(bg, c->is16, xs + x, ys + y);
+        if (c->alpha && !(p & ALPHA))
+            continue;
+        if (c->is16)
+            ((uint16_t*)scanbuf)[x] = (uint16_t)p;
+        else
+            ((uint8_t*)scanbuf)[x] = (uint8_t)p;
+    }
+}
+
+static void render(void *scanbuf, const tilebg_t *bg, const loop_case_t *c, uint y, uint x0, uint x1, bool range) {
+    if (c->is16) {
+        if (range)
+            tile16_range(scanbuf, bg, y, x0, x1);
+        else
+            tile16(scanbuf, bg, y, RASTER_W);
+    }
+    else {
+        if (range)
+            tile8_range(scanbuf, bg, y, x0, x1);
+        else
+            tile8(scanbuf, bg, y, RASTER_W);
+    }
+}
+
+int main(void) {
+    for (unsigned i = 0; i < sizeof(tilemap); ++i)
+        tilemap[i] = (uint8_t)(check_rand() % N_TILES);
+    for (unsigned i = 0; i < sizeof(tileset16) / sizeof(tileset16[0]); ++i) {
+        tileset16[i] = (uint16_t)check_rand();
+        tileset8[i] = (uint8_t)check_rand();
+    }
+    static int16_t line_xscroll[64];
+    static uint32_t line_enable[2];
+    for (int i = 0; i < 64; ++i)
+        line_xscroll[i] = (int16_t)(check_rand() % 200) - 100;
+    line_enable[0] = check_rand();
+    line_enable[1] = check_rand();
+
+    for (unsigned ci = 0; ci < sizeof(cases) / sizeof(cases[0]); ++ci) {
+        const loop_case_t *c = &cases[ci];
+        for (int iter = 0; iter < 40; ++iter) {
+            tilebg_t bg = {
+                .xscroll = (uint16_t)check_rand(),
+                .yscroll = (uint16_t)check_rand(),
+                .tileset = c->is16 ? (const void*)tileset16 : (const void*)tileset8,
+                .tilemap = tilemap,
+                .log_size_x = LOG_MAP_W,
+                .log_size_y = LOG_MAP_H,
+                .tilesize = c->size,
+                .fill_loop = c->loop,
+                .line_xscroll = iter & 1 ? line_xscroll : NULL,
+                .line_enable = iter & 2 ? line_enable : NULL,
+            };
+            uint y = check_rand() % 64;
+            bool range = iter & 4;
+            uint x0 = range ? check_rand() % RASTER_W : 0;
+            uint x1 = range ? x0 + check_rand() % (RASTER_W - x0 + 1) : RASTER_W;
+            // Com folga depois do fim, para pegar escrita além de x1
+            uint16_t scan16[RASTER_W + 16], ref16[RASTER_W + 16];
+            uint8_t scan8[RASTER_W + 16], ref8[RASTER_W + 16];
+            for (int i = 0; i < RASTER_W + 16; ++i) {
+                scan16[i] = ref16[i] = (uint16_t)(0xabcd + i);
+                scan8[i] = ref8[i] = (uint8_t)(0x5a + i);
+            }
+            // Lixo no ACCUM1 do interp1, que tile.c não usa
+            interp1_hw->accum[1] = check_rand();
+            render(c->is16 ? (void*)scan16 : (void*)scan8, &bg, c, y, x0, x1, range);
+            ref_line(c->is16 ? (void*)ref16 : (void*)ref8, &bg, c, y, x0, x1);
+            if (c->is16)
+                CHECK(memcmp(scan16, ref16, sizeof(scan16)) == 0);
+            else
+                CHECK(memcmp(scan8, ref8, sizeof(scan8)) == 0);
+        }
+    }
+
+    // Tiles opacos e spans
+    uint32_t opaque[1] = {0};
+    tile16_opaque_tiles(tileset16, N_TILES, TILESIZE_8, opaque);
+    for (uint t = 0; t < N_TILES; ++t) {
+        bool all = true;
+        for (int i = 0; i < 64; ++i)
+            all = all && (tileset16[t * 64 + i] & ALPHA);
+        CHECK_EQ(opaque[0] >> t & 1, all);
+    }
+    opaque[0] = 0x5555;
+    tilebg_t bg = {
+        .xscroll = 5, .tileset = tileset16, .tilemap = tilemap, .log_size_x = LOG_MAP_W,
+        .log_size_y = LOG_MAP_H, .tilesize = TILESIZE_8, .fill_loop = (tile_loop_t)tile16_8px_loop,
+    };
+    int16_t spans[2 * 16];
+    for (uint y = 0; y < 64; ++y) {
+        uint n = tilebg_opaque_spans(&bg, opaque, y, RASTER_W, spans, 16);
+        for (uint x = 0; x < RASTER_W; ++x) {
+            uint mx = (x + 5) & 127;
+            uint t = tilemap[(y >> 3 << 4) + (mx >> 3)];
+            bool in_span = false;
+            for (uint i = 0; i < n; ++i)
+                in_span = in_span || ((int)x >= spans[2 * i] && (int)x < spans[2 * i + 1]);
+            CHECK_EQ(in_span, opaque[0] >> t & 1);
+        }
+    }
+    return check_exit("tile");
+}
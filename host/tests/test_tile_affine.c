@@ -0,0 +1,111 @@
+// tile_affine.c: a configuração das lanes de interp0/interp1 contra o cálculo
+// direto de (u, v) -> entrada do mapa e deslocamento do texel, para os dois
+// tamanhos de tile e de pixel, e as linhas em perspectiva contra uma
+// referência em 64 bits, inclusive perto do horizonte.
+
+#include <string.h>
+
+#include "check.h"
+#include "hardware/interp.h"
+#include "tile_affine.h"
+
+#define RASTER_W 64
+#define LOG_MAP_W 8 // Mapa de 256 x 128 pixels
+#define LOG_MAP_H 7
+
+// O mapa passa pelo interp0 como endereço, então é estático
+static uint8_t tilemap[(1 << LOG_MAP_W) / 8 * (1 << LOG_MAP_H) / 8];
+
+// No lugar dos laços de tile_affine.S: faz os mesmos dois POP_FULL por pixel
+// e guarda os resultados
+static uint32_t got_entry[RASTER_W], got_texel[RASTER_W];
+
+static void probe_loop(void *dst, const void *tileset, uint len) {
+    (void)dst;
+    (void)tileset;
+    for (uint x = 0; x < len; ++x) {
+        got_entry[x] = interp_pop_full_result(interp0_hw);
+        got_texel[x] = interp_pop_full_result(interp1_hw);
+    }
+}
+
+static void test_lanes(void) {
+    static affine_line_t lines[1];
+    for (int iter = 0; iter < 200; ++iter) {
+        tilesize_t size = iter & 1 ? TILESIZE_16 : TILESIZE_8;
+        bool is16 = iter & 2;
+        uint log_tile = 3 + (uint)size;
+        tilebg_affine_t bg = {
+            .tilemap = tilemap, .log_size_x = LOG_MAP_W, .log_size_y = LOG_MAP_H,
+            .tilesize = size, .fill_loop = probe_loop, .lines = lines,
+        };
+        lines[0] = (affine_line_t){
+            .u0 = (int32_t)check_rand(), .v0 = (int32_t)check_rand(),
+            .du = (int32_t)(check_rand() % (8 << 16)) - (4 << 16),
+            .dv = (int32_t)(check_rand() % (8 << 16)) - (4 << 16),
+        };
+        // Lixo de quem usou os interpoladores antes
+        interp0_hw->accum[1] = interp1_hw->accum[1] = check_rand();
+        if (is16)
+            tile_affine16(NULL, &bg, 0, RASTER_W);
+        else
+            tile_affine8(NULL, &bg, 0, RASTER_W);
+
+        uint32_t tile_mask = (1u << log_tile) - 1;
+        uint log_w = LOG_MAP_W - log_tile;
+        for (uint x = 0; x < RASTER_W; ++x) {
+            uint32_t u = ((uint32_t)lines[0].u0 + x * (uint32_t)lines[0].du) >> 16;
+            uint32_t v = ((uint32_t)lines[0].v0 + x * (uint32_t)lines[0].dv) >> 16;
+            uint32_t tx = (u >> log_tile) & ((1u << log_w) - 1);
+            uint32_t ty = (v >> log_tile) & ((1u << (LOG_MAP_H - log_tile)) - 1);
+            uint32_t texel = ((v & tile_mask) << log_tile | (u & tile_mask)) << is16;
+            CHECK_EQ(got_entry[x], (uint32_t)(uintptr_t)&tilemap[ty << log_w | tx]);
+            CHECK_EQ(got_texel[x], texel);
+        }
+    }
+}
+
+// Referência: o ponto no chão sob o centro da linha, dist = height * focal /
+// dy à frente da câmera, em 64 bits; só os 32 bits de baixo contam
+static void ref_perspective(affine_line_t *line, const affine_camera_t *cam, int dy, uint raster_w) {
+    int64_t scale = cam->height / dy;
+    int64_t c = cos_fp1616(cam->theta), s = sin_fp1616(cam->theta);
+    int64_t du = -(s * scale >> 16), dv = c * scale >> 16;
+    int64_t dist = scale * cam->focal;
+    line->du = (int32_t)du;
+    line->dv = (int32_t)dv;
+    line->u0 = (int32_t)(uint32_t)(cam->u + (c * dist >> 16) - du * (raster_w / 2));
+    line->v0 = (int32_t)(uint32_t)(cam->v + (s * dist >> 16) - dv * (raster_w / 2));
+}
+
+static void test_perspective(void) {
+    const affine_camera_t cams[] = {
+        {.u = 100 << 16, .v = 50 << 16, .height = 24 << 16, .focal = 160, .theta = 0},
+        {.u = -(7 << 16), .v = 3 << 16, .height = 24 << 16, .focal = 160, .theta = 37},
+        // Câmera alta e focal longa: scale * focal passa de 32 bits perto do
+        // horizonte
+        {.u = 1 << 16, .v = 2 << 16, .height = 200 << 16, .focal = 1000, .theta = 200},
+        {.u = 0, .v = 0, .height = 0x7fff0000, .focal = 0xffff, .theta = 64},
+    };
+    const int horizon = 40;
+    for (unsigned i = 0; i < sizeof(cams) / sizeof(cams[0]); ++i) {
+        for (uint y = horizon + 1; y < horizon + 100; ++y) {
+            affine_line_t got, ref;
+            tile_affine_line_perspective(&got, &cams[i], horizon, y, 320);
+            ref_perspective(&ref, &cams[i], (int)y - horizon, 320);
+            CHECK(memcmp(&got, &ref, sizeof(got)) == 0);
+        }
+        // Acima do horizonte a linha não é tocada
+        affine_line_t line = {1, 2, 3, 4};
+        tile_affine_line_perspective(&line, &cams[i], horizon, horizon, 320);
+        CHECK(line.u0 == 1 && line.v0 == 2 && line.du == 3 && line.dv == 4);
+    }
+}
+
+int main(void) {
+    for (unsigned i = 0; i < sizeof(tilemap); ++i)
+        tilemap[i] = (uint8_t)check_rand();
+    test_lanes();
+    test_perspective();
+    return check_exit("tile_affine");
+}
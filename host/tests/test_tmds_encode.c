@@ -0,0 +1,168 @@
+// Codificadores TMDS de tmds_encode.c (com os laços de asm_ports/): cada
+// símbolo gerado é decodificado como um receptor DVI faria e comparado com o
+// canal de cor do pixel de entrada, e o balanço DC é conferido.
+
+#include <string.h>
+
+#include "check.h"
+#include "tmds_encode.h"
+
+#define N_PIX 64
+
+// Decodificação TMDS de um símbolo de dados de 10 bits (DVI 1.0, 3.3.3)
+static unsigned tmds_decode(uint32_t sym) {
+    uint32_t q = sym & 0x3ff;
+    if (q & 0x200)
+        q ^= 0xff;
+    unsigned d = q & 1;
+    for (int i = 1; i < 8; ++i) {
+        unsigned bit = (q >> i ^ q >> (i - 1)) & 1;
+        if (!(q & 0x100))
+            bit ^= 1;
+        d |= bit << i;
+    }
+    return d;
+}
+
+static int sym_disparity(uint32_t sym) {
+    return 2 * __builtin_popcount(sym & 0x3ff) - 10;
+}
+
+// Valor de 6 bits que o codificador usa para um canal de msb..lsb
+static unsigned channel6(uint32_t pix, unsigned msb, unsigned lsb) {
+    unsigned width = msb - lsb + 1;
+    return (pix >> lsb & ((1u << width) - 1)) << (6 - width);
+}
+
+// Com pixels duplicados, cada palavra é um par de símbolos para o mesmo
+// valor, com balanço DC nulo
+static void check_doubled(uint32_t word, unsigned expect6) {
+    CHECK_EQ(tmds_decode(word) >> 2, expect6);
+    CHECK_EQ(tmds_decode(word >> 10) >> 2, expect6);
+    CHECK_EQ(__builtin_popcount(word & 0xfffff), 10);
+}
+
+static void test_16bpp(void) {
+    static const unsigned msb[3] = {DVI_16BPP_BLUE_MSB, DVI_16BPP_GREEN_MSB, DVI_16BPP_RED_MSB};
+    static const unsigned lsb[3] = {DVI_16BPP_BLUE_LSB, DVI_16BPP_GREEN_LSB, DVI_16BPP_RED_LSB};
+    uint16_t pix[N_PIX];
+    uint32_t sym[N_PIX];
+    for (int i = 0; i < N_PIX; ++i)
+        pix[i] = (uint16_t)check_rand();
+    pix[0] = 0x0000;
+    pix[1] = 0xffff;
+    for (int c = 0; c < 3; ++c) {
+        tmds_encode_data_channel_16bpp((const uint32_t*)pix, sym, N_PIX, msb[c], lsb[c]);
+        for (int i = 0; i < N_PIX; ++i)
+            check_doubled(sym[i], channel6(pix[i], msb[c], lsb[c]));
+    }
+}
+
+static void test_8bpp(void) {
+    static const unsigned msb[3] = {DVI_8BPP_BLUE_MSB, DVI_8BPP_GREEN_MSB, DVI_8BPP_RED_MSB};
+    static const unsigned lsb[3] = {DVI_8BPP_BLUE_LSB, DVI_8BPP_GREEN_LSB, DVI_8BPP_RED_LSB};
+    // Dobro do tamanho: a versão com deslocamento (azul e verde) percorre o
+    // dobro de palavras, ver asm_ports/tmds_encode_loops.c
+    uint8_t pix[2 * N_PIX];
+    uint32_t sym[2 * N_PIX];
+    for (int i = 0; i < 2 * N_PIX; ++i)
+        pix[i] = (uint8_t)check_rand();
+    for (int c = 0; c < 3; ++c) {
+        tmds_encode_data_channel_8bpp((const uint32_t*)pix, sym, N_PIX, msb[c], lsb[c]);
+        for (int i = 0; i < N_PIX; ++i)
+            check_doubled(sym[i], channel6(pix[i], msb[c], lsb[c]));
+    }
+}
+
+// Resolução total: um símbolo por pixel, com disparidade corrente separada
+// para pixels pares e ímpares (os dois interpoladores)
+static void test_fullres(void) {
+    static const unsigned msb[3] = {DVI_16BPP_BLUE_MSB, DVI_16BPP_GREEN_MSB, DVI_16BPP_RED_MSB};
+    static const unsigned lsb[3] = {DVI_16BPP_BLUE_LSB, DVI_16BPP_GREEN_LSB, DVI_16BPP_RED_LSB};
+    uint16_t pix[N_PIX];
+    uint32_t sym[N_PIX];
+    for (int i = 0; i < N_PIX; ++i)
+        pix[i] = (uint16_t)check_rand();
+    for (uint core = 0; core < NUM_CORES; ++core) {
+        host_set_core_num(core);
+        for (int c = 0; c < 3; ++c) {
+            tmds_encode_data_channel_fullres_16bpp((const uint32_t*)pix, sym, N_PIX, msb[c], lsb[c]);
+            int disparity[2] = {0, 0};
+            for (int i = 0; i < N_PIX; ++i) {
+                CHECK_EQ(tmds_decode(sym[i]) >> 2, channel6(pix[i], msb[c], lsb[c]));
+                disparity[i & 1] += sym_disparity(sym[i]);
+                CHECK(disparity[i & 1] >= -10 && disparity[i & 1] <= 10);
+            }
+        }
+    }
+    host_set_core_num(0);
+}
+
+// Paleta: os símbolos vêm de tmds_setup_palette_symbols(), e a tabela passa
+// pelos interpoladores, então precisa ser estática
+static uint16_t palette[256];
+static uint32_t tmds_palette[6 * 256];
+
+static void test_palette(void) {
+    for (int i = 0; i < 256; ++i)
+        palette[i] = (uint16_t)check_rand();
+    tmds_setup_palette_symbols(palette, tmds_palette, 256);
+    uint8_t pix[N_PIX];
+    uint32_t sym[3 * N_PIX / 2];
+    for (int i = 0; i < N_PIX; ++i)
+        pix[i] = (uint8_t)check_rand();
+    for (uint core = 0; core < NUM_CORES; ++core) {
+        host_set_core_num(core);
+        memset(sym, 0, sizeof(sym));
+        tmds_encode_palette_data((const uint32_t*)pix, tmds_palette, sym, N_PIX, 8);
+        for (int c = 0; c < 3; ++c) {
+            int disparity[2] = {0, 0};
+            for (int i = 0; i < N_PIX; ++i) {
+                uint32_t s = sym[c * N_PIX / 2 + i / 2] >> (i & 1 ? 10 : 0);
+                uint16_t p = palette[pix[i]];
+                unsigned expect = c == 0 ? (p << 3 & 0xf8) : c == 1 ? (p >> 3 & 0xfc) : (p >> 8 & 0xf8);
+                CHECK_EQ(tmds_decode(s), expect);
+                disparity[i & 1] += sym_disparity(s);
+                CHECK(disparity[i & 1] >= -10 && disparity[i & 1] <= 10);
+            }
+        }
+    }
+    host_set_core_num(0);
+}
+
+static void test_1bpp_2bpp(void) {
+    uint32_t pix[N_PIX / 16];
+    uint32_t sym[N_PIX / 2];
+    for (int i = 0; i < N_PIX / 16; ++i)
+        pix[i] = check_rand();
+    tmds_encode_1bpp(pix, sym, N_PIX / 2);
+    int disparity = 0;
+    for (int i = 0; i < N_PIX / 2; ++i) {
+        uint32_t s = sym[i / 2] >> (i & 1 ? 10 : 0);
+        unsigned bit = pix[i / 32] >> (i % 32) & 1;
+        CHECK_EQ(tmds_decode(s) >> 1, bit ? 0x7f : 0x00);
+        disparity += sym_disparity(s);
+    }
+    CHECK_EQ(disparity, 0);
+
+    // 2bpp: níveis 0, 1/3, 2/3 e 1, com os códigos de tmds_encode.S
+    static const unsigned level[4] = {0x05, 0x50, 0xaf, 0xfa};
+    tmds_encode_2bpp(pix, sym, N_PIX / 4);
+    disparity = 0;
+    for (int i = 0; i < N_PIX / 4; ++i) {
+        uint32_t s = sym[i / 2] >> (i & 1 ? 10 : 0);
+        unsigned lvl = pix[i / 16] >> (2 * (i % 16)) & 3;
+        CHECK_EQ(tmds_decode(s) & 0xfe, level[lvl] & 0xfe);
+        disparity += sym_disparity(s);
+    }
+    CHECK_EQ(disparity, 0);
+}
+
+int main(void) {
+    test_16bpp();
+    test_8bpp();
+    test_fullres();
+    test_palette();
+    test_1bpp_2bpp();
+    return check_exit("tmds_encode");
+}
@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+
+# Golden-image test for the receiver UI screens: runs ui_screens, which drives
+# ui.c through every screen and renders charbuf/colourbuf the way core 1 does
+# (host/text_render.c), and compares each frame pixel by pixel against the
+# PNGs in host/tests/golden/.
+#
+#   test_ui_golden.py --bin build-host/ui_screens --out build-host/ui_golden
+#   test_ui_golden.py ... --update     (rewrite the reference PNGs)
+#
+# On a mismatch the rendered frame is left as <out>/<name>.png, next to the
+# PPM, for a side-by-side look.
+
+import argparse
+import os
+import subprocess
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+sys.path.insert(0, os.path.join(HERE, "..", "..", "tools"))
+import pngutil
+
+GOLDEN_DIR = os.path.join(HERE, "golden")
+
+def read_ppm(path):
+	data = open(path, "rb").read()
+	fields = data.split(maxsplit=4)
+	if fields[0] != b"P6" or fields[3] != b"255":
+		raise ValueError(f"{path}: not an 8-bit binary PPM")
+	width, height = int(fields[1]), int(fields[2])
+	raw = fields[4]
+	return [[tuple(raw[(y * width + x) * 3:(y * width + x) * 3 + 3]) for x in range(width)]
+		for y in range(height)]
+
+def compare(name, got, want):
+	if len(got) != len(want) or len(got[0]) != len(want[0]):
+		return f"{name}: size {len(got[0])}x{len(got)}, expected {len(want[0])}x{len(want)}"
+	diffs = [(x, y) for y, (g, w) in enumerate(zip(got, want))
+		for x, (pg, pw) in enumerate(zip(g, w)) if pg != pw[:3]]
+	if not diffs:
+		return None
+	xs = [x for x, _ in diffs]
+	ys = [y for _, y in diffs]
+	x, y = diffs[0]
+	return (f"{name}: {len(diffs)} pixels differ in ({min(xs)},{min(ys)})-({max(xs)},{max(ys)}), "
+		f"first at ({x},{y}): {got[y][x]} != {want[y][x][:3]}")
+
+def main():
+	p = argparse.ArgumentParser(description="compare UI screens against golden PNGs")
+	p.add_argument("--bin", required=True, help="ui_screens executable")
+	p.add_argument("--out", required=True, help="directory for the rendered frames")
+	p.add_argument("--update", action="store_true", help="rewrite the golden PNGs")
+	args = p.parse_args()
+
+	os.makedirs(args.out, exist_ok=True)
+	for f in os.listdir(args.out):
+		if f.endswith((".ppm", ".png")):
+			os.remove(os.path.join(args.out, f))
+	subprocess.run([args.bin, args.out], check=True)
+
+	names = sorted(f[:-4] for f in os.listdir(args.out) if f.endswith(".ppm"))
+	failures = []
+	for name in names:
+		got = read_ppm(os.path.join(args.out, name + ".ppm"))
+		golden = os.path.join(GOLDEN_DIR, name + ".png")
+		if args.update:
+			pngutil.write_png(golden, got)
+			print(f"{name}: updated")
+			continue
+		if not os.path.exists(golden):
+			failures.append(f"{name}: no golden image (run with --update)")
+			continue
+		err = compare(name, got, pngutil.read_png(golden))
+		if err:
+			pngutil.write_png(os.path.join(args.out, name + ".png"), got)
+			failures.append(err)
+		else:
+			print(f"{name}: OK")
+	# A golden image without a screen means ui_screens lost a state
+	if not args.update:
+		for f in sorted(os.listdir(GOLDEN_DIR)):
+			if f.endswith(".png") and f[:-4] not in names:
+				failures.append(f"{f[:-4]}: golden image has no rendered screen")
+	for f in failures:
+		print(f)
+	return 1 if failures else 0
+
+if __name__ == "__main__":
+	sys.exit(main())
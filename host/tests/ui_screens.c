@@ -0,0 +1,85 @@
+// Leva a IHM (ui.c) por cada uma das telas e grava a renderização de cada uma
+// (text_render.h) como <dir>/<nome>.ppm, para test_ui_golden.py comparar com
+// as imagens de referência em host/tests/golden/.
+//
+// Uso: ui_screens <dir>
+
+#include <stdio.h>
+#include <string.h>
+
+#include "text_render.h"
+#include "ui.h"
+
+#define SEC 1000000ull
+
+static uint8_t frame[TEXT_RENDER_BYTES];
+static const char *out_dir;
+static int errors;
+
+static void snapshot(const char *name) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s.ppm", out_dir, name);
+    text_render_frame(frame);
+    FILE *f = fopen(path, "wb");
+    if (!f || text_render_write_ppm(f, frame) != 0) {
+        perror(path);
+        ++errors;
+    }
+    if (f)
+        fclose(f);
+}
+
+static void type(ui_t *ui, const char *digits, uint64_t now_us) {
+    for (; *digits; ++digits)
+        ui_on_char(ui, *digits, now_us);
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        fprintf(stderr, "uso: %s <dir>\n", argv[0]);
+        return 2;
+    }
+    out_dir = argv[1];
+
+    // Reset normal
+    ui_t ui = { .watchdog_resets = 0, .reset_cause = "power-on/brown-out" };
+    uint64_t t = 10 * SEC;
+    ui_setup_layout();
+    ui_start(&ui, t);
+    snapshot("prompt");
+
+    type(&ui, "12", t);
+    snapshot("entry");
+
+    // Senha errada: mensagem de erro e, na terceira, bloqueio com contagem
+    type(&ui, "34", t);
+    snapshot("error");
+    for (int i = 1; i < MAX_ATTEMPTS; ++i) {
+        t += ERROR_DISPLAY_MS * 1000ull;
+        ui_tick(&ui, t);
+        type(&ui, "0000", t);
+    }
+    t += ERROR_DISPLAY_MS * 1000ull;
+    ui_tick(&ui, t);
+    snapshot("lockout");
+    t += LOCKOUT_MS * 1000ull / 2 + SEC / 2;
+    ui_tick(&ui, t);
+    snapshot("lockout_countdown");
+
+    // Fim do bloqueio e senha certa
+    t += LOCKOUT_MS * 1000ull;
+    ui_tick(&ui, t);
+    type(&ui, "3333", t);
+    snapshot("success");
+
+    // Depois de um reset por watchdog, main() redesenha tudo do zero com os
+    // contadores novos na linha de status; nada da tela anterior pode sobrar
+    memset(charbuf, 'x', sizeof(charbuf));
+    memset(colourbuf, 0x5a, sizeof(colourbuf));
+    ui = (ui_t){ .watchdog_resets = 3, .reset_cause = "timeout do watchdog" };
+    ui_setup_layout();
+    ui_start(&ui, 0);
+    snapshot("watchdog_redraw");
+
+    return errors ? 1 : 0;
+}
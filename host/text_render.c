@@ -0,0 +1,44 @@
+#include "text_render.h"
+
+#include "font_8x8.h"
+
+static const uint8_t level_2bpp[4] = {0x00, 0x55, 0xaa, 0xff};
+
+static void render_line(uint8_t *rgb, const text_raster_t *r) {
+    const uint8_t *chars = (const uint8_t*)&charbuf[r->row * CHAR_COLS];
+    const uint8_t *font_line = (const uint8_t*)&font_8x8[r->font_row * FONT_N_CHARS];
+    // Com largura dupla cada pixel do glifo ocupa 2 pixels da tela
+    unsigned shift = r->attr & TEXT_ROW_HDOUBLE ? 1 : 0;
+    for (unsigned x = 0; x < TEXT_SCREEN_WIDTH; ++x) {
+        unsigned lx = x >> shift;
+        unsigned col = lx / FONT_CHAR_WIDTH;
+        uint8_t c = chars[col];
+        // Fora da fonte o codificador lê bytes vizinhos da tabela; charbuf
+        // só recebe glifos válidos, então aqui basta não sair dela
+        uint8_t bits = c >= FONT_FIRST_CHAR && c < FONT_FIRST_CHAR + FONT_N_CHARS ?
+            font_line[c - FONT_FIRST_CHAR] : 0;
+        bool fg = bits >> (lx % FONT_CHAR_WIDTH) & 1;
+        unsigned cell = r->row * CHAR_COLS + col;
+        uint8_t *px = &rgb[3 * x];
+        for (int plane = 0; plane < 3; ++plane) {
+            uint32_t pair = colourbuf[cell / 8 + plane * COLOUR_PLANE_SIZE_WORDS] >> (cell % 8 * 4);
+            // Plano 0 é o azul
+            px[2 - plane] = level_2bpp[(fg ? pair : pair >> 2) & 0x3];
+        }
+    }
+}
+
+void text_render_frame(uint8_t *rgb) {
+    text_raster_t r;
+    text_raster_start(&r);
+    for (unsigned y = 0; y < TEXT_SCREEN_HEIGHT; ++y) {
+        render_line(&rgb[y * TEXT_SCREEN_WIDTH * 3], &r);
+        text_raster_next(&r);
+    }
+}
+
+int text_render_write_ppm(FILE *f, const uint8_t *rgb) {
+    if (fprintf(f, "P6\n%d %d\n255\n", TEXT_SCREEN_WIDTH, TEXT_SCREEN_HEIGHT) < 0)
+        return -1;
+    return fwrite(rgb, 1, TEXT_RENDER_BYTES, f) == TEXT_RENDER_BYTES ? 0 : -1;
+}
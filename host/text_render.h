@@ -0,0 +1,25 @@
+#ifndef _TEXT_RENDER_H
+#define _TEXT_RENDER_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "text_screen.h"
+
+// Renderização de charbuf/colourbuf em RGB no host, para os testes de imagem
+// das telas da IHM. Percorre as linhas como o Core 1 (text_raster_t) e monta
+// cada pixel como tmds_encode_font_2bpp: bit x da linha do glifo escolhe a
+// cor de frente ou de fundo da célula, 2 bits por plano (azul, verde,
+// vermelho). Os níveis são os nominais 0x00/0x55/0xaa/0xff; o codificador
+// alterna pares de valores vizinhos (0x04/0x05, ...) só para equilibrar o
+// TMDS.
+
+#define TEXT_RENDER_BYTES (TEXT_SCREEN_WIDTH * TEXT_SCREEN_HEIGHT * 3)
+
+// rgb: TEXT_SCREEN_WIDTH x TEXT_SCREEN_HEIGHT pixels, 3 bytes cada
+void text_render_frame(uint8_t *rgb);
+
+// Grava a imagem como PPM binário (P6); retorna 0 se deu certo
+int text_render_write_ppm(FILE *f, const uint8_t *rgb);
+
+#endif
@@ -57,6 +57,16 @@ static const struct dvi_serialiser_cfg picodvi_dvi_cfg = {
     .pins_clk = 19,
 	.invert_diffpairs = true
 };
+
+// Segunda saída (painel remoto) junto com a de cima: outro PIO e outro slice
+// de PWM para o clock, com os pares na mesma disposição da placa de Wilton
+static const struct dvi_serialiser_cfg picodvi_dvi_cfg_remoto = {
+	.pio = pio1,
+	.sm_tmds = {0, 1, 2},
+    .pins_tmds = {10, 12, 14},
+    .pins_clk = 8,
+	.invert_diffpairs = true
+};
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
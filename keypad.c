@@ -0,0 +1,134 @@
+#include "pico/stdlib.h"
+#include "pico/util/queue.h"
+
+#include "keypad.h"
+
+static keypad_config_t kp_cfg;
+static repeating_timer_t kp_timer;
+static queue_t kp_events;
+
+// Estado da varredura (só o callback do timer escreve)
+static uint kp_row;
+static uint32_t kp_raw;             // última leitura de cada linha
+static volatile uint32_t kp_stable; // estado após debounce
+static uint8_t kp_count[KEYPAD_MAX_KEYS];
+static uint32_t kp_first_us[KEYPAD_MAX_KEYS];
+static volatile uint32_t kp_dropped;
+
+static inline uint32_t row_mask(uint row) {
+    return (uint32_t)((1ull << kp_cfg.n_cols) - 1) << (row * kp_cfg.n_cols);
+}
+
+static inline uint32_t row_bits(uint32_t keys, uint row) {
+    return (keys & row_mask(row)) >> (row * kp_cfg.n_cols);
+}
+
+// Cantos de retângulos em raw: duas linhas com duas ou mais colunas
+// pressionadas em comum. Qualquer um desses cantos pode ser fantasma.
+static uint32_t ambiguous_keys(uint32_t raw) {
+    uint32_t ambiguous = 0;
+    for (uint r = 0; r < kp_cfg.n_rows; ++r) {
+        for (uint r2 = 0; r2 < kp_cfg.n_rows; ++r2) {
+            uint32_t common = row_bits(raw, r) & row_bits(raw, r2);
+            if (r2 != r && (common & (common - 1)))
+                ambiguous |= common << (r * kp_cfg.n_cols);
+        }
+    }
+    return ambiguous;
+}
+
+static void debounce_row(uint row, uint32_t now_us) {
+    uint32_t ambiguous = kp_cfg.ghost_filter ? ambiguous_keys(kp_raw) : 0;
+    uint32_t stable = kp_stable;
+    for (uint col = 0; col < kp_cfg.n_cols; ++col) {
+        uint key = row * kp_cfg.n_cols + col;
+        uint32_t bit = 1u << key;
+        bool same = !((kp_raw ^ stable) & bit);
+        bool held_off = (ambiguous & bit) && !(stable & bit);
+        if (same || held_off) {
+            kp_count[key] = 0;
+            continue;
+        }
+        if (kp_count[key]++ == 0)
+            kp_first_us[key] = now_us;
+        if (kp_count[key] < kp_cfg.debounce_scans)
+            continue;
+        kp_count[key] = 0;
+        stable ^= bit;
+        keypad_event_t ev = {
+            .time_us = kp_first_us[key],
+            .row = row,
+            .col = col,
+            .pressed = !!(stable & bit),
+        };
+        if (!queue_try_add(&kp_events, &ev))
+            kp_dropped++;
+    }
+    kp_stable = stable;
+}
+
+static bool keypad_scan_cb(repeating_timer_t *t) {
+    uint32_t now_us = time_us_32();
+    uint row = kp_row;
+    uint32_t bits = 0;
+    for (uint col = 0; col < kp_cfg.n_cols; ++col) {
+        if (!gpio_get(kp_cfg.col_pins[col]))
+            bits |= 1u << col;
+    }
+    kp_raw = (kp_raw & ~row_mask(row)) | (bits << (row * kp_cfg.n_cols));
+
+    // Troca de linha já, para a próxima ter o período inteiro para estabilizar
+    gpio_put(kp_cfg.row_pins[row], 1);
+    kp_row = row + 1 == kp_cfg.n_rows ? 0 : row + 1;
+    gpio_put(kp_cfg.row_pins[kp_row], 0);
+
+    debounce_row(row, now_us);
+    return true;
+}
+
+bool keypad_init(const keypad_config_t *cfg) {
+    if (cfg->n_rows == 0 || cfg->n_cols == 0 || cfg->n_rows * cfg->n_cols > KEYPAD_MAX_KEYS)
+        return false;
+    kp_cfg = *cfg;
+    if (!kp_cfg.scan_period_us)
+        kp_cfg.scan_period_us = KEYPAD_DEFAULT_SCAN_PERIOD_US;
+    if (!kp_cfg.debounce_scans)
+        kp_cfg.debounce_scans = KEYPAD_DEFAULT_DEBOUNCE_SCANS;
+
+    for (uint i = 0; i < kp_cfg.n_rows; ++i) {
+        gpio_init(kp_cfg.row_pins[i]);
+        gpio_set_dir(kp_cfg.row_pins[i], GPIO_OUT);
+        gpio_put(kp_cfg.row_pins[i], i != 0);
+    }
+    for (uint i = 0; i < kp_cfg.n_cols; ++i) {
+        gpio_init(kp_cfg.col_pins[i]);
+        gpio_set_dir(kp_cfg.col_pins[i], GPIO_IN);
+        gpio_pull_up(kp_cfg.col_pins[i]);
+    }
+    kp_row = 0;
+    kp_raw = 0;
+    kp_stable = 0;
+    kp_dropped = 0;
+    for (uint i = 0; i < KEYPAD_MAX_KEYS; ++i)
+        kp_count[i] = 0;
+
+    queue_init(&kp_events, sizeof(keypad_event_t), KEYPAD_QUEUE_LEN);
+    // Período negativo: intervalo entre inícios de callback, sem deriva
+    return add_repeating_timer_us(-(int64_t)kp_cfg.scan_period_us, keypad_scan_cb, NULL, &kp_timer);
+}
+
+bool keypad_get_event(keypad_event_t *ev) {
+    return queue_try_remove(&kp_events, ev);
+}
+
+void keypad_wait_event(keypad_event_t *ev) {
+    queue_remove_blocking(&kp_events, ev);
+}
+
+uint32_t keypad_pressed_mask(void) {
+    return kp_stable;
+}
+
+uint32_t keypad_dropped_events(void) {
+    return kp_dropped;
+}
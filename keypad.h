@@ -0,0 +1,65 @@
+#ifndef _KEYPAD_H
+#define _KEYPAD_H
+
+#include "pico/types.h"
+
+// Varredura de teclado matricial por interrupção de timer, sem espera
+// ocupada.
+//
+// A cada tick (scan_period_us), o callback lê as colunas da linha que foi
+// posta em nível baixo no tick anterior (o pull-up teve um período inteiro
+// para estabilizar), solta essa linha e baixa a próxima. A matriz inteira é
+// lida a cada n_rows ticks. Cada tecla tem seu próprio debounce por
+// contagem: o estado só muda depois de debounce_scans leituras seguidas
+// diferentes do estado atual. Cada mudança vira um evento (pressionar ou
+// soltar) com o instante da primeira dessas leituras, numa fila que o laço
+// principal consome.
+//
+// As teclas são independentes (N-key rollover), até o limite físico de uma
+// matriz sem diodos: com três teclas pressionadas em "L", a quarta tecla do
+// retângulo também aparece pressionada (tecla fantasma). Com ghost_filter,
+// enquanto quatro teclas formam um retângulo na leitura, as que ainda não
+// estavam pressionadas não são registradas.
+
+#define KEYPAD_MAX_KEYS 32
+
+#ifndef KEYPAD_QUEUE_LEN
+#define KEYPAD_QUEUE_LEN 32
+#endif
+
+#define KEYPAD_DEFAULT_SCAN_PERIOD_US 250
+#define KEYPAD_DEFAULT_DEBOUNCE_SCANS 4
+
+typedef struct {
+    const uint8_t *row_pins;    // saídas, linha ativa em nível baixo
+    const uint8_t *col_pins;    // entradas com pull-up
+    uint8_t n_rows;
+    uint8_t n_cols;             // n_rows * n_cols <= KEYPAD_MAX_KEYS
+    uint32_t scan_period_us;    // por linha; a matriz leva n_rows vezes isso
+    uint8_t debounce_scans;
+    bool ghost_filter;
+} keypad_config_t;
+
+typedef struct {
+    uint32_t time_us;           // time_us_32() da primeira leitura no novo estado
+    uint8_t row;
+    uint8_t col;
+    bool pressed;
+} keypad_event_t;
+
+// Configura os pinos e inicia o timer (no núcleo que chamar). Retorna false
+// se a configuração for inválida ou não houver alarme livre.
+bool keypad_init(const keypad_config_t *cfg);
+
+// Próximo evento da fila: keypad_get_event() não bloqueia (retorna false se
+// a fila estiver vazia), keypad_wait_event() dorme até chegar um evento.
+bool keypad_get_event(keypad_event_t *ev);
+void keypad_wait_event(keypad_event_t *ev);
+
+// Teclas pressionadas agora (após debounce), bit row * n_cols + col
+uint32_t keypad_pressed_mask(void);
+
+// Eventos perdidos porque a fila estava cheia
+uint32_t keypad_dropped_events(void);
+
+#endif
@@ -0,0 +1,181 @@
+#include <string.h>
+
+#include "keypad_proto.h"
+
+uint16_t kp_crc16(const uint8_t *data, size_t len) {
+    uint16_t crc = 0xffff;
+    for (size_t i = 0; i < len; ++i) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int b = 0; b < 8; ++b)
+            crc = crc & 0x8000 ? (uint16_t)(crc << 1 ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+static inline void put16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void put32(uint8_t *p, uint32_t v) {
+    put16(p, (uint16_t)v);
+    put16(p + 2, (uint16_t)(v >> 16));
+}
+
+static inline uint16_t get16(const uint8_t *p) {
+    return (uint16_t)(p[0] | p[1] << 8);
+}
+
+static inline uint32_t get32(const uint8_t *p) {
+    return get16(p) | (uint32_t)get16(p + 2) << 16;
+}
+
+size_t kp_frame_encode(uint8_t *buf, uint8_t flags, uint16_t seq, uint32_t time_us,
+    const kp_event_t *events, unsigned n) {
+    buf[0] = KP_SOF;
+    buf[1] = (uint8_t)n;
+    buf[2] = flags;
+    put16(buf + 3, seq);
+    put32(buf + 5, time_us);
+    uint8_t *p = buf + KP_HEADER_BYTES;
+    for (unsigned i = 0; i < n; ++i, p += KP_EVENT_BYTES) {
+        uint32_t age = time_us - events[i].time_us;
+        p[0] = events[i].key;
+        p[1] = events[i].flags;
+        put16(p + 2, age > 0xffff ? 0xffff : (uint16_t)age);
+    }
+    put16(p, kp_crc16(buf + 1, (size_t)(p - buf - 1)));
+    return (size_t)(p - buf) + KP_CRC_BYTES;
+}
+
+void kp_sender_init(kp_sender_t *s) {
+    memset(s, 0, sizeof(*s));
+    s->flags = KP_FRAME_RESTART;
+}
+
+bool kp_sender_queue(kp_sender_t *s, uint8_t key, uint8_t flags, uint32_t time_us) {
+    if (s->n_pending >= KP_MAX_EVENTS)
+        return false;
+    s->pending[s->n_pending++] = (kp_event_t){
+        .key = key,
+        .flags = flags,
+        .time_us = time_us,
+    };
+    return true;
+}
+
+size_t kp_sender_build(kp_sender_t *s, uint8_t *buf, uint32_t time_us) {
+    if (!s->n_pending)
+        return 0;
+    size_t len = kp_frame_encode(buf, s->flags, s->seq, time_us, s->pending, s->n_pending);
+    s->seq += (uint16_t)s->n_pending;
+    s->n_pending = 0;
+    s->flags = 0;
+    return len;
+}
+
+// ----------------------------------------------------------------------------
+// Recepção
+
+void kp_decoder_init(kp_decoder_t *d) {
+    memset(d, 0, sizeof(*d));
+}
+
+// Descarta o 0xA5 do início do buffer e tudo até o próximo 0xA5
+static void kp_decoder_resync(kp_decoder_t *d) {
+    unsigned i = 1;
+    while (i < d->len && d->buf[i] != KP_SOF)
+        ++i;
+    d->skipped_bytes += i;
+    d->len -= i;
+    memmove(d->buf, d->buf + i, d->len);
+}
+
+static void kp_frame_decode(const uint8_t *buf, kp_frame_t *f) {
+    f->n_events = buf[1];
+    f->flags = buf[2];
+    f->seq = get16(buf + 3);
+    f->time_us = get32(buf + 5);
+    const uint8_t *p = buf + KP_HEADER_BYTES;
+    for (unsigned i = 0; i < f->n_events; ++i, p += KP_EVENT_BYTES) {
+        f->events[i].key = p[0];
+        f->events[i].flags = p[1];
+        f->events[i].time_us = f->time_us - get16(p + 2);
+    }
+}
+
+// Extrai o primeiro quadro válido do buffer, ressincronizando nos erros
+static bool kp_decoder_parse(kp_decoder_t *d, kp_frame_t *frame) {
+    while (d->len >= 2) {
+        unsigned n = d->buf[1];
+        if (n == 0 || n > KP_MAX_EVENTS) {
+            d->bad_lengths++;
+            kp_decoder_resync(d);
+            continue;
+        }
+        unsigned size = KP_FRAME_BYTES(n);
+        if (d->len < size)
+            return false;
+        unsigned body = size - 1 - KP_CRC_BYTES;
+        if (kp_crc16(d->buf + 1, body) != get16(d->buf + 1 + body)) {
+            d->crc_errors++;
+            kp_decoder_resync(d);
+            continue;
+        }
+        kp_frame_decode(d->buf, frame);
+        d->len -= size;
+        memmove(d->buf, d->buf + size, d->len);
+        return true;
+    }
+    return false;
+}
+
+bool kp_decoder_feed(kp_decoder_t *d, uint8_t byte, kp_frame_t *frame) {
+    if (d->len == 0 && byte != KP_SOF) {
+        d->skipped_bytes++;
+        return false;
+    }
+    d->buf[d->len++] = byte;
+    // Depois de uma ressincronização o buffer pode já ter um quadro inteiro
+    return kp_decoder_parse(d, frame);
+}
+
+bool kp_decoder_idle(kp_decoder_t *d, kp_frame_t *frame) {
+    // Um quadro que veio logo atrás de outro pode estar inteiro no buffer
+    if (kp_decoder_parse(d, frame))
+        return true;
+    if (!d->len)
+        return false;
+    d->timeouts++;
+    kp_decoder_resync(d);
+    return kp_decoder_parse(d, frame);
+}
+
+void kp_link_init(kp_link_t *l) {
+    memset(l, 0, sizeof(*l));
+}
+
+unsigned kp_link_accept(kp_link_t *l, const kp_frame_t *f) {
+    l->frames++;
+    int16_t delta = (int16_t)(f->seq - l->next_seq);
+    bool resync = !l->synced || (f->flags & KP_FRAME_RESTART) ||
+        delta > KP_LINK_RESYNC_DISTANCE || delta < -KP_LINK_RESYNC_DISTANCE;
+    unsigned skip = 0;
+    if (resync) {
+        if (l->synced)
+            l->restarts++;
+        l->synced = true;
+    }
+    else if (delta > 0) {
+        l->lost_events += (uint32_t)delta;
+    }
+    else if (delta < 0) {
+        skip = (unsigned)-delta < f->n_events ? (unsigned)-delta : f->n_events;
+        l->dup_events += skip;
+    }
+    uint16_t end = (uint16_t)(f->seq + f->n_events);
+    if (resync || (int16_t)(end - l->next_seq) > 0)
+        l->next_seq = end;
+    l->events += f->n_events - skip;
+    return skip;
+}
@@ -0,0 +1,130 @@
+#ifndef _KEYPAD_PROTO_H
+#define _KEYPAD_PROTO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Protocolo do enlace UART teclado -> receptor. Só C padrão, sem SDK, para
+// os dois lados (e testes no host) usarem o mesmo código.
+//
+// Quadro (inteiros little-endian):
+//
+//   0xA5 | n | flags | seq (2) | time_us (4) | n eventos (4 cada) | crc (2)
+//
+// - n: número de eventos, 1 a KP_MAX_EVENTS
+// - flags: KP_FRAME_RESTART no primeiro quadro após o boot do emissor
+// - seq: número de sequência do primeiro evento; os eventos são numerados
+//   em sequência, então o próximo quadro começa em seq + n. O receptor sabe
+//   exatamente quantos eventos se perderam ou chegaram repetidos.
+// - time_us: relógio do emissor (time_us_32) ao montar o quadro
+// - evento: tecla (ASCII), flags (KP_EVENT_PRESSED) e idade em us (quanto
+//   antes de time_us o evento ocorreu, saturada em 0xffff)
+// - crc: CRC-16/CCITT-FALSE de n até o fim dos eventos
+//
+// O receptor procura 0xA5, confere n e o CRC, e em caso de erro volta a
+// procurar a partir do byte seguinte ao 0xA5 descartado. Um n corrompido
+// para um valor maior (mas válido) faria o receptor esperar bytes que não
+// fazem parte do quadro; se a linha ficar parada com um quadro incompleto,
+// kp_decoder_idle o descarta da mesma forma.
+
+#define KP_SOF 0xa5
+#define KP_MAX_EVENTS 8
+#define KP_HEADER_BYTES 9
+#define KP_EVENT_BYTES 4
+#define KP_CRC_BYTES 2
+#define KP_FRAME_BYTES(n) (KP_HEADER_BYTES + (n) * KP_EVENT_BYTES + KP_CRC_BYTES)
+#define KP_FRAME_MAX_BYTES KP_FRAME_BYTES(KP_MAX_EVENTS)
+
+#define KP_FRAME_RESTART 0x01u
+#define KP_EVENT_PRESSED 0x01u
+
+typedef struct {
+    uint8_t key;
+    uint8_t flags;
+    uint32_t time_us;   // relógio do emissor
+} kp_event_t;
+
+typedef struct {
+    uint8_t flags;
+    uint16_t seq;
+    uint32_t time_us;
+    uint8_t n_events;
+    kp_event_t events[KP_MAX_EVENTS];
+} kp_frame_t;
+
+uint16_t kp_crc16(const uint8_t *data, size_t len);
+
+// Monta um quadro com n (1 a KP_MAX_EVENTS) eventos em buf, que deve ter
+// KP_FRAME_BYTES(n) bytes. Retorna o tamanho do quadro.
+size_t kp_frame_encode(uint8_t *buf, uint8_t flags, uint16_t seq, uint32_t time_us,
+    const kp_event_t *events, unsigned n);
+
+// Emissor: acumula eventos e monta os quadros, numerando os eventos e
+// marcando o primeiro quadro com KP_FRAME_RESTART. Quando montar o quadro
+// (UART livre) fica a cargo de quem chama.
+typedef struct {
+    kp_event_t pending[KP_MAX_EVENTS];
+    unsigned n_pending;
+    uint16_t seq;
+    uint8_t flags;
+} kp_sender_t;
+
+void kp_sender_init(kp_sender_t *s);
+
+// Acumula um evento para o próximo quadro. Retorna false se já houver
+// KP_MAX_EVENTS eventos pendentes.
+bool kp_sender_queue(kp_sender_t *s, uint8_t key, uint8_t flags, uint32_t time_us);
+
+// Monta em buf (KP_FRAME_MAX_BYTES) um quadro com os eventos pendentes, com
+// time_us como instante do quadro. Retorna o tamanho, ou 0 se não havia
+// eventos.
+size_t kp_sender_build(kp_sender_t *s, uint8_t *buf, uint32_t time_us);
+
+// ----------------------------------------------------------------------------
+// Recepção
+
+typedef struct {
+    uint8_t buf[KP_FRAME_MAX_BYTES];
+    unsigned len;
+    uint32_t crc_errors;
+    uint32_t bad_lengths;
+    uint32_t skipped_bytes;     // bytes fora de quadros válidos
+    uint32_t timeouts;          // quadros incompletos descartados por kp_decoder_idle
+} kp_decoder_t;
+
+void kp_decoder_init(kp_decoder_t *d);
+
+// Alimenta um byte recebido. Retorna true quando completou um quadro válido,
+// que é copiado para *frame (time_us dos eventos já em relógio do emissor).
+bool kp_decoder_feed(kp_decoder_t *d, uint8_t byte, kp_frame_t *frame);
+
+// Chamar quando a linha ficar parada (cerca de um quadro sem bytes) com
+// bytes no buffer. Entrega um quadro completo que ainda esteja no buffer ou
+// descarta o quadro incompleto e volta a procurar no que sobrou, como num
+// erro de CRC. Retorna true com um quadro em *frame; chamar de novo enquanto
+// retornar true ou ainda houver bytes no buffer.
+bool kp_decoder_idle(kp_decoder_t *d, kp_frame_t *frame);
+
+// Acompanhamento da sequência de eventos
+typedef struct {
+    bool synced;
+    uint16_t next_seq;
+    uint32_t frames;
+    uint32_t events;            // eventos novos entregues
+    uint32_t lost_events;
+    uint32_t dup_events;
+    uint32_t restarts;          // ressincronizações (boot do emissor)
+} kp_link_t;
+
+// Diferença de sequência acima da qual o receptor assume que o emissor
+// reiniciou e perdeu o quadro com KP_FRAME_RESTART
+#define KP_LINK_RESYNC_DISTANCE 0x1000
+
+void kp_link_init(kp_link_t *l);
+
+// Registra um quadro recebido e retorna quantos eventos do início dele já
+// tinham sido entregues (e devem ser ignorados).
+unsigned kp_link_accept(kp_link_t *l, const kp_frame_t *f);
+
+#endif
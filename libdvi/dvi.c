@@ -13,7 +13,7 @@
 #define __dvi_func_x(f) __scratch_x(__STRING(f)) f
 
 // We require exclusive use of a DMA IRQ line. (you wouldn't want to share
-// anyway). It's possible in theory to hook both IRQs and have two DVI outs.
+// anyway). Hooking both IRQs gives two DVI outs, one instance on each.
 static struct dvi_inst *dma_irq_privdata[2];
 static void dvi_dma0_irq();
 static void dvi_dma1_irq();
@@ -28,6 +28,8 @@ void dvi_init(struct dvi_inst *inst, uint spinlock_tmds_queue, uint spinlock_col
 		inst->dma_cfg[i].dreq = pio_get_dreq(inst->ser_cfg.pio, inst->ser_cfg.sm_tmds[i], true);
 	}
 	inst->late_scanline_ctr = 0;
+	inst->frame_ctr = 0;
+	inst->mirror = NULL;
 	inst->tmds_buf_release_next = NULL;
 	inst->tmds_buf_release = NULL;
 	queue_init_with_spinlock(&inst->q_tmds_valid,   sizeof(void*),  8, spinlock_tmds_queue);
@@ -61,13 +63,14 @@ void dvi_register_irqs_this_core(struct dvi_inst *inst, uint irq_num) {
 	for (int i = 0; i < N_TMDS_LANES; ++i)
 		mask_all_channels |= 1u << inst->dma_cfg[i].chan_ctrl | 1u << inst->dma_cfg[i].chan_data;
 
-	dma_hw->ints0 = mask_sync_channel;
 	if (irq_num == DMA_IRQ_0) {
+		dma_hw->ints0 = mask_sync_channel;
 		hw_write_masked(&dma_hw->inte0, mask_sync_channel, mask_all_channels);
 		dma_irq_privdata[0] = inst;
 		irq_set_exclusive_handler(DMA_IRQ_0, dvi_dma0_irq);
 	}
 	else {
+		dma_hw->ints1 = mask_sync_channel;
 		hw_write_masked(&dma_hw->inte1, mask_sync_channel, mask_all_channels);
 		dma_irq_privdata[1] = inst;
 		irq_set_exclusive_handler(DMA_IRQ_1, dvi_dma1_irq);
@@ -75,6 +78,67 @@ void dvi_register_irqs_this_core(struct dvi_inst *inst, uint irq_num) {
 	irq_set_enabled(irq_num, true);
 }
 
+void dvi_mirror_init(struct dvi_inst *inst, struct dvi_inst *mirror) {
+	if (inst == mirror || inst->timing != mirror->timing)
+		panic("DVI mirror needs a second instance with the same timing");
+	// The mirror's buffers are never used; the first instance's are shared
+	uint32_t *tmdsbuf;
+	while (queue_try_remove_u32(&mirror->q_tmds_free, &tmdsbuf))
+		free(tmdsbuf);
+	for (int i = 0; i < DVI_N_TMDS_BUFFERS; ++i)
+		queue_remove_blocking_u32(&inst->q_tmds_free, &inst->mirror_bufs[i]);
+	inst->mirror_free[0] = inst->mirror_free[1] = (1u << DVI_N_TMDS_BUFFERS) - 1;
+	inst->mirror = mirror;
+}
+
+static inline void __dvi_func_x(_dvi_mirror_mark_free)(struct dvi_inst *inst, uint side, uint32_t *tmdsbuf) {
+	for (int i = 0; i < DVI_N_TMDS_BUFFERS; ++i) {
+		if (inst->mirror_bufs[i] == tmdsbuf) {
+			inst->mirror_free[side] |= 1u << i;
+			return;
+		}
+	}
+	panic("Unknown TMDS buffer in mirror free queue");
+}
+
+// The two outputs run at the same rate but not in phase, and each one drops
+// late scanlines on its own, so they can hand buffers back in different
+// orders. A buffer is free once it is back from both.
+uint32_t *__dvi_func(dvi_get_tmds_free)(struct dvi_inst *inst) {
+	uint32_t *tmdsbuf;
+	if (!inst->mirror) {
+		queue_remove_blocking_u32(&inst->q_tmds_free, &tmdsbuf);
+		return tmdsbuf;
+	}
+	while (true) {
+		uint32_t both = inst->mirror_free[0] & inst->mirror_free[1];
+		if (both) {
+			uint i = __builtin_ctz(both);
+			inst->mirror_free[0] &= ~(1u << i);
+			inst->mirror_free[1] &= ~(1u << i);
+			return inst->mirror_bufs[i];
+		}
+		bool got = false;
+		while (queue_try_remove_u32(&inst->q_tmds_free, &tmdsbuf)) {
+			_dvi_mirror_mark_free(inst, 0, tmdsbuf);
+			got = true;
+		}
+		while (queue_try_remove_u32(&inst->mirror->q_tmds_free, &tmdsbuf)) {
+			_dvi_mirror_mark_free(inst, 1, tmdsbuf);
+			got = true;
+		}
+		// Queue adds signal an event, so this can't sleep through a release
+		if (!got)
+			__wfe();
+	}
+}
+
+void __dvi_func(dvi_put_tmds_valid)(struct dvi_inst *inst, uint32_t *tmdsbuf) {
+	queue_add_blocking_u32(&inst->q_tmds_valid, &tmdsbuf);
+	if (inst->mirror)
+		queue_add_blocking_u32(&inst->mirror->q_tmds_valid, &tmdsbuf);
+}
+
 // Set up control channels to make transfers to data channels' control
 // registers (but don't trigger the control channels -- this is done either by
 // data channel CHAIN_TO or an initial write to MULTI_CHAN_TRIGGER)
@@ -115,26 +179,24 @@ void dvi_start(struct dvi_inst *inst) {
 }
 
 static inline void __dvi_func_x(_dvi_prepare_scanline_8bpp)(struct dvi_inst *inst, uint32_t *scanbuf) {
-	uint32_t *tmdsbuf;
-	queue_remove_blocking_u32(&inst->q_tmds_free, &tmdsbuf);
+	uint32_t *tmdsbuf = dvi_get_tmds_free(inst);
 	uint pixwidth = inst->timing->h_active_pixels;
 	uint words_per_channel = pixwidth / DVI_SYMBOLS_PER_WORD;
 	// Scanline buffers are half-resolution; the functions take the number of *input* pixels as parameter.
 	tmds_encode_data_channel_8bpp(scanbuf, tmdsbuf + 0 * words_per_channel, pixwidth / 2, DVI_8BPP_BLUE_MSB,  DVI_8BPP_BLUE_LSB );
 	tmds_encode_data_channel_8bpp(scanbuf, tmdsbuf + 1 * words_per_channel, pixwidth / 2, DVI_8BPP_GREEN_MSB, DVI_8BPP_GREEN_LSB);
 	tmds_encode_data_channel_8bpp(scanbuf, tmdsbuf + 2 * words_per_channel, pixwidth / 2, DVI_8BPP_RED_MSB,   DVI_8BPP_RED_LSB  );
-	queue_add_blocking_u32(&inst->q_tmds_valid, &tmdsbuf);
+	dvi_put_tmds_valid(inst, tmdsbuf);
 }
 
 static inline void __dvi_func_x(_dvi_prepare_scanline_16bpp)(struct dvi_inst *inst, uint32_t *scanbuf) {
-	uint32_t *tmdsbuf;
-	queue_remove_blocking_u32(&inst->q_tmds_free, &tmdsbuf);
+	uint32_t *tmdsbuf = dvi_get_tmds_free(inst);
 	uint pixwidth = inst->timing->h_active_pixels;
 	uint words_per_channel = pixwidth / DVI_SYMBOLS_PER_WORD;
 	tmds_encode_data_channel_16bpp(scanbuf, tmdsbuf + 0 * words_per_channel, pixwidth / 2, DVI_16BPP_BLUE_MSB,  DVI_16BPP_BLUE_LSB );
 	tmds_encode_data_channel_16bpp(scanbuf, tmdsbuf + 1 * words_per_channel, pixwidth / 2, DVI_16BPP_GREEN_MSB, DVI_16BPP_GREEN_LSB);
 	tmds_encode_data_channel_16bpp(scanbuf, tmdsbuf + 2 * words_per_channel, pixwidth / 2, DVI_16BPP_RED_MSB,   DVI_16BPP_RED_LSB  );
-	queue_add_blocking_u32(&inst->q_tmds_valid, &tmdsbuf);
+	dvi_put_tmds_valid(inst, tmdsbuf);
 }
 
 // "Worker threads" for TMDS encoding (core enters and never returns, but still handles IRQs)
@@ -233,6 +295,18 @@ static void __dvi_func(dvi_dma_irq_handler)(struct dvi_inst *inst) {
 			_dvi_load_dma_op(inst->dma_cfg, &inst->dma_list_vblank_nosync);
 			break;
 	}
+
+	// Frame boundaries, after the DMA for the next line is already set up
+	if (inst->timing_state.v_ctr == 0) {
+		if (inst->timing_state.v_state == DVI_STATE_FRONT_PORCH) {
+			++inst->frame_ctr;
+			if (inst->vblank_callback)
+				inst->vblank_callback();
+		}
+		else if (inst->timing_state.v_state == DVI_STATE_ACTIVE && inst->frame_callback) {
+			inst->frame_callback();
+		}
+	}
 }
 
 static void __dvi_func(dvi_dma0_irq)() {
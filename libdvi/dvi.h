@@ -21,6 +21,13 @@ struct dvi_inst {
 	struct dvi_serialiser_cfg ser_cfg;
 	// Called in the DMA IRQ once per scanline -- careful with the run time!
 	dvi_callback_t scanline_callback;
+	// Called in the DMA IRQ once per frame: vblank_callback as the last
+	// active line goes out (the next line set up is the first of the front
+	// porch), frame_callback as the last back porch line goes out (the next
+	// is the first active line). Same care with the run time; longer
+	// per-frame work can go through dvi_vblank.h.
+	dvi_callback_t vblank_callback;
+	dvi_callback_t frame_callback;
 
 	// State ---
 	struct dvi_scanline_dma_list dma_list_vblank_sync;
@@ -37,6 +44,16 @@ struct dvi_inst {
 	// Remember how far behind the source is on TMDS scanlines, so we can output
 	// solid colour until they catch up (rather than dying spectacularly)
 	uint late_scanline_ctr;
+	// Number of vertical blanking periods started, bumped just before
+	// vblank_callback
+	volatile uint32_t frame_ctr;
+
+	// Mirrored output (dvi_mirror_init): the instance whose scanlines are also
+	// shown here, the shared TMDS buffers, and a bitmap per output of the
+	// buffers it has handed back. Only touched by the encoding side.
+	struct dvi_inst *mirror;
+	uint32_t *mirror_bufs[DVI_N_TMDS_BUFFERS];
+	uint32_t mirror_free[2];
 
 	// Encoded scanlines:
 	queue_t q_tmds_valid;
@@ -55,6 +72,39 @@ void dvi_init(struct dvi_inst *inst, uint spinlock_tmds_queue, uint spinlock_col
 // whichever core called this function. Registers an exclusive IRQ handler.
 void dvi_register_irqs_this_core(struct dvi_inst *inst, uint irq_num);
 
+// Two outputs: each instance needs its own PIO (or three free state machines
+// and a different prog_offs), its own clock PWM slice and its own DMA IRQ
+// line, and the two together claim all 12 DMA channels. The instances can
+// have independent content, each with its own encoding loop, or the second
+// can mirror the first: after dvi_init() on both, call this before either is
+// started. Both must use the same timing. Every TMDS scanline handed to
+// `inst` through dvi_get_tmds_free()/dvi_put_tmds_valid() is then scanned
+// out by both, encoded once; a buffer is only reused once both outputs are
+// done with it. The mirror's own queues and buffers are not used after this.
+//
+// The outputs are not phase locked, so the later one holds each buffer for
+// as long as it lags the earlier one. One output needs 3 TMDS buffers (being
+// encoded, being scanned out, waiting for release); each further buffer
+// absorbs up to one line of offset between the outputs without taking
+// encode time away, so the tolerated offset is DVI_N_TMDS_BUFFERS - 3 lines.
+// A larger offset shows up as late (solid red) lines on both outputs every
+// frame. Calling dvi_start() on both back to back, on the same core, keeps
+// the offset under one line, and it stays constant after that; raise
+// DVI_N_TMDS_BUFFERS to at least 4 (hdmi.c uses 5).
+//
+// The mirror's DMA IRQ must also be serviced within a line. If it is routed
+// to a core that runs other interrupts (USB stdio, timers), give it the
+// highest priority with irq_set_priority(irq_num, 0) after
+// dvi_register_irqs_this_core(), since at the default priority it can wait
+// behind them for longer than a line.
+void dvi_mirror_init(struct dvi_inst *inst, struct dvi_inst *mirror);
+
+// Encoding side of the TMDS queues: take a free buffer and pass an encoded
+// one to the IRQ. Same as the plain queue operations unless `inst` has a
+// mirror, so encoding loops should always use these.
+uint32_t *dvi_get_tmds_free(struct dvi_inst *inst);
+void dvi_put_tmds_valid(struct dvi_inst *inst, uint32_t *tmdsbuf);
+
 // Start actually wiggling TMDS pairs. Call this once you have initialised the
 // DVI, have registered the IRQs, and are producing rendered scanlines.
 void dvi_start(struct dvi_inst *inst);
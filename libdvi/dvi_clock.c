@@ -0,0 +1,62 @@
+#include "dvi_clock.h"
+#include "pico/platform.h"
+
+// Voltage for clocks above each threshold. The RP2040 is rated for 133 MHz
+// at the default 1.10 V; 252 MHz (640x480) is run at 1.20 V here and in the
+// apps, and the 372/400 MHz modes need 1.30 V on most chips.
+static const struct {
+	uint32_t above_khz;
+	uint16_t mv;
+} vreg_steps[] = {
+	{320000, 1300},
+	{266000, 1250},
+	{200000, 1200},
+	{133000, 1150},
+};
+
+static uint16_t vreg_mv_for_khz(uint32_t khz) {
+	for (uint i = 0; i < count_of(vreg_steps); ++i) {
+		if (khz > vreg_steps[i].above_khz)
+			return vreg_steps[i].mv;
+	}
+	return 1100;
+}
+
+bool dvi_clock_plan(const struct dvi_timing *t, dvi_clock_plan_t *plan) {
+	uint32_t target = t->bit_clk_khz;
+	uint32_t best_err = UINT32_MAX;
+	for (uint fbdiv = DVI_CLOCK_FBDIV_MAX; fbdiv >= DVI_CLOCK_FBDIV_MIN; --fbdiv) {
+		uint32_t vco = fbdiv * DVI_CLOCK_XOSC_KHZ;
+		if (vco < DVI_CLOCK_VCO_MIN_KHZ || vco > DVI_CLOCK_VCO_MAX_KHZ)
+			continue;
+		for (uint pd1 = DVI_CLOCK_POSTDIV_MAX; pd1 >= 1; --pd1) {
+			for (uint pd2 = pd1; pd2 >= 1; --pd2) {
+				// The output is only exact if the VCO divides evenly
+				if (vco % (pd1 * pd2))
+					continue;
+				uint32_t out = vco / (pd1 * pd2);
+				uint32_t err = out > target ? out - target : target - out;
+				if (err < best_err) {
+					best_err = err;
+					plan->sys_khz = out;
+					plan->vco_khz = vco;
+					plan->fbdiv = (uint16_t)fbdiv;
+					plan->postdiv1 = (uint8_t)pd1;
+					plan->postdiv2 = (uint8_t)pd2;
+				}
+			}
+		}
+	}
+	if (best_err == UINT32_MAX || (uint64_t)best_err * 100 > target)
+		return false;
+
+	uint32_t h_total = dvi_timing_h_total(t);
+	uint32_t v_total = dvi_timing_v_total(t);
+	plan->error_ppm = (int32_t)(((int64_t)plan->sys_khz - target) * 1000000 / target);
+	// Pixel clock is sys_khz / 10, in kHz: mHz = sys_khz * 1000 * 1000 / 10 / pixels
+	plan->refresh_mhz = (uint32_t)((uint64_t)plan->sys_khz * 100000 / (h_total * v_total));
+	plan->line_cycles = h_total * 10;
+	plan->vreg_mv = vreg_mv_for_khz(plan->sys_khz);
+	plan->risky = plan->sys_khz > DVI_CLOCK_RISKY_KHZ;
+	return true;
+}
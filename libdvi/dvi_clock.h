@@ -0,0 +1,58 @@
+#ifndef _DVI_CLOCK_H
+#define _DVI_CLOCK_H
+
+#include "pico/types.h"
+
+#include "dvi.h"
+
+// Clock plan for running the system clock at a timing's TMDS bit clock (one
+// bit per system clock cycle, so 10 cycles per pixel): PLL settings from the
+// 12 MHz crystal, the refresh rate they actually give, and the core voltage
+// to ask for. Pure arithmetic, so it also runs on the host (host/clock_plan
+// prints the plan for every timing).
+//
+// The PLL search is the same as the SDK's check_sys_clock_khz(): highest VCO
+// first (less jitter), then the largest postdividers. When no setting hits
+// bit_clk_khz exactly, the nearest one is returned and error_ppm says how far
+// off it is.
+
+#define DVI_CLOCK_XOSC_KHZ 12000
+#define DVI_CLOCK_VCO_MIN_KHZ 750000
+#define DVI_CLOCK_VCO_MAX_KHZ 1600000
+#define DVI_CLOCK_FBDIV_MIN 16
+#define DVI_CLOCK_FBDIV_MAX 320
+#define DVI_CLOCK_POSTDIV_MAX 7
+
+// Above this even 1.30 V (the highest the regulator allows without unlocking
+// it) needs a lucky chip, see dvi_timing_1600x900p_reduced_30hz
+#define DVI_CLOCK_RISKY_KHZ 420000
+
+typedef struct dvi_clock_plan {
+	uint32_t sys_khz;
+	uint32_t vco_khz;
+	uint16_t fbdiv;
+	uint8_t postdiv1;
+	uint8_t postdiv2;
+	int32_t error_ppm;
+	// Frame rate in millihertz
+	uint32_t refresh_mhz;
+	// System clock cycles per scanline (including blanking), i.e. the time
+	// one core has to encode a line when the encode runs one line ahead
+	uint32_t line_cycles;
+	// Core voltage in mV, a vreg_voltage step (1100 to 1300 in 50 mV steps)
+	uint16_t vreg_mv;
+	bool risky;
+} dvi_clock_plan_t;
+
+// Returns false if no PLL setting is within 1% of the bit clock
+bool dvi_clock_plan(const struct dvi_timing *t, dvi_clock_plan_t *plan);
+
+static inline uint dvi_timing_h_total(const struct dvi_timing *t) {
+	return t->h_front_porch + t->h_sync_width + t->h_back_porch + t->h_active_pixels;
+}
+
+static inline uint dvi_timing_v_total(const struct dvi_timing *t) {
+	return t->v_front_porch + t->v_sync_width + t->v_back_porch + t->v_active_lines;
+}
+
+#endif
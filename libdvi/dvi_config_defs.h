@@ -133,9 +133,11 @@
 #define TMDS_ENCODE_UNROLL 1
 #endif
 
-// If 1, don't save/restore the interpolators on full-resolution TMDS encode.
-// Speed hack. The TMDS code uses both interpolators, for each of the 3 data
-// channels, so this define avoids 6 save/restores per scanline.
+// No longer has any effect, kept so existing configs still build. The TMDS
+// encoders used to save/restore both interpolators on every channel call (6
+// save/restores per scanline) unless this was 1; they now claim the
+// interpolators through util_interp_owner.h, which only saves state when
+// the owner on a core changes, and only for owners that ask for it.
 #ifndef TMDS_FULLRES_NO_INTERP_SAVE
 #define TMDS_FULLRES_NO_INTERP_SAVE 0
 #endif
@@ -45,7 +45,8 @@ typedef struct dma_cb {
 	dma_channel_config c;
 } dma_cb_t;
 
-static_assert(sizeof(dma_cb_t) == 4 * sizeof(uint32_t), "bad dma layout");
+// (sizeof(void*) is 4 on the RP2040, and 8 in the host build in host/)
+static_assert(sizeof(dma_cb_t) == 2 * sizeof(void*) + 2 * sizeof(uint32_t), "bad dma layout");
 static_assert(__builtin_offsetof(dma_cb_t, c.ctrl) == __builtin_offsetof(dma_channel_hw_t, ctrl_trig), "bad dma layout");
 
 #define DVI_SYNC_LANE_CHUNKS DVI_STATE_COUNT
@@ -81,6 +82,7 @@ extern const struct dvi_timing dvi_timing_1280x720p_30hz;
 
 extern const struct dvi_timing dvi_timing_800x600p_reduced_60hz;
 extern const struct dvi_timing dvi_timing_1280x720p_reduced_30hz;
+extern const struct dvi_timing dvi_timing_1600x900p_reduced_30hz;
 
 void dvi_timing_state_init(struct dvi_timing_state *t);
 
@@ -0,0 +1,115 @@
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+
+#include "dvi_vblank.h"
+
+// One scheduler per user IRQ per core: user IRQs are claimed per core, so
+// schedulers on the two cores usually get the same IRQ number
+static dvi_vblank_t *vblank_privdata[NUM_CORES][NUM_USER_IRQS];
+// The vblank callback has no argument; as with the DMA IRQs, each
+// instance's callback is tied to one scheduler. Up to two DVI instances.
+static dvi_vblank_t *vblank_for_callback[2];
+
+static void __not_in_flash_func(dvi_vblank_pend)(dvi_vblank_t *vb) {
+	if (vb->busy) {
+		++vb->missed;
+		return;
+	}
+	vb->busy = true;
+	irq_set_pending(vb->irq_num);
+}
+
+static void __not_in_flash_func(dvi_vblank_cb0)(void) {
+	dvi_vblank_pend(vblank_for_callback[0]);
+}
+
+static void __not_in_flash_func(dvi_vblank_cb1)(void) {
+	dvi_vblank_pend(vblank_for_callback[1]);
+}
+
+static void __not_in_flash_func(dvi_vblank_pass)(dvi_vblank_t *vb) {
+	uint32_t t_start = time_us_32();
+	// Pick the due jobs under the lock, run them without it
+	dvi_vblank_job_t *due[DVI_VBLANK_MAX_JOBS];
+	uint n_due = 0;
+	uint32_t save = spin_lock_blocking(vb->lock);
+	for (dvi_vblank_job_t **link = &vb->jobs; *link; ) {
+		dvi_vblank_job_t *job = *link;
+		if (job->countdown > 1) {
+			--job->countdown;
+		}
+		else if (n_due < DVI_VBLANK_MAX_JOBS) {
+			due[n_due++] = job;
+			job->countdown = job->period;
+			// One-shot jobs leave the list now
+			if (!job->period) {
+				*link = job->next;
+				continue;
+			}
+		}
+		link = &job->next;
+	}
+	spin_unlock(vb->lock, save);
+
+	for (uint i = 0; i < n_due; ++i) {
+		uint32_t t0 = time_us_32();
+		due[i]->fn(due[i]->arg);
+		uint32_t t = time_us_32() - t0;
+		if (t > due[i]->max_us)
+			due[i]->max_us = t;
+	}
+
+	uint32_t t = time_us_32() - t_start;
+	if (t > vb->max_pass_us)
+		vb->max_pass_us = t;
+	if (vb->inst->timing_state.v_state == DVI_STATE_ACTIVE)
+		++vb->overruns;
+	++vb->passes;
+	vb->busy = false;
+}
+
+static void __not_in_flash_func(dvi_vblank_irq)(void) {
+	dvi_vblank_pass(vblank_privdata[get_core_num()][__get_current_exception() - VTABLE_FIRST_IRQ - FIRST_USER_IRQ]);
+}
+
+void dvi_vblank_init(dvi_vblank_t *vb, struct dvi_inst *inst, uint spinlock_num) {
+	*vb = (dvi_vblank_t){.inst = inst, .lock = spin_lock_init(spinlock_num)};
+	vb->irq_num = (uint)user_irq_claim_unused(true);
+	vblank_privdata[get_core_num()][vb->irq_num - FIRST_USER_IRQ] = vb;
+	irq_set_exclusive_handler(vb->irq_num, dvi_vblank_irq);
+	// Below the DMA IRQ, which must keep setting up the blanking lines
+	irq_set_priority(vb->irq_num, PICO_LOWEST_IRQ_PRIORITY);
+	irq_set_enabled(vb->irq_num, true);
+
+	uint slot = 0;
+	while (slot < count_of(vblank_for_callback) && vblank_for_callback[slot] &&
+		vblank_for_callback[slot]->inst != inst)
+		++slot;
+	if (slot == count_of(vblank_for_callback))
+		panic("dvi_vblank: only two DVI instances");
+	vblank_for_callback[slot] = vb;
+	inst->vblank_callback = slot ? dvi_vblank_cb1 : dvi_vblank_cb0;
+}
+
+void dvi_vblank_add(dvi_vblank_t *vb, dvi_vblank_job_t *job) {
+	job->next = NULL;
+	job->countdown = 0;
+	uint32_t save = spin_lock_blocking(vb->lock);
+	dvi_vblank_job_t **link = &vb->jobs;
+	while (*link)
+		link = &(*link)->next;
+	*link = job;
+	spin_unlock(vb->lock, save);
+}
+
+void dvi_vblank_remove(dvi_vblank_t *vb, dvi_vblank_job_t *job) {
+	uint32_t save = spin_lock_blocking(vb->lock);
+	for (dvi_vblank_job_t **link = &vb->jobs; *link; link = &(*link)->next) {
+		if (*link == job) {
+			*link = job->next;
+			break;
+		}
+	}
+	spin_unlock(vb->lock, save);
+}
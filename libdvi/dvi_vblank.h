@@ -0,0 +1,65 @@
+#ifndef _DVI_VBLANK_H
+#define _DVI_VBLANK_H
+
+#include "pico/types.h"
+#include "hardware/sync.h"
+
+#include "dvi.h"
+
+// Frame-synchronous jobs: per-frame work that must land between two frames
+// (buffer swaps, palette or table updates, committing a UI frame) runs
+// during vertical blanking, so it has a fixed slot and never competes with
+// the encode of active lines.
+//
+// dvi_vblank_init() takes over the instance's vblank_callback. At vblank
+// start the DMA IRQ only pends a user IRQ on the same core, at the lowest
+// priority, and the jobs run from that. The DMA IRQ still preempts them for
+// every blanking line, so a pass can use the whole blanking period (45 lines,
+// about 1.4 ms at 640x480) without disturbing the signal. A pass still
+// running when the first active line is set up counts as an overrun.
+//
+// Jobs run in the order they were added. period is in frames: 1 runs every
+// frame, n every nth frame, and 0 runs once on the next vblank and then
+// drops out. Jobs can be added and removed from either core (and from a job),
+// but a job removed while a pass is in progress may still run in that pass.
+
+#ifndef DVI_VBLANK_MAX_JOBS
+#define DVI_VBLANK_MAX_JOBS 8
+#endif
+
+typedef void (*dvi_vblank_fn_t)(void *arg);
+
+typedef struct dvi_vblank_job {
+	dvi_vblank_fn_t fn;
+	void *arg;
+	uint16_t period;
+	uint16_t countdown;
+	// Longest run so far, in microseconds
+	uint32_t max_us;
+	struct dvi_vblank_job *next;
+} dvi_vblank_job_t;
+
+#define DVI_VBLANK_JOB_INIT(job_fn, job_arg, job_period) {.fn = (job_fn), .arg = (job_arg), .period = (job_period)}
+
+typedef struct dvi_vblank {
+	struct dvi_inst *inst;
+	spin_lock_t *lock;
+	uint irq_num;
+	dvi_vblank_job_t *jobs;
+	// Statistics, written only by the pass
+	uint32_t passes;
+	uint32_t overruns;
+	// vblanks that came while the previous pass had not finished
+	uint32_t missed;
+	uint32_t max_pass_us;
+	volatile bool busy;
+} dvi_vblank_t;
+
+// Call on the core that handles the instance's DMA IRQ, after
+// dvi_register_irqs_this_core(). Claims one of the user IRQs of that core.
+void dvi_vblank_init(dvi_vblank_t *vb, struct dvi_inst *inst, uint spinlock_num);
+
+void dvi_vblank_add(dvi_vblank_t *vb, dvi_vblank_job_t *job);
+void dvi_vblank_remove(dvi_vblank_t *vb, dvi_vblank_job_t *job);
+
+#endif
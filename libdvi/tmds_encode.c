@@ -1,8 +1,13 @@
 #include "hardware/interp.h"
 #include "tmds_encode.h"
+#include "util_interp_owner.h"
 #include "hardware/gpio.h"
 #include "hardware/sync.h"
 
+// The encoders reconfigure the interpolators on every call, so they never
+// need their own state preserved (see util_interp_owner.h)
+static interp_owner_t tmds_interp_owner = INTERP_OWNER_INIT("tmds", false);
+
 static const uint32_t __scratch_x("tmds_table") tmds_table[] = {
 #include "tmds_table.h"
 };
@@ -65,21 +70,18 @@ static int __not_in_flash_func(configure_interp_for_addrgen)(interp_hw_t *interp
 // pixel buffer must be word-aligned.
 
 void __not_in_flash_func(tmds_encode_data_channel_16bpp)(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix, uint channel_msb, uint channel_lsb) {
-	interp_hw_save_t interp0_save;
-	interp_save(interp0_hw, &interp0_save);
+	interp_owner_claim(0, &tmds_interp_owner);
 	int require_lshift = configure_interp_for_addrgen(interp0_hw, channel_msb, channel_lsb, 0, 16, 6, tmds_table);
 	if (require_lshift)
 		tmds_encode_loop_16bpp_leftshift(pixbuf, symbuf, n_pix, require_lshift);
 	else
 		tmds_encode_loop_16bpp(pixbuf, symbuf, n_pix);
-	interp_restore(interp0_hw, &interp0_save);
 }
 
 // As above, but 8 bits per pixel, multiple of 4 pixels, and still word-aligned.
 void __not_in_flash_func(tmds_encode_data_channel_8bpp)(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix, uint channel_msb, uint channel_lsb) {
-	interp_hw_save_t interp0_save, interp1_save;
-	interp_save(interp0_hw, &interp0_save);
-	interp_save(interp1_hw, &interp1_save);
+	interp_owner_claim(0, &tmds_interp_owner);
+	interp_owner_claim(1, &tmds_interp_owner);
 	// Note that for 8bpp, some left shift is always required for pixel 0 (any
 	// channel), which destroys some MSBs of pixel 3. To get around this, pixel
 	// data sent to interp1 is *not left-shifted*
@@ -90,8 +92,6 @@ void __not_in_flash_func(tmds_encode_data_channel_8bpp)(const uint32_t *pixbuf,
 		tmds_encode_loop_8bpp_leftshift(pixbuf, symbuf, n_pix, require_lshift);
 	else
 		tmds_encode_loop_8bpp(pixbuf, symbuf, n_pix);
-	interp_restore(interp0_hw, &interp0_save);
-	interp_restore(interp1_hw, &interp1_save);
 }
 
 // ----------------------------------------------------------------------------
@@ -136,11 +136,8 @@ static int __not_in_flash_func(configure_interp_for_addrgen_fullres)(interp_hw_t
 
 void __not_in_flash_func(tmds_encode_data_channel_fullres_16bpp)(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix, uint channel_msb, uint channel_lsb) {
 	uint core = get_core_num();
-#if !TMDS_FULLRES_NO_INTERP_SAVE
-	interp_hw_save_t interp0_save, interp1_save;
-	interp_save(interp0_hw, &interp0_save);
-	interp_save(interp1_hw, &interp1_save);
-#endif
+	interp_owner_claim(0, &tmds_interp_owner);
+	interp_owner_claim(1, &tmds_interp_owner);
 
 	// There is a copy of the inner loop and the LUT in both scratch X and
 	// scratch Y memories. Use X on core 1 and Y on core 0 so the cores don't
@@ -161,10 +158,6 @@ void __not_in_flash_func(tmds_encode_data_channel_fullres_16bpp)(const uint32_t
 			tmds_fullres_encode_loop_16bpp_y
 		)(pixbuf, symbuf, n_pix);
 	}
-#if !TMDS_FULLRES_NO_INTERP_SAVE
-	interp_restore(interp0_hw, &interp0_save);
-	interp_restore(interp1_hw, &interp1_save);
-#endif
 }
 
 static const int8_t imbalance_lookup[16] = { -4, -2, -2, 0, -2, 0, 0, 2, -2, 0, 0, 2, 0, 2, 2, 4 };
@@ -249,11 +242,8 @@ void tmds_setup_palette24_symbols(const uint32_t *palette, uint32_t *tmds_palett
 // symbuf is 3*n_pix 32-bit words, this function writes the symbol values for each of the channels to it.
 void __not_in_flash_func(tmds_encode_palette_data)(const uint32_t *pixbuf, const uint32_t *tmds_palette, uint32_t *symbuf, size_t n_pix, uint32_t palette_bits) {
 	uint core = get_core_num();
-#if !TMDS_FULLRES_NO_INTERP_SAVE
-	interp_hw_save_t interp0_save, interp1_save;
-	interp_save(interp0_hw, &interp0_save);
-	interp_save(interp1_hw, &interp1_save);
-#endif
+	interp_owner_claim(0, &tmds_interp_owner);
+	interp_owner_claim(1, &tmds_interp_owner);
 
 	interp0_hw->base[2] = (uint32_t)tmds_palette;
 	interp1_hw->base[2] = (uint32_t)tmds_palette;
@@ -298,8 +288,4 @@ void __not_in_flash_func(tmds_encode_palette_data)(const uint32_t *pixbuf, const
 		tmds_palette_encode_loop_y(pixbuf, symbuf + n_pix, n_pix);
 	}
 
-#if !TMDS_FULLRES_NO_INTERP_SAVE
-	interp_restore(interp0_hw, &interp0_save);
-	interp_restore(interp1_hw, &interp1_save);
-#endif
 }
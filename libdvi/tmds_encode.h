@@ -5,6 +5,9 @@
 #include "dvi_config_defs.h"
 
 // Functions from tmds_encode.c
+// These claim the interpolators they use through util_interp_owner.h rather
+// than saving/restoring them, so any interpolator state you need to survive
+// a call must belong to a preserve owner.
 void tmds_encode_data_channel_16bpp(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix, uint channel_msb, uint channel_lsb);
 void tmds_encode_data_channel_8bpp(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix, uint channel_msb, uint channel_lsb);
 void tmds_encode_data_channel_fullres_16bpp(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix, uint channel_msb, uint channel_lsb);
@@ -0,0 +1,20 @@
+#include "util_interp_owner.h"
+
+interp_owner_t *interp_owner_current[NUM_CORES][2];
+uint32_t interp_owner_switch_count[NUM_CORES];
+
+void __not_in_flash_func(interp_owner_switch)(uint interp_num, interp_owner_t *owner) {
+	uint core = get_core_num();
+	interp_hw_t *interp = interp_num ? interp1_hw : interp0_hw;
+	interp_owner_t *prev = interp_owner_current[core][interp_num];
+	if (prev && prev->preserve) {
+		interp_save(interp, &prev->save[interp_num]);
+		prev->saved[interp_num] = true;
+	}
+	if (owner && owner->preserve && owner->saved[interp_num]) {
+		interp_restore(interp, &owner->save[interp_num]);
+		owner->saved[interp_num] = false;
+	}
+	interp_owner_current[core][interp_num] = owner;
+	++interp_owner_switch_count[core];
+}
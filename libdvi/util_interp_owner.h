@@ -0,0 +1,50 @@
+#ifndef _UTIL_INTERP_OWNER_H
+#define _UTIL_INTERP_OWNER_H
+
+// Interpolator ownership, tracked per core.
+//
+// Several users configure the (per-core) interpolators: the TMDS encoders
+// (interp0, plus interp1 for 8bpp, fullres and palette encode), tile8/tile16
+// (interp1) and the affine sprite routines (interp0). Instead of each of them
+// saving and restoring the interpolators on every call, a user claims an
+// interpolator before configuring it. The claim is just a compare if the
+// caller is already the owner on this core. When the owner changes, the
+// outgoing owner's state is saved only if that owner asked for it
+// (preserve), and is restored when it next claims the interpolator.
+//
+// The library users all reconfigure the interpolator on every call, so they
+// don't set preserve and switching between them costs nothing extra. Code
+// that keeps interpolator state alive across calls into libdvi/libsprite
+// should claim with a preserve owner, one per core since the interpolators
+// are per core.
+//
+// Not IRQ safe: code using an interpolator from an IRQ handler must still
+// interp_save()/interp_restore() around its use.
+
+#include "pico/types.h"
+#include "pico/platform.h"
+#include "hardware/interp.h"
+
+typedef struct interp_owner {
+	const char *name;
+	bool preserve;
+	bool saved[2];
+	interp_hw_save_t save[2];
+} interp_owner_t;
+
+#define INTERP_OWNER_INIT(owner_name, owner_preserve) {.name = (owner_name), .preserve = (owner_preserve)}
+
+extern interp_owner_t *interp_owner_current[NUM_CORES][2];
+// Number of ownership changes on each core, to check the switching rate
+extern uint32_t interp_owner_switch_count[NUM_CORES];
+
+// Slow path of interp_owner_claim(). owner may be NULL to give up ownership
+// (which saves the current owner's state if it is a preserve owner).
+void interp_owner_switch(uint interp_num, interp_owner_t *owner);
+
+static inline void interp_owner_claim(uint interp_num, interp_owner_t *owner) {
+	if (interp_owner_current[get_core_num()][interp_num] != owner)
+		interp_owner_switch(interp_num, owner);
+}
+
+#endif
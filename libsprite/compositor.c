@@ -0,0 +1,424 @@
+#include <string.h>
+
+#include "compositor.h"
+
+#include "pico/platform.h" // for __not_in_flash
+
+#define __ram_func(foo) __not_in_flash(#foo) foo
+
+void compositor_init(compositor_t *c, uint width, uint height) {
+	memset(c, 0, sizeof(*c));
+	c->width = width;
+	c->height = MIN(height, COMPOSITOR_MAX_LINES);
+}
+
+static void compositor_sort(compositor_t *c, uint n) {
+	// Without depths the order is the array order, even if last frame had
+	// depths and the same number of sprites
+	if (n != c->n_sorted || !c->depth) {
+		for (uint i = 0; i < n; ++i)
+			c->order[i] = i;
+		c->n_sorted = n;
+	}
+	if (!c->depth)
+		return;
+	// Insertion sort, starting from last frame's order: stable, and close to
+	// linear since depths rarely change from one frame to the next. Ties go
+	// by index so the result doesn't depend on the previous order.
+	for (uint i = 1; i < n; ++i) {
+		uint8_t idx = c->order[i];
+		uint key = (uint)c->depth[idx] << 8 | idx;
+		int j = i - 1;
+		while (j >= 0 && ((uint)c->depth[c->order[j]] << 8 | c->order[j]) > key) {
+			c->order[j + 1] = c->order[j];
+			--j;
+		}
+		c->order[j + 1] = idx;
+	}
+}
+
+// Insertion sort again, the layer list is tiny
+static void compositor_sort_layers(compositor_t *c, uint n) {
+	for (uint i = 0; i < n; ++i) {
+		uint8_t idx = i;
+		int j = i - 1;
+		while (j >= 0 && c->layers[c->layer_order[j]].depth > c->layers[idx].depth) {
+			c->layer_order[j + 1] = c->layer_order[j];
+			--j;
+		}
+		c->layer_order[j + 1] = idx;
+	}
+}
+
+void compositor_build_bins(compositor_t *c) {
+	uint n = MIN(c->n_sprites, COMPOSITOR_MAX_SPRITES);
+	compositor_sort(c, n);
+	if (c->layers)
+		compositor_sort_layers(c, MIN(c->n_layers, COMPOSITOR_MAX_LAYERS));
+	c->stack_pixels = 0;
+	memset(c->bin_count, 0, sizeof(c->bin_count));
+	if (c->collide_mask)
+		memset(c->collide_bits, 0, sizeof(c->collide_bits));
+	for (uint k = 0; k < n; ++k) {
+		uint i = c->order[k];
+		const sprite_t *sp = &c->sprites[i];
+		if (sp->x >= (int)c->width || sp->x + (int)sprite_w(sp) <= 0)
+			continue;
+		int y0 = MAX(sp->y, 0);
+		int y1 = MIN(sp->y + (int)sprite_h(sp), (int)c->height) - 1;
+		if (y1 < y0)
+			continue;
+		if (c->atrans && c->atrans[i])
+			sprite_asprite_prepare(&c->acache[i], sp, c->atrans[i], 1, c->width);
+		for (uint band = (uint)y0 >> COMPOSITOR_BAND_LOG2; band <= (uint)y1 >> COMPOSITOR_BAND_LOG2; ++band) {
+			if (c->bin_count[band] < COMPOSITOR_BIN_SIZE)
+				c->bin[band][c->bin_count[band]++] = i;
+			else
+				++c->bin_overflows;
+		}
+	}
+}
+
+// Gather the opaque spans of the colliding sprites on this line, sort them by
+// start, and sweep them left to right. Since spans are sorted, span i
+// overlaps an earlier span j exactly when j ends after i starts, so only the
+// spans still open at i's start are kept in the active list and paired with
+// it. The cost grows with the number of overlaps rather than with n^2.
+static void __ram_func(compositor_collide_line)(compositor_t *c, uint y, const uint8_t *bin, uint bin_count) {
+	// One slot more than is kept, to tell a sprite cut short from one that
+	// just fits
+	int16_t span[COMPOSITOR_COLLIDE_MAX_SPANS + 1][2];
+	uint8_t owner[COMPOSITOR_COLLIDE_MAX_SPANS];
+	uint n = 0;
+	for (uint k = 0; k < bin_count; ++k) {
+		uint i = bin[k];
+		if (!c->collide_mask[i])
+			continue;
+		const sprite_t *sp = &c->sprites[i];
+		uint room = COMPOSITOR_COLLIDE_MAX_SPANS - n;
+		uint n_new;
+		if (c->atrans && c->atrans[i]) {
+			const asprite_cache_t *ac = &c->acache[i];
+			if ((uint)((int)y - sp->y) >= sprite_h(sp) || ac->size_x <= 0) {
+				n_new = 0;
+			}
+			else {
+				span[n][0] = sp->x + ac->tex_offs_x;
+				span[n][1] = sp->x + ac->tex_offs_x + ac->size_x;
+				n_new = 1;
+			}
+		}
+		else {
+			n_new = sprite_opaque_spans(sp, y, c->width, 1, span[n], room + 1);
+		}
+		if (n_new > room) {
+			++c->collide_overflows;
+			n_new = room;
+		}
+		for (uint j = n; j < n + n_new; ++j)
+			owner[j] = i;
+		n += n_new;
+	}
+	if (n < 2)
+		return;
+
+	for (uint i = 1; i < n; ++i) {
+		int16_t s0 = span[i][0], s1 = span[i][1];
+		uint8_t o = owner[i];
+		int j = i - 1;
+		while (j >= 0 && span[j][0] > s0) {
+			span[j + 1][0] = span[j][0];
+			span[j + 1][1] = span[j][1];
+			owner[j + 1] = owner[j];
+			--j;
+		}
+		span[j + 1][0] = s0;
+		span[j + 1][1] = s1;
+		owner[j + 1] = o;
+	}
+
+	uint8_t active[COMPOSITOR_COLLIDE_MAX_SPANS];
+	uint n_active = 0;
+	for (uint i = 0; i < n; ++i) {
+		uint kept = 0;
+		for (uint k = 0; k < n_active; ++k) {
+			uint j = active[k];
+			if (span[j][1] <= span[i][0])
+				continue;
+			active[kept++] = j;
+			uint a = owner[j], b = owner[i];
+			if (a == b || !(c->collide_mask[a] & c->collide_mask[b]))
+				continue;
+			if (a > b) {
+				uint t = a;
+				a = b;
+				b = t;
+			}
+			c->collide_bits[a][b >> 5] |= 1u << (b & 31);
+		}
+		active[kept] = i;
+		n_active = kept + 1;
+	}
+}
+
+uint compositor_get_collisions(const compositor_t *c, compositor_pair_t *pairs, uint max_pairs) {
+	uint n = 0;
+	if (!c->collide_mask)
+		return 0;
+	for (uint a = 0; a < COMPOSITOR_MAX_SPRITES; ++a) {
+		for (uint w = 0; w < count_of(c->collide_bits[a]); ++w) {
+			uint32_t bits = c->collide_bits[a][w];
+			while (bits) {
+				uint b = w * 32 + __builtin_ctz(bits);
+				bits &= bits - 1;
+				if (n < max_pairs) {
+					pairs[n].a = a;
+					pairs[n].b = b;
+				}
+				++n;
+			}
+		}
+	}
+	return n;
+}
+
+// ----------------------------------------------------------------------------
+// Layer stack
+
+enum {
+	ITEM_FILL,
+	ITEM_BG,
+	ITEM_LAYER,
+	ITEM_SPRITE,
+	ITEM_ASPRITE
+};
+
+// vis_count for items drawn whole, when the visible list overflowed
+#define VIS_ALL 0xffu
+
+static inline void push_item(compositor_t *c, uint *n, uint kind, uint idx, int x0, int x1) {
+	compositor_item_t *it = &c->items[(*n)++];
+	it->kind = kind;
+	it->idx = idx;
+	it->x0 = x0;
+	it->x1 = x1;
+}
+
+static inline void push_layer(compositor_t *c, uint *n, uint l, uint y) {
+	if (tilebg_line_enabled(c->layers[l].bg, y))
+		push_item(c, n, ITEM_LAYER, l, 0, c->width);
+}
+
+// Bottom to top: bg (or the fill), then the layers merged with this band's
+// sprites, which are already in depth order.
+static uint stack_items(compositor_t *c, uint y, const uint8_t *bin, uint bin_count) {
+	uint n = 0;
+	if (c->bg && tilebg_line_enabled(c->bg, y))
+		push_item(c, &n, ITEM_BG, 0, 0, c->width);
+	else
+		push_item(c, &n, ITEM_FILL, 0, 0, c->width);
+	uint n_layers = MIN(c->n_layers, COMPOSITOR_MAX_LAYERS);
+	uint l = 0;
+	for (uint k = 0; k < bin_count; ++k) {
+		uint i = bin[k];
+		const sprite_t *sp = &c->sprites[i];
+		uint depth = c->depth ? c->depth[i] : 0;
+		while (l < n_layers && c->layers[c->layer_order[l]].depth <= depth)
+			push_layer(c, &n, c->layer_order[l++], y);
+		if ((uint)((int)y - sp->y) >= sprite_h(sp))
+			continue;
+		if (c->atrans && c->atrans[i]) {
+			const asprite_cache_t *ac = &c->acache[i];
+			if (ac->size_x > 0)
+				push_item(c, &n, ITEM_ASPRITE, i, sp->x + ac->tex_offs_x, sp->x + ac->tex_offs_x + ac->size_x);
+		}
+		else {
+			int x0 = MAX(sp->x, 0);
+			int x1 = MIN(sp->x + (int)sprite_w(sp), (int)c->width);
+			if (x1 > x0)
+				push_item(c, &n, ITEM_SPRITE, i, x0, x1);
+		}
+	}
+	while (l < n_layers)
+		push_layer(c, &n, c->layer_order[l++], y);
+	return n;
+}
+
+// Add [start, end) to the sorted, disjoint list of covered intervals, merging
+// any it touches. If the list is full the interval is dropped, which only
+// means less gets culled.
+static void cover_add(compositor_t *c, uint *n_cover, int start, int end) {
+	uint n = *n_cover;
+	uint i = 0;
+	while (i < n && c->cover[i][1] < start)
+		++i;
+	uint j = i;
+	while (j < n && c->cover[j][0] <= end) {
+		start = MIN(start, c->cover[j][0]);
+		end = MAX(end, c->cover[j][1]);
+		++j;
+	}
+	if (i == j) {
+		if (n == COMPOSITOR_MAX_COVER)
+			return;
+		memmove(&c->cover[i + 1], &c->cover[i], (n - i) * sizeof(c->cover[0]));
+		++n;
+	}
+	else if (j > i + 1) {
+		memmove(&c->cover[i + 1], &c->cover[j], (n - j) * sizeof(c->cover[0]));
+		n -= j - i - 1;
+	}
+	c->cover[i][0] = start;
+	c->cover[i][1] = end;
+	*n_cover = n;
+}
+
+// Spans of this item that hide everything below it
+static uint item_solid_spans(compositor_t *c, const compositor_item_t *it, uint y, int16_t *spans, uint max_spans) {
+	if (it->kind == ITEM_SPRITE)
+		return sprite_solid_spans(&c->sprites[it->idx], y, c->width, 1, spans, max_spans);
+	if (it->kind != ITEM_LAYER)
+		return 0;
+	const compositor_layer_t *layer = &c->layers[it->idx];
+	if (layer->flags & COMPOSITOR_LAYER_OPAQUE) {
+		spans[0] = 0;
+		spans[1] = c->width;
+		return 1;
+	}
+	if (layer->opaque_tiles)
+		return tilebg_opaque_spans(layer->bg, layer->opaque_tiles, y, c->width, spans, max_spans);
+	return 0;
+}
+
+// Top to bottom: record what is left of each item after subtracting the
+// coverage so far, then add its own solid spans to the coverage. Items with
+// nothing left are skipped (their coverage is already included).
+static void stack_cull(compositor_t *c, uint n_items, uint y) {
+	int16_t spans[COMPOSITOR_MAX_COVER][2];
+	uint n_cover = 0;
+	uint n_vis = 0;
+	bool covered = false;
+	for (int k = n_items - 1; k >= 0; --k) {
+		compositor_item_t *it = &c->items[k];
+		it->vis_first = n_vis;
+		it->vis_count = 0;
+		if (covered)
+			continue;
+		int x = it->x0;
+		for (uint j = 0; j <= n_cover && x < it->x1; ++j) {
+			int gap_end = it->x1;
+			if (j < n_cover) {
+				if (c->cover[j][1] <= x)
+					continue;
+				gap_end = MIN(gap_end, c->cover[j][0]);
+			}
+			if (gap_end > x) {
+				if (it->vis_count && x - c->visible[n_vis - 1][1] < COMPOSITOR_MIN_GAP) {
+					c->visible[n_vis - 1][1] = gap_end;
+				}
+				else if (n_vis < COMPOSITOR_MAX_VISIBLE) {
+					c->visible[n_vis][0] = x;
+					c->visible[n_vis][1] = gap_end;
+					++n_vis;
+					++it->vis_count;
+				}
+				else {
+					it->vis_count = VIS_ALL;
+					break;
+				}
+			}
+			if (j < n_cover)
+				x = c->cover[j][1];
+		}
+		if (!it->vis_count || k == 0)
+			continue;
+		uint n_spans = item_solid_spans(c, it, y, &spans[0][0], COMPOSITOR_MAX_COVER);
+		for (uint s = 0; s < n_spans; ++s)
+			cover_add(c, &n_cover, spans[s][0], spans[s][1]);
+		covered = n_cover == 1 && c->cover[0][0] <= 0 && c->cover[0][1] >= (int)c->width;
+	}
+}
+
+static void draw_item(compositor_t *c, uint16_t *scanbuf, const compositor_item_t *it, uint y, int x0, int x1) {
+	c->stack_pixels += x1 - x0;
+	switch (it->kind) {
+	case ITEM_FILL:
+		sprite_fill16(scanbuf + x0, c->bg_colour, x1 - x0);
+		break;
+	case ITEM_BG:
+		tile16_range(scanbuf, c->bg, y, x0, x1);
+		break;
+	case ITEM_LAYER:
+		tile16_range(scanbuf, c->layers[it->idx].bg, y, x0, x1);
+		break;
+	case ITEM_SPRITE:
+		if (x0 == it->x0 && x1 == it->x1) {
+			sprite_sprite16(scanbuf, &c->sprites[it->idx], y, c->width);
+		}
+		else {
+			// Clip by drawing into a window of the line
+			sprite_t clipped = c->sprites[it->idx];
+			clipped.x -= x0;
+			sprite_sprite16(scanbuf + x0, &clipped, y, x1 - x0);
+		}
+		break;
+	case ITEM_ASPRITE:
+		// The cache is set up for the whole line, so these are never clipped
+		sprite_asprite16_cached(scanbuf, &c->sprites[it->idx], &c->acache[it->idx], y);
+		break;
+	}
+}
+
+static void __ram_func(compositor_render_stack16)(compositor_t *c, uint16_t *scanbuf, uint y,
+	const uint8_t *bin, uint bin_count) {
+	uint n_items = stack_items(c, y, bin, bin_count);
+	stack_cull(c, n_items, y);
+	for (uint k = 0; k < n_items; ++k) {
+		const compositor_item_t *it = &c->items[k];
+		if (it->vis_count == VIS_ALL) {
+			draw_item(c, scanbuf, it, y, it->x0, it->x1);
+		}
+		else if (it->kind == ITEM_ASPRITE) {
+			if (it->vis_count)
+				draw_item(c, scanbuf, it, y, it->x0, it->x1);
+		}
+		else {
+			for (uint v = it->vis_first; v < it->vis_first + it->vis_count; ++v)
+				draw_item(c, scanbuf, it, y, c->visible[v][0], c->visible[v][1]);
+		}
+	}
+}
+
+void __ram_func(compositor_render_line16)(compositor_t *c, uint16_t *scanbuf, uint y) {
+	uint band = y >> COMPOSITOR_BAND_LOG2;
+	const uint8_t *bin = c->bin[band];
+	if (c->layers) {
+		compositor_render_stack16(c, scanbuf, y, bin, c->bin_count[band]);
+	}
+	else {
+		if (c->bg && tilebg_line_enabled(c->bg, y))
+			tile16(scanbuf, c->bg, y, c->width);
+		else
+			sprite_fill16(scanbuf, c->bg_colour, c->width);
+
+		for (uint k = 0; k < c->bin_count[band]; ++k) {
+			uint i = bin[k];
+			if (c->atrans && c->atrans[i])
+				sprite_asprite16_cached(scanbuf, &c->sprites[i], &c->acache[i], y);
+			else
+				sprite_sprite16(scanbuf, &c->sprites[i], y, c->width);
+		}
+	}
+	if (c->collide_mask)
+		compositor_collide_line(c, y, bin, c->bin_count[band]);
+}
+
+void __ram_func(compositor_render_frame16)(compositor_t *c, queue_t *q_free, queue_t *q_valid) {
+	compositor_build_bins(c);
+	for (uint y = 0; y < c->height; ++y) {
+		uint16_t *scanbuf;
+		queue_remove_blocking(q_free, &scanbuf);
+		compositor_render_line16(c, scanbuf, y);
+		queue_add_blocking(q_valid, &scanbuf);
+	}
+}
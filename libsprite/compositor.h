@@ -0,0 +1,185 @@
+#ifndef _COMPOSITOR_H
+#define _COMPOSITOR_H
+
+#include "pico/types.h"
+#include "pico/util/queue.h"
+
+#include "sprite.h"
+#include "tile.h"
+
+// Scanline compositor: a background (tiles or a flat colour) plus a list of
+// sprites, rendered into 16bpp scanbuffers one line at a time.
+//
+// Once per frame, compositor_build_bins() sorts the sprites by depth and
+// records each visible sprite in the bin of every horizontal band (of
+// 1 << COMPOSITOR_BAND_LOG2 lines) it overlaps. Each scanline then only
+// visits the sprites in its own band, rather than testing every sprite on
+// every line. Bands rather than single lines keep the bins small: with the
+// defaults that's 30 bins for a 240-line frame.
+//
+// Optionally, the background can be a stack of tile layers (compositor_layer_t)
+// with the sprites interleaved by depth. The stack is culled front to back
+// before anything is drawn: the solid spans of each item (from sprite
+// opacity metadata, per-tile opacity bits, or a whole opaque layer) hide
+// what is below them, and each item is then drawn back to front over just
+// its uncovered intervals. A parallax background behind an opaque middle
+// layer only costs the pixels that show through.
+//
+// The intended setup is the one the sprite demos use: one core runs
+// dvi_scanbuf_main_16bpp(), the other calls compositor_render_frame16() in a
+// loop, which feeds that core through q_colour_free/q_colour_valid.
+
+#ifndef COMPOSITOR_MAX_SPRITES
+#define COMPOSITOR_MAX_SPRITES 64
+#endif
+
+// Lines per band = 1 << COMPOSITOR_BAND_LOG2
+#ifndef COMPOSITOR_BAND_LOG2
+#define COMPOSITOR_BAND_LOG2 3
+#endif
+
+#ifndef COMPOSITOR_MAX_LINES
+#define COMPOSITOR_MAX_LINES 240
+#endif
+
+// Sprites beyond this many in one band are dropped (and counted)
+#ifndef COMPOSITOR_BIN_SIZE
+#define COMPOSITOR_BIN_SIZE 32
+#endif
+
+// Opaque spans per line considered for collisions, beyond which spans are
+// ignored (and counted)
+#ifndef COMPOSITOR_COLLIDE_MAX_SPANS
+#define COMPOSITOR_COLLIDE_MAX_SPANS 64
+#endif
+
+#ifndef COMPOSITOR_MAX_LAYERS
+#define COMPOSITOR_MAX_LAYERS 4
+#endif
+
+// Per-line limits of the layer stack culling: covered intervals tracked, and
+// visible intervals over all items. Beyond these, culling just gets more
+// conservative (more overdraw), never wrong.
+#ifndef COMPOSITOR_MAX_COVER
+#define COMPOSITOR_MAX_COVER 16
+#endif
+
+#ifndef COMPOSITOR_MAX_VISIBLE
+#define COMPOSITOR_MAX_VISIBLE 64
+#endif
+
+// Uncovered intervals of one item closer than this many pixels are drawn as
+// one, since each draw call has a fixed cost of a few dozen pixels
+#ifndef COMPOSITOR_MIN_GAP
+#define COMPOSITOR_MIN_GAP 16
+#endif
+
+#define COMPOSITOR_N_BANDS ((COMPOSITOR_MAX_LINES + (1u << COMPOSITOR_BAND_LOG2) - 1) >> COMPOSITOR_BAND_LOG2)
+
+#if COMPOSITOR_MAX_SPRITES > 256
+#error "Bins store 8-bit sprite indices"
+#endif
+
+#if COMPOSITOR_MAX_VISIBLE > 255
+#error "Layer stack items store 8-bit visible interval indices"
+#endif
+
+// Every pixel of the layer is opaque (e.g. a non-alpha fill loop)
+#define COMPOSITOR_LAYER_OPAQUE 0x01u
+
+typedef struct compositor_layer {
+	const tilebg_t *bg;
+	// Drawn over sprites with a lower depth, and under sprites with the same
+	// or a higher depth. Equal layer depths are drawn in array order.
+	uint8_t depth;
+	uint8_t flags;
+	// Optional (NULL): per-tile opacity bits for culling what is below this
+	// layer, see tilebg_opaque_spans(). Not needed with COMPOSITOR_LAYER_OPAQUE.
+	const uint32_t *opaque_tiles;
+} compositor_layer_t;
+
+// One entry of a line's layer stack, bottom to top
+typedef struct compositor_item {
+	uint8_t kind;
+	uint8_t idx;
+	uint8_t vis_first;
+	uint8_t vis_count;
+	int16_t x0;
+	int16_t x1;
+} compositor_item_t;
+
+typedef struct compositor {
+	// Config, may be changed between frames ---
+	const sprite_t *sprites;
+	uint n_sprites;
+	// Optional (NULL): one pointer per sprite, sprites with a non-NULL entry
+	// are drawn through that affine transform.
+	const int32_t *const *atrans;
+	// Optional (NULL): one entry per sprite, higher values are drawn on top.
+	// Equal depths are drawn in array order.
+	const uint8_t *depth;
+	// Optional (NULL): one entry per sprite, enables collision detection.
+	// Two sprites collide if their masks share a bit and their opaque spans
+	// (from the opacity metadata, see sprite_opaque_spans()) overlap on some
+	// line. Affine sprites count as their whole box.
+	const uint8_t *collide_mask;
+	// Optional (NULL): background layer, otherwise filled with bg_colour
+	const tilebg_t *bg;
+	// Optional (NULL): tile layers drawn over bg, interleaved with the
+	// sprites by depth, with occlusion culling (see top of file)
+	const compositor_layer_t *layers;
+	uint n_layers;
+	uint16_t bg_colour;
+	uint width;
+	uint height;
+
+	// State ---
+	uint n_sorted;
+	uint8_t order[COMPOSITOR_MAX_SPRITES];
+	uint8_t bin_count[COMPOSITOR_N_BANDS];
+	uint8_t bin[COMPOSITOR_N_BANDS][COMPOSITOR_BIN_SIZE];
+	// Affine setup for sprites with a transform, prepared with the bins
+	asprite_cache_t acache[COMPOSITOR_MAX_SPRITES];
+	// Total sprite/band pairs dropped because a bin was full
+	uint32_t bin_overflows;
+	// Collisions this frame: bit b of collide_bits[a] is set for a < b
+	uint32_t collide_bits[COMPOSITOR_MAX_SPRITES][(COMPOSITOR_MAX_SPRITES + 31) / 32];
+	// Sprite/line pairs not (fully) checked because the line already had
+	// COMPOSITOR_COLLIDE_MAX_SPANS spans
+	uint32_t collide_overflows;
+	// Layer stack: layers sorted by depth, scratch for the current line, and
+	// pixels drawn this frame (overdraw is this over width * height)
+	uint8_t layer_order[COMPOSITOR_MAX_LAYERS];
+	compositor_item_t items[COMPOSITOR_MAX_LAYERS + COMPOSITOR_BIN_SIZE + 1];
+	int16_t cover[COMPOSITOR_MAX_COVER][2];
+	int16_t visible[COMPOSITOR_MAX_VISIBLE][2];
+	uint32_t stack_pixels;
+} compositor_t;
+
+typedef struct compositor_pair {
+	uint8_t a;
+	uint8_t b;
+} compositor_pair_t;
+
+void compositor_init(compositor_t *c, uint width, uint height);
+
+// Sort and bin the sprites for this frame, and prepare the affine sprites.
+// Sprite positions and transforms may change freely between calls, but not
+// while the frame is being rendered.
+void compositor_build_bins(compositor_t *c);
+
+// Render line y (background, then the sprites binned for its band, or the
+// culled layer stack if there are layers)
+void compositor_render_line16(compositor_t *c, uint16_t *scanbuf, uint y);
+
+// After a frame has been rendered (and until the next compositor_build_bins())
+// list the colliding sprite index pairs, a < b, in order of a then b.
+// Returns the total number of pairs, which may be more than max_pairs.
+uint compositor_get_collisions(const compositor_t *c, compositor_pair_t *pairs, uint max_pairs);
+
+// Bin the sprites, then render a whole frame: each line is rendered into a
+// buffer popped from q_free and pushed to q_valid (e.g. the dvi_inst colour
+// queues).
+void compositor_render_frame16(compositor_t *c, queue_t *q_free, queue_t *q_valid);
+
+#endif
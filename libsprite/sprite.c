@@ -3,29 +3,33 @@
 
 #include "pico/platform.h" // for __not_in_flash
 #include "hardware/interp.h"
+#include "util_interp_owner.h"
 
 // Note some of the sprite routines are quite large (unrolled), so trying to
 // keep everything in separate sections so the linker can garbage collect
 // unused sprite code. In particular we usually need 8bpp xor 16bpp functions!
 #define __ram_func(foo) __not_in_flash(#foo) foo
 
+static interp_owner_t sprite_interp_owner = INTERP_OWNER_INIT("sprite", false);
+
 typedef struct {
 	int tex_offs_x;
 	int tex_offs_y;
 	int size_x;
 } intersect_t;
 
+static_assert(sizeof(sprite_t) <= 3 * sizeof(void*), "sprite_t must stay 3 words");
+
 // Always-inline else the compiler does rash things like passing structs in memory
 static inline intersect_t _get_sprite_intersect(const sprite_t *sp, uint raster_y, uint raster_w) {
 	intersect_t isct = {0};
 	isct.tex_offs_y = (int)raster_y - sp->y;
-	int size = 1u << sp->log_size;
-	uint upper_mask = -size;
-	if ((uint)isct.tex_offs_y & upper_mask)
+	// One unsigned compare catches both lines above and below the sprite
+	if ((uint)isct.tex_offs_y >= sprite_h(sp))
 		return isct;
 	int x_start_clipped = MAX(0, sp->x);
 	isct.tex_offs_x = x_start_clipped - sp->x;
-	isct.size_x = MIN(sp->x + size, (int)raster_w) - x_start_clipped;
+	isct.size_x = MIN(sp->x + (int)sprite_w(sp), (int)raster_w) - x_start_clipped;
 	return isct;
 }
 
@@ -40,56 +44,180 @@ static inline intersect_t _intersect_with_metadata(intersect_t isct, uint32_t me
 	return isct;
 }
 
+// Metadata starts right after the stride * h pixels and is read as words, so
+// it must be word-aligned (see sprite.h)
+static inline const void *_get_meta_base(const sprite_t *sp, uint pixel_shift) {
+	const void *meta_base = (const uint8_t*)sp->img + (sprite_stride(sp) * sprite_h(sp) << pixel_shift);
+	assert(!((uintptr_t)meta_base & 3));
+	return meta_base;
+}
+
+// Multi-span metadata (SPRITE_FLAG_SPAN_METADATA). After the stride * h
+// pixels comes a uint16_t row_start[h + 1] table, padded to a word boundary,
+// then span words in the same format as above. Row r's spans are
+// span[row_start[r]] up to (not including) span[row_start[r + 1]], sorted by
+// x and non-overlapping, so we stop at the first span past the clip window.
+static inline const uint32_t *_get_row_spans(const sprite_t *sp, const void *meta_base, int row, const uint32_t **span_end) {
+	const uint16_t *row_start = meta_base;
+	const uint32_t *spans = (const uint32_t*)(row_start + ((sprite_h(sp) + 2) & ~1u));
+	*span_end = spans + row_start[row + 1];
+	return spans + row_start[row];
+}
+
+#define SPAN_LOOP(scanbuf, sp, isct, img, pixel_t, blit, blit_alpha) do { \
+	const uint32_t *span_end; \
+	const uint32_t *span = _get_row_spans(sp, _get_meta_base(sp, sizeof(pixel_t) - 1), (isct).tex_offs_y, &span_end); \
+	const pixel_t *src_row = (const pixel_t*)(img) + (isct).tex_offs_y * (int)sprite_stride(sp); \
+	int clip_end = (isct).tex_offs_x + (isct).size_x; \
+	for (; span < span_end; ++span) { \
+		uint32_t meta = *span; \
+		if ((int)((meta >> 16) & 0x7fff) >= clip_end) \
+			break; \
+		intersect_t s = _intersect_with_metadata(isct, meta); \
+		if (s.size_x <= 0) \
+			continue; \
+		if (meta & (1u << 31)) \
+			blit(scanbuf + (sp)->x + s.tex_offs_x, src_row + s.tex_offs_x, s.size_x); \
+		else \
+			blit_alpha(scanbuf + (sp)->x + s.tex_offs_x, src_row + s.tex_offs_x, s.size_x); \
+	} \
+} while (0)
+
 void __ram_func(sprite_sprite8)(uint8_t *scanbuf, const sprite_t *sp, uint raster_y, uint raster_w) {
-	int size = 1u << sp->log_size;
+	int stride = sprite_stride(sp);
 	intersect_t isct = _get_sprite_intersect(sp, raster_y, raster_w);
 	if (isct.size_x <= 0)
 		return;
-	if (sp->vflip)
-		isct.tex_offs_y = size - 1 - isct.tex_offs_y;
+	if (sp->flags & SPRITE_FLAG_VFLIP)
+		isct.tex_offs_y = sp->h_minus1 - isct.tex_offs_y;
 	const uint8_t *img = sp->img;
-	if (sp->has_opacity_metadata) {
+	if (sp->flags & SPRITE_FLAG_OPAQUE) {
+		sprite_blit8(scanbuf + sp->x + isct.tex_offs_x, img + isct.tex_offs_x + isct.tex_offs_y * stride, isct.size_x);
+	}
+	else if (sp->flags & SPRITE_FLAG_SPAN_METADATA) {
+		SPAN_LOOP(scanbuf, sp, isct, img, uint8_t, sprite_blit8, sprite_blit8_alpha);
+	}
+	else if (sp->flags & SPRITE_FLAG_OPACITY_METADATA) {
 		// Metadata is one word per row, concatenated to end of pixel data
-		uint32_t meta = ((uint32_t*)(sp->img + size * size * sizeof(uint8_t)))[isct.tex_offs_y];
+		uint32_t meta = ((const uint32_t*)_get_meta_base(sp, 0))[isct.tex_offs_y];
 		isct = _intersect_with_metadata(isct, meta);
 		if (isct.size_x <= 0)
 			return;
 		bool span_continuous = !!(meta & (1u << 31));
 		if (span_continuous) {
 			// Non-alpha blit is ~50% faster
-			sprite_blit8(scanbuf + sp->x + isct.tex_offs_x, img + isct.tex_offs_x + isct.tex_offs_y * size, isct.size_x);
+			sprite_blit8(scanbuf + sp->x + isct.tex_offs_x, img + isct.tex_offs_x + isct.tex_offs_y * stride, isct.size_x);
 		}
 		else {
-			sprite_blit8_alpha(scanbuf + sp->x + isct.tex_offs_x, img + isct.tex_offs_x + isct.tex_offs_y * size, isct.size_x);
+			sprite_blit8_alpha(scanbuf + sp->x + isct.tex_offs_x, img + isct.tex_offs_x + isct.tex_offs_y * stride, isct.size_x);
 		}
 	}
 	else {
-		sprite_blit8_alpha(scanbuf + sp->x + isct.tex_offs_x, img + isct.tex_offs_x + isct.tex_offs_y * size, isct.size_x);
+		sprite_blit8_alpha(scanbuf + sp->x + isct.tex_offs_x, img + isct.tex_offs_x + isct.tex_offs_y * stride, isct.size_x);
 	}
 }
 
 void __ram_func(sprite_sprite16)(uint16_t *scanbuf, const sprite_t *sp, uint raster_y, uint raster_w) {
-	int size = 1u << sp->log_size;
+	int stride = sprite_stride(sp);
 	intersect_t isct = _get_sprite_intersect(sp, raster_y, raster_w);
 	if (isct.size_x <= 0)
 		return;
-	if (sp->vflip)
-		isct.tex_offs_y = size - 1 - isct.tex_offs_y;
+	if (sp->flags & SPRITE_FLAG_VFLIP)
+		isct.tex_offs_y = sp->h_minus1 - isct.tex_offs_y;
 	const uint16_t *img = sp->img;
-	if (sp->has_opacity_metadata) {
-		uint32_t meta = ((uint32_t*)(sp->img + size * size * sizeof(uint16_t)))[isct.tex_offs_y];
+	if (sp->flags & SPRITE_FLAG_BLEND_MASK) {
+		// No fast opaque case when blending, but the metadata still trims
+		// the transparent pixels
+		sprite_blit16_loop_t blend = sprite_blit16_blend_func(sp->flags);
+		if (sp->flags & SPRITE_FLAG_SPAN_METADATA) {
+			SPAN_LOOP(scanbuf, sp, isct, img, uint16_t, blend, blend);
+			return;
+		}
+		if (sp->flags & SPRITE_FLAG_OPACITY_METADATA) {
+			uint32_t meta = ((const uint32_t*)_get_meta_base(sp, 1))[isct.tex_offs_y];
+			isct = _intersect_with_metadata(isct, meta);
+			if (isct.size_x <= 0)
+				return;
+		}
+		blend(scanbuf + sp->x + isct.tex_offs_x, img + isct.tex_offs_x + isct.tex_offs_y * stride, isct.size_x);
+	}
+	else if (sp->flags & SPRITE_FLAG_OPAQUE) {
+		sprite_blit16(scanbuf + sp->x + isct.tex_offs_x, img + isct.tex_offs_x + isct.tex_offs_y * stride, isct.size_x);
+	}
+	else if (sp->flags & SPRITE_FLAG_SPAN_METADATA) {
+		SPAN_LOOP(scanbuf, sp, isct, img, uint16_t, sprite_blit16, sprite_blit16_alpha);
+	}
+	else if (sp->flags & SPRITE_FLAG_OPACITY_METADATA) {
+		uint32_t meta = ((const uint32_t*)_get_meta_base(sp, 1))[isct.tex_offs_y];
 		isct = _intersect_with_metadata(isct, meta);
 		if (isct.size_x <= 0)
 			return;
 		bool span_continuous = !!(meta & (1u << 31));
 		if (span_continuous)
-			sprite_blit16(scanbuf + sp->x + isct.tex_offs_x, img + isct.tex_offs_x + isct.tex_offs_y * size, isct.size_x);
+			sprite_blit16(scanbuf + sp->x + isct.tex_offs_x, img + isct.tex_offs_x + isct.tex_offs_y * stride, isct.size_x);
 		else
-			sprite_blit16_alpha(scanbuf + sp->x + isct.tex_offs_x, img + isct.tex_offs_x + isct.tex_offs_y * size, isct.size_x);
+			sprite_blit16_alpha(scanbuf + sp->x + isct.tex_offs_x, img + isct.tex_offs_x + isct.tex_offs_y * stride, isct.size_x);
 	}
 	else {
-		sprite_blit16_alpha(scanbuf + MAX(0, sp->x), img + isct.tex_offs_x + isct.tex_offs_y * size, isct.size_x);
+		sprite_blit16_alpha(scanbuf + MAX(0, sp->x), img + isct.tex_offs_x + isct.tex_offs_y * stride, isct.size_x);
+	}
+}
+
+// Screen-space opaque spans of a sprite on this line, from the same
+// metadata the blits use. Solid spans are exact; other spans (single-span
+// metadata, or runs merged across small gaps) may include some transparent
+// pixels, and sprites without metadata count as their whole box. With
+// solid_only, only spans known to have no transparent pixels are listed
+// (so nothing for blended sprites, or sprites without metadata).
+static inline uint _sprite_spans(const sprite_t *sp, uint raster_y, uint raster_w, uint pixel_shift,
+	int16_t *spans, uint max_spans, bool solid_only) {
+	intersect_t isct = _get_sprite_intersect(sp, raster_y, raster_w);
+	if (isct.size_x <= 0 || !max_spans)
+		return 0;
+	if (solid_only && (sp->flags & SPRITE_FLAG_BLEND_MASK))
+		return 0;
+	if (sp->flags & SPRITE_FLAG_VFLIP)
+		isct.tex_offs_y = sp->h_minus1 - isct.tex_offs_y;
+	uint n = 0;
+	if (!(sp->flags & SPRITE_FLAG_OPAQUE) && (sp->flags & SPRITE_FLAG_SPAN_METADATA)) {
+		const uint32_t *span_end;
+		const uint32_t *span = _get_row_spans(sp, _get_meta_base(sp, pixel_shift), isct.tex_offs_y, &span_end);
+		for (; span < span_end && n < max_spans; ++span) {
+			if (solid_only && !(*span & (1u << 31)))
+				continue;
+			intersect_t s = _intersect_with_metadata(isct, *span);
+			if (s.size_x <= 0)
+				continue;
+			spans[2 * n] = sp->x + s.tex_offs_x;
+			spans[2 * n + 1] = sp->x + s.tex_offs_x + s.size_x;
+			++n;
+		}
+		return n;
+	}
+	if (!(sp->flags & SPRITE_FLAG_OPAQUE) && (sp->flags & SPRITE_FLAG_OPACITY_METADATA)) {
+		uint32_t meta = ((const uint32_t*)_get_meta_base(sp, pixel_shift))[isct.tex_offs_y];
+		if (solid_only && !(meta & (1u << 31)))
+			return 0;
+		isct = _intersect_with_metadata(isct, meta);
+		if (isct.size_x <= 0)
+			return 0;
+	}
+	else if (solid_only && !(sp->flags & SPRITE_FLAG_OPAQUE)) {
+		return 0;
 	}
+	spans[0] = sp->x + isct.tex_offs_x;
+	spans[1] = sp->x + isct.tex_offs_x + isct.size_x;
+	return 1;
+}
+
+uint __ram_func(sprite_opaque_spans)(const sprite_t *sp, uint raster_y, uint raster_w, uint pixel_shift,
+	int16_t *spans, uint max_spans) {
+	return _sprite_spans(sp, raster_y, raster_w, pixel_shift, spans, max_spans, false);
+}
+
+uint __ram_func(sprite_solid_spans)(const sprite_t *sp, uint raster_y, uint raster_w, uint pixel_shift,
+	int16_t *spans, uint max_spans) {
+	return _sprite_spans(sp, raster_y, raster_w, pixel_shift, spans, max_spans, true);
 }
 
 // We're defining the affine transform as:
@@ -101,68 +229,119 @@ void __ram_func(sprite_sprite16)(uint16_t *scanbuf, const sprite_t *sp, uint ras
 // We represent this in memory as {a00, a01, b0, a10, a11, b1} (all int32_t)
 // i.e. the non-constant parts in row-major order
 
-// Set up an interpolator to follow a straight line through u,v space
-static inline __attribute__((always_inline)) void _setup_interp_affine(interp_hw_t *interp, intersect_t isct, const affine_transform_t atrans) {
-	// Calculate the u,v coord of the first sample. Note that we are iterating
-	// *backward* along the raster span because this is faster (yes)
-	int32_t x0 =
-		mul_fp1616(atrans[0], (isct.tex_offs_x + isct.size_x) * AF_ONE) +
-		mul_fp1616(atrans[1], isct.tex_offs_y * AF_ONE) +
-		atrans[2];
-	int32_t y0 =
-		mul_fp1616(atrans[3], (isct.tex_offs_x + isct.size_x) * AF_ONE) +
-		mul_fp1616(atrans[4], isct.tex_offs_y * AF_ONE) +
-		atrans[5];
-	interp->accum[0] = x0;
-	interp->accum[1] = y0;
-	interp->base[0] = -atrans[0]; // -a00, since x decrements by 1 with each coord
-	interp->base[1] = -atrans[3]; // -a10
-}
+// Per-frame setup for affine sprites. The texture coordinate of sprite-local
+// pixel (x, y) is atrans * (x, y, 1), and the x clipping is the same on every
+// line, so the start of each line's walk (we walk *backward* from the end of
+// the clipped span, which is faster, yes) is a fixed point plus y times the
+// second column. The cache keeps that point for the last row rendered and
+// steps it by one row at a time, falling back to a multiply if rows are
+// skipped. This replaces four 64-bit multiplies and the interpolator config
+// calculation on every scanline.
+void sprite_asprite_prepare(asprite_cache_t *cache, const sprite_t *sp, const affine_transform_t atrans,
+	uint pixel_shift, uint raster_w) {
+	int x_start_clipped = MAX(0, sp->x);
+	cache->tex_offs_x = x_start_clipped - sp->x;
+	cache->size_x = MIN(sp->x + (int)sprite_w(sp), (int)raster_w) - x_start_clipped;
+	int x_end = cache->tex_offs_x + cache->size_x;
+	cache->du_dx = atrans[0];
+	cache->dv_dx = atrans[3];
+	cache->du_dy = atrans[1];
+	cache->dv_dy = atrans[4];
+	cache->u = atrans[0] * x_end + atrans[2];
+	cache->v = atrans[3] * x_end + atrans[5];
+	cache->row = 0;
 
-// Set up an interpolator to generate pixel lookup addresses from fp1616
-// numbers in accum1, accum0 based on the parameters of sprite sp and the size
-// of the individual pixels
-static inline __attribute__((always_inline)) void _setup_interp_pix_coordgen(interp_hw_t *interp, const sprite_t *sp, uint pixel_shift) {
 	// Concatenate from accum0[31:16] and accum1[31:16] as many LSBs as required
 	// to index the sprite texture in both directions. Reading from POP_FULL will
 	// yields these bits, added to sp->img, and this will also trigger BASE0 and
 	// BASE1 to be directly added (thanks to CTRL_ADD_RAW) to the accumulators,
-	// which generates the u,v coordinate for the *next* read.
-	assert(sp->log_size + pixel_shift <= 16);
+	// which generates the u,v coordinate for the *next* read. Coordinates
+	// outside of the texture set the overflow flag, which the blit loops
+	// treat as transparent.
+	uint log_w = __builtin_ctz(sprite_w(sp));
+	uint log_h = __builtin_ctz(sprite_h(sp));
+	assert(sprite_w(sp) == 1u << log_w && sprite_h(sp) == 1u << log_h && sp->stride_minus1 == sp->w_minus1);
+	assert(log_w + pixel_shift <= 16);
 
 	interp_config c0 = interp_default_config();
 	interp_config_set_add_raw(&c0, true);
 	interp_config_set_shift(&c0, 16 - pixel_shift);
-	interp_config_set_mask(&c0, pixel_shift, pixel_shift + sp->log_size - 1);
-	interp_set_config(interp, 0, &c0);
+	interp_config_set_mask(&c0, pixel_shift, pixel_shift + log_w - 1);
+	cache->ctrl[0] = c0.ctrl;
 
 	interp_config c1 = interp_default_config();
 	interp_config_set_add_raw(&c1, true);
-	interp_config_set_shift(&c1, 16 - sp->log_size - pixel_shift);
-	interp_config_set_mask(&c1, pixel_shift + sp->log_size, pixel_shift + 2 * sp->log_size - 1);
-	interp_set_config(interp, 1, &c1);
+	interp_config_set_shift(&c1, 16 - log_w - pixel_shift);
+	interp_config_set_mask(&c1, pixel_shift + log_w, pixel_shift + log_w + log_h - 1);
+	cache->ctrl[1] = c1.ctrl;
+}
+
+// Returns false if the sprite is not on this line. Otherwise interp0 is
+// ready to generate texel addresses for the clipped span, right to left.
+static inline __attribute__((always_inline)) bool _setup_interp_asprite(asprite_cache_t *cache,
+	const sprite_t *sp, uint raster_y) {
+	int ty = (int)raster_y - sp->y;
+	if ((uint)ty >= sprite_h(sp) || cache->size_x <= 0)
+		return false;
+	int d = ty - cache->row;
+	if (d == 1) {
+		cache->u += cache->du_dy;
+		cache->v += cache->dv_dy;
+	}
+	else if (d) {
+		cache->u += d * cache->du_dy;
+		cache->v += d * cache->dv_dy;
+	}
+	cache->row = ty;
 
-	interp->base[2] = (uint32_t)sp->img;
+	interp_hw_t *interp = interp0_hw;
+	interp_owner_claim(0, &sprite_interp_owner);
+	interp->ctrl[0] = cache->ctrl[0];
+	interp->ctrl[1] = cache->ctrl[1];
+	interp->accum[0] = cache->u;
+	interp->accum[1] = cache->v;
+	interp->base[0] = -cache->du_dx; // -a00, since x decrements by 1 with each coord
+	interp->base[1] = -cache->dv_dx; // -a10
+	interp->base[2] = (uintptr_t)sp->img;
+	return true;
+}
+
+// Note we do NOT save/restore the interpolator, we just claim interp0 (see
+// util_interp_owner.h) so a preserve owner on this core gets its state back.
+// Fully opaque sprites go through the non-alpha loops, which only skip
+// texels outside of the texture.
+void __ram_func(sprite_asprite8_cached)(uint8_t *scanbuf, const sprite_t *sp, asprite_cache_t *cache, uint raster_y) {
+	if (!_setup_interp_asprite(cache, sp, raster_y))
+		return;
+	uint8_t *dst = scanbuf + sp->x + cache->tex_offs_x;
+	if (sp->flags & SPRITE_FLAG_OPAQUE)
+		sprite_ablit8_loop(dst, cache->size_x);
+	else
+		sprite_ablit8_alpha_loop(dst, cache->size_x);
+}
+
+void __ram_func(sprite_asprite16_cached)(uint16_t *scanbuf, const sprite_t *sp, asprite_cache_t *cache, uint raster_y) {
+	if (!_setup_interp_asprite(cache, sp, raster_y))
+		return;
+	uint16_t *dst = scanbuf + sp->x + cache->tex_offs_x;
+	if (sp->flags & SPRITE_FLAG_OPAQUE)
+		sprite_ablit16_loop(dst, cache->size_x);
+	else
+		sprite_ablit16_alpha_loop(dst, cache->size_x);
 }
 
-// Note we do NOT save/restore the interpolator!
 void __ram_func(sprite_asprite8)(uint8_t *scanbuf, const sprite_t *sp, const affine_transform_t atrans, uint raster_y, uint raster_w) {
-	intersect_t isct = _get_sprite_intersect(sp, raster_y, raster_w);
-	if (isct.size_x <= 0)
+	if ((uint)((int)raster_y - sp->y) >= sprite_h(sp))
 		return;
-	interp_hw_t *interp = interp0_hw;
-	_setup_interp_affine(interp, isct, atrans);
-	_setup_interp_pix_coordgen(interp, sp, 0);
-	// Now every read from POP_FULL will give us a new MODE7 lookup pointer for sp->img :)
-	sprite_ablit8_alpha_loop(scanbuf + MAX(0, sp->x), isct.size_x);
+	asprite_cache_t cache;
+	sprite_asprite_prepare(&cache, sp, atrans, 0, raster_w);
+	sprite_asprite8_cached(scanbuf, sp, &cache, raster_y);
 }
 
 void __ram_func(sprite_asprite16)(uint16_t *scanbuf, const sprite_t *sp, const affine_transform_t atrans, uint raster_y, uint raster_w) {
-	intersect_t isct = _get_sprite_intersect(sp, raster_y, raster_w);
-	if (isct.size_x <= 0)
+	if ((uint)((int)raster_y - sp->y) >= sprite_h(sp))
 		return;
-	interp_hw_t *interp = interp0_hw;
-	_setup_interp_affine(interp, isct, atrans);
-	_setup_interp_pix_coordgen(interp, sp, 1);
-	sprite_ablit16_alpha_loop(scanbuf + MAX(0, sp->x), isct.size_x);
+	asprite_cache_t cache;
+	sprite_asprite_prepare(&cache, sp, atrans, 1, raster_w);
+	sprite_asprite16_cached(scanbuf, sp, &cache, raster_y);
 }
@@ -4,17 +4,86 @@
 #include "pico/types.h"
 #include "affine_transform.h"
 
-// 3 words -- any bigger and we will need to pack the flags!
+// 3 words -- any bigger and the per-scanline sprite lists get expensive, so
+// the flags are packed into one byte.
+//
+// Sprites are w x h pixels (1 to 256 each, no need to be square or a power
+// of two). Rows are stride pixels apart (also 1 to 256), so several sprites
+// can share one sprite sheet by pointing img at their top-left pixel, with
+// stride set to the sheet width; sheets are therefore at most 256 pixels
+// wide. All three are stored minus one to fit a byte each: initialise them
+// with SPRITE_DIMS() and read them with sprite_w()/sprite_h()/sprite_stride().
+//
+// With SPRITE_FLAG_OPACITY_METADATA, img is followed (after stride * h
+// pixels) by one metadata word per row, see sprite.c. This only works for
+// sprites that own their image, not for sheet sub-images. The metadata is
+// read as words, so img must be word-aligned and stride * h * bytes per
+// pixel a multiple of 4 (tools/sprite_conv.py pads the stride for this);
+// otherwise the load is unaligned and faults on the M0+.
+//
+// SPRITE_FLAG_SPAN_METADATA is the same idea with any number of opaque spans
+// per row, so sprites with holes (rings, text, dithered edges) still go
+// through the fast non-alpha blit and the gaps are skipped. Takes priority
+// over SPRITE_FLAG_OPACITY_METADATA. tools/sprite_conv.py generates both.
+//
+// The affine functions (sprite_asprite*) wrap texture coordinates with
+// interpolator masks, so they need w and h to be powers of two (up to
+// 256 x 256), and stride == w.
 typedef struct sprite {
 	int16_t x;
 	int16_t y;
 	const void *img;
-	uint8_t log_size; // always square
-	bool has_opacity_metadata;
-	bool hflip;
-	bool vflip;
+	uint8_t w_minus1;
+	uint8_t h_minus1;
+	uint8_t stride_minus1;
+	uint8_t flags;
 } sprite_t;
 
+#define SPRITE_DIMS(w, h, stride) \
+	.w_minus1 = (uint8_t)((w) - 1), .h_minus1 = (uint8_t)((h) - 1), .stride_minus1 = (uint8_t)((stride) - 1)
+
+static inline uint sprite_w(const sprite_t *sp) {
+	return sp->w_minus1 + 1u;
+}
+
+static inline uint sprite_h(const sprite_t *sp) {
+	return sp->h_minus1 + 1u;
+}
+
+static inline uint sprite_stride(const sprite_t *sp) {
+	return sp->stride_minus1 + 1u;
+}
+
+#define SPRITE_FLAG_OPACITY_METADATA 0x01u
+#define SPRITE_FLAG_HFLIP            0x02u
+#define SPRITE_FLAG_VFLIP            0x04u
+#define SPRITE_FLAG_SPAN_METADATA    0x08u
+// Every pixel has its alpha bit set: plain (and affine) blits skip the alpha
+// test entirely
+#define SPRITE_FLAG_OPAQUE           0x10u
+// Blend mode (16bpp only): draw the sprite at 25/50/75% over what's below.
+// Pixels without the alpha bit are still skipped, and opacity metadata still
+// trims the transparent parts.
+#define SPRITE_FLAG_BLEND_MASK       0x60u
+#define SPRITE_FLAG_BLEND_25         0x20u
+#define SPRITE_FLAG_BLEND_50         0x40u
+#define SPRITE_FLAG_BLEND_75         0x60u
+
+// Per-frame setup for an affine sprite, see sprite_asprite_prepare(). Valid
+// while the sprite's position, size and transform are unchanged.
+typedef struct asprite_cache {
+	uint32_t ctrl[2];
+	int16_t tex_offs_x;
+	int16_t size_x;
+	int32_t u;
+	int32_t v;
+	int32_t du_dx;
+	int32_t dv_dx;
+	int32_t du_dy;
+	int32_t dv_dy;
+	int row;
+} asprite_cache_t;
+
 // ----------------------------------------------------------------------------
 // Functions from sprite.S
 
@@ -28,12 +97,33 @@ void sprite_blit8_alpha(uint8_t *dst, const uint8_t *src, uint len);
 void sprite_blit16(uint16_t *dst, const uint16_t *src, uint len);
 void sprite_blit16_alpha(uint16_t *dst, const uint16_t *src, uint len);
 
+// Blended over dst (RGB565), the percentage is the weight of the source or
+// fill colour. The blits skip source pixels without the alpha bit.
+void sprite_fill16_blend25(uint16_t *dst, uint16_t colour, uint len);
+void sprite_fill16_blend50(uint16_t *dst, uint16_t colour, uint len);
+void sprite_fill16_blend75(uint16_t *dst, uint16_t colour, uint len);
+void sprite_blit16_blend25_alpha(uint16_t *dst, const uint16_t *src, uint len);
+void sprite_blit16_blend50_alpha(uint16_t *dst, const uint16_t *src, uint len);
+void sprite_blit16_blend75_alpha(uint16_t *dst, const uint16_t *src, uint len);
+
 // These are just inner loops, and require INTERP0 to be configured before calling:
 void sprite_ablit8_loop(uint8_t *dst, uint len);
 void sprite_ablit8_alpha_loop(uint8_t *dst, uint len);
 void sprite_ablit16_loop(uint16_t *dst, uint len);
 void sprite_ablit16_alpha_loop(uint16_t *dst, uint len);
 
+typedef void (*sprite_blit16_loop_t)(uint16_t *dst, const uint16_t *src, uint len);
+
+// Blend blit for a SPRITE_FLAG_BLEND_* value
+static inline sprite_blit16_loop_t sprite_blit16_blend_func(uint blend) {
+	switch (blend & SPRITE_FLAG_BLEND_MASK) {
+		case SPRITE_FLAG_BLEND_25: return sprite_blit16_blend25_alpha;
+		case SPRITE_FLAG_BLEND_50: return sprite_blit16_blend50_alpha;
+		case SPRITE_FLAG_BLEND_75: return sprite_blit16_blend75_alpha;
+		default: return sprite_blit16_alpha;
+	}
+}
+
 // ----------------------------------------------------------------------------
 // Functions from sprite.c
 
@@ -41,8 +131,28 @@ void sprite_ablit16_alpha_loop(uint16_t *dst, uint len);
 void sprite_sprite8(uint8_t *scanbuf, const sprite_t *sp, uint raster_y, uint raster_w);
 void sprite_sprite16(uint16_t *scanbuf, const sprite_t *sp, uint raster_y, uint raster_w);
 
+// Write the screen x [start, end) of each opaque span of the sprite on this
+// line (up to max_spans pairs) and return the number written, for collision
+// tests. pixel_shift is 0 for 8bpp images, 1 for 16bpp.
+uint sprite_opaque_spans(const sprite_t *sp, uint raster_y, uint raster_w, uint pixel_shift,
+	int16_t *spans, uint max_spans);
+
+// As above, but only spans with no transparent pixels at all (from the
+// solid bit of the metadata, or SPRITE_FLAG_OPAQUE), for occlusion culling.
+// Blended sprites have none.
+uint sprite_solid_spans(const sprite_t *sp, uint raster_y, uint raster_w, uint pixel_shift,
+	int16_t *spans, uint max_spans);
+
 // As above, but apply an affine transform on sprite texture lookups (SLOW, even with interpolator)
 void sprite_asprite8(uint8_t *scanbuf, const sprite_t *sp, const affine_transform_t atrans, uint raster_y, uint raster_w);
 void sprite_asprite16(uint16_t *scanbuf, const sprite_t *sp, const affine_transform_t atrans, uint raster_y, uint raster_w);
 
+// Faster affine sprites: prepare once per frame (pixel_shift is 0 for 8bpp, 1
+// for 16bpp), then render each line from the cache. The cache steps from one
+// row to the next, so rendering lines in order is cheapest.
+void sprite_asprite_prepare(asprite_cache_t *cache, const sprite_t *sp, const affine_transform_t atrans,
+	uint pixel_shift, uint raster_w);
+void sprite_asprite8_cached(uint8_t *scanbuf, const sprite_t *sp, asprite_cache_t *cache, uint raster_y);
+void sprite_asprite16_cached(uint16_t *scanbuf, const sprite_t *sp, asprite_cache_t *cache, uint raster_y);
+
 #endif
@@ -1,10 +1,14 @@
 #include "tile.h"
+#include "sprite.h"
 
 #include "pico.h" // for __not_in_flash
 #include "hardware/interp.h"
+#include "util_interp_owner.h"
 
 #define __ram_func(foo) __not_in_flash(#foo) foo
 
+static interp_owner_t tile_interp_owner = INTERP_OWNER_INIT("tile", false);
+
 static inline uint __attribute__((always_inline)) tile_log_size(tilesize_t size) {
 	return 3 + (int)size;
 };
@@ -19,35 +23,162 @@ static inline void setup_interp_tilemap_ptrs(interp_hw_t *interp, const uint8_t
 	interp_set_config(interp, 0, &c);
 	interp->accum[0] = x0;
 	interp->base[0] = 1;
+	// Lane 1 still feeds bit 0 of ACCUM1 into the full result, so clear it
+	// rather than trust whoever used interp1 last
 	interp->ctrl[1] = 0;
+	interp->accum[1] = 0;
 	interp->base[2] = (uintptr_t)row;
 }
 
-void __ram_func(tile16)(uint16_t *scanbuf, const tilebg_t *bg, uint raster_y, uint raster_w) {
+static inline uint get_line_xscroll(const tilebg_t *bg, uint raster_y) {
+	return bg->line_xscroll ? bg->xscroll + bg->line_xscroll[raster_y] : bg->xscroll;
+}
+
+static inline uint get_line_yscroll(const tilebg_t *bg, uint raster_y) {
+	return bg->line_yscroll ? bg->yscroll + bg->line_yscroll[raster_y] : bg->yscroll;
+}
+
+// Common part of tile8/tile16: set up interp1 for the tilemap row at this
+// raster line, and return the tileset pointer offset by the intra-tile y
+// (pixel_shift is log2 of the pixel size in bytes). Rendering starts at
+// raster x0.
+static inline __attribute__((always_inline)) const void *setup_tile_line(const tilebg_t *bg, uint raster_y,
+	uint x0, uint raster_w, uint pixel_shift, uint *tx0, uint *tx1) {
 	uint size_x_mask = (1u << bg->log_size_x) - 1;
 	uint size_y_mask = (1u << bg->log_size_y) - 1;
 	// Find render start/end point in tile space
 	// Note tx1 may be "past the end" -- that's fine, it's just used for limits
-	uint tx0 = bg->xscroll & size_x_mask;
-	uint tx1 = tx0 + raster_w;
-	uint ty = (bg->yscroll + raster_y) & size_y_mask;
+	*tx0 = (get_line_xscroll(bg, raster_y) + x0) & size_x_mask;
+	*tx1 = *tx0 + raster_w;
+	uint ty = (get_line_yscroll(bg, raster_y) + raster_y) & size_y_mask;
 
 	const uint8_t *tilemap_row_ty = bg->tilemap + (ty >> tile_log_size(bg->tilesize)
 		<< (bg->log_size_x - tile_log_size(bg->tilesize)));
-	uint tile_x_at_tx0 = tx0 >> tile_log_size(bg->tilesize);
+	uint tile_x_at_tx0 = *tx0 >> tile_log_size(bg->tilesize);
 	uint tile_x_msb = bg->log_size_x - tile_log_size(bg->tilesize) - 1;
 
-	// NOTE this clobbers interp1, currently this will cause issues if you try
-	// to run tile code and certain TMDS encode loops on the same core. Could
-	// be fixed by save/restore, at the cost of some performance.
+	// interp1 is reconfigured on every call, so it's claimed without asking
+	// for its state to be kept (see util_interp_owner.h). This is what lets
+	// tile rendering share a core with the TMDS encoders.
+	interp_owner_claim(1, &tile_interp_owner);
 	setup_interp_tilemap_ptrs(interp1_hw, tilemap_row_ty, tile_x_at_tx0, tile_x_msb);
 
 	// Apply intra-tile y offset in advance, since this will be the same for
 	// all pixels of all tiles we render in this call.
 	uint tilesize = 1u << tile_log_size(bg->tilesize);
-	const uint16_t *tileset_y_offs = (const uint16_t*)bg->tileset +
-		(ty & (tilesize - 1)) * tilesize;
+	return (const uint8_t*)bg->tileset + ((ty & (tilesize - 1)) * tilesize << pixel_shift);
+}
+
+void __ram_func(tile8)(uint8_t *scanbuf, const tilebg_t *bg, uint raster_y, uint raster_w) {
+	if (!tilebg_line_enabled(bg, raster_y))
+		return;
+	uint tx0, tx1;
+	const uint8_t *tileset_y_offs = setup_tile_line(bg, raster_y, 0, raster_w, 0, &tx0, &tx1);
+	tile8_loop_t loop = (tile8_loop_t)bg->fill_loop;
+	loop(scanbuf, tileset_y_offs, tx0, tx1);
+}
 
+void __ram_func(tile16)(uint16_t *scanbuf, const tilebg_t *bg, uint raster_y, uint raster_w) {
+	if (!tilebg_line_enabled(bg, raster_y))
+		return;
+	uint tx0, tx1;
+	const uint16_t *tileset_y_offs = setup_tile_line(bg, raster_y, 0, raster_w, 1, &tx0, &tx1);
 	tile16_loop_t loop = (tile16_loop_t)bg->fill_loop;
 	loop(scanbuf, tileset_y_offs, tx0, tx1);
 }
+
+void __ram_func(tile16_blend)(uint16_t *scanbuf, uint16_t *tmp, const tilebg_t *bg, uint raster_y, uint raster_w, uint blend) {
+	if (!tilebg_line_enabled(bg, raster_y))
+		return;
+	tile16(tmp, bg, raster_y, raster_w);
+	sprite_blit16_blend_func(blend)(scanbuf, tmp, raster_w);
+}
+
+// The loops copy single pixels up to the first tile boundary before they
+// look at x1 (see tile.S), so a range that starts and ends inside the same
+// tile would be overdrawn to the right. Those go through a tile-sized
+// buffer, preloaded with the destination for the alpha loops.
+static inline bool range_inside_tile(uint tx0, uint tx1, tilesize_t size) {
+	uint mask = (1u << tile_log_size(size)) - 1;
+	return (tx0 & mask) && tx1 < (tx0 | mask) + 1;
+}
+
+void __ram_func(tile8_range)(uint8_t *scanbuf, const tilebg_t *bg, uint raster_y, uint x0, uint x1) {
+	if (x1 <= x0 || !tilebg_line_enabled(bg, raster_y))
+		return;
+	uint tx0, tx1;
+	const uint8_t *tileset_y_offs = setup_tile_line(bg, raster_y, x0, x1 - x0, 0, &tx0, &tx1);
+	tile8_loop_t loop = (tile8_loop_t)bg->fill_loop;
+	if (range_inside_tile(tx0, tx1, bg->tilesize)) {
+		uint8_t tmp[16];
+		sprite_blit8(tmp, scanbuf + x0, x1 - x0);
+		loop(tmp, tileset_y_offs, tx0, tx1);
+		sprite_blit8(scanbuf + x0, tmp, x1 - x0);
+		return;
+	}
+	loop(scanbuf + x0, tileset_y_offs, tx0, tx1);
+}
+
+void __ram_func(tile16_range)(uint16_t *scanbuf, const tilebg_t *bg, uint raster_y, uint x0, uint x1) {
+	if (x1 <= x0 || !tilebg_line_enabled(bg, raster_y))
+		return;
+	uint tx0, tx1;
+	const uint16_t *tileset_y_offs = setup_tile_line(bg, raster_y, x0, x1 - x0, 1, &tx0, &tx1);
+	tile16_loop_t loop = (tile16_loop_t)bg->fill_loop;
+	if (range_inside_tile(tx0, tx1, bg->tilesize)) {
+		uint16_t tmp[16];
+		sprite_blit16(tmp, scanbuf + x0, x1 - x0);
+		loop(tmp, tileset_y_offs, tx0, tx1);
+		sprite_blit16(scanbuf + x0, tmp, x1 - x0);
+		return;
+	}
+	loop(scanbuf + x0, tileset_y_offs, tx0, tx1);
+}
+
+// Walk the tilemap row under this line one tile at a time (no interpolator,
+// this runs alongside rendering) and merge runs of opaque tiles.
+uint __ram_func(tilebg_opaque_spans)(const tilebg_t *bg, const uint32_t *opaque_tiles, uint raster_y, uint raster_w,
+	int16_t *spans, uint max_spans) {
+	if (!max_spans || !tilebg_line_enabled(bg, raster_y))
+		return 0;
+	uint log_tile = tile_log_size(bg->tilesize);
+	uint tilesize = 1u << log_tile;
+	uint tx = get_line_xscroll(bg, raster_y) & ((1u << bg->log_size_x) - 1);
+	uint ty = (get_line_yscroll(bg, raster_y) + raster_y) & ((1u << bg->log_size_y) - 1);
+	uint map_x_mask = (1u << (bg->log_size_x - log_tile)) - 1;
+	const uint8_t *row = bg->tilemap + (ty >> log_tile << (bg->log_size_x - log_tile));
+	uint tile_x = tx >> log_tile;
+	uint n = 0;
+	// x is the screen position of the left edge of the current tile
+	for (int x = -(int)(tx & (tilesize - 1)); x < (int)raster_w; x += tilesize, tile_x = (tile_x + 1) & map_x_mask) {
+		uint t = row[tile_x];
+		if (!(opaque_tiles[t >> 5] >> (t & 31) & 1u))
+			continue;
+		int start = MAX(x, 0);
+		int end = MIN(x + (int)tilesize, (int)raster_w);
+		if (n && spans[2 * n - 1] == start) {
+			spans[2 * n - 1] = end;
+		}
+		else {
+			if (n == max_spans)
+				break;
+			spans[2 * n] = start;
+			spans[2 * n + 1] = end;
+			++n;
+		}
+	}
+	return n;
+}
+
+void tile16_opaque_tiles(const uint16_t *tileset, uint n_tiles, tilesize_t tilesize, uint32_t *opaque_tiles) {
+	uint px_per_tile = 1u << (2 * tile_log_size(tilesize));
+	for (uint t = 0; t < n_tiles; ++t) {
+		bool opaque = true;
+		for (uint i = 0; i < px_per_tile && opaque; ++i)
+			opaque = tileset[t * px_per_tile + i] & (1u << 5); // RGAB5515 alpha
+		if (opaque)
+			opaque_tiles[t >> 5] |= 1u << (t & 31);
+		else
+			opaque_tiles[t >> 5] &= ~(1u << (t & 31));
+	}
+}
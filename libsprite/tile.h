@@ -21,6 +21,16 @@ typedef void (*tile_loop_t)(void *dst, const void *tileset, uint x0, uint x1);
 // Instead, the creator of the tilebg object explicitly adds references to
 // the appropriate fill routine symbols when configuring the tilebgs.
 
+// Raster effects: the optional per-line tables are indexed by raster line
+// and read as each line is rendered, so they can be changed between frames
+// (or ahead of the raster) without touching the tilemap:
+//
+// - line_xscroll/line_yscroll are added to xscroll/yscroll on that line, for
+//   parallax bands, wavy distortion or a split-screen status bar (point
+//   those lines at a fixed part of the map and cancel the scroll).
+// - line_enable has one bit per raster line (bit y & 31 of word y >> 5);
+//   the layer is not drawn on lines whose bit is clear.
+
 typedef struct tilebg {
 	uint16_t xscroll;
 	uint16_t yscroll;
@@ -30,8 +40,15 @@ typedef struct tilebg {
 	uint8_t log_size_y;
 	tilesize_t tilesize;
 	tile_loop_t fill_loop;
+	const int16_t *line_xscroll;
+	const int16_t *line_yscroll;
+	const uint32_t *line_enable;
 } tilebg_t;
 
+static inline bool tilebg_line_enabled(const tilebg_t *bg, uint raster_y) {
+	return !bg->line_enable || (bg->line_enable[raster_y >> 5] >> (raster_y & 31) & 1u);
+}
+
 // ----------------------------------------------------------------------------
 // Functions from tile.S
 
@@ -41,12 +58,43 @@ typedef void (*tile8_loop_t)(uint8_t *dst, const uint8_t *tileset, uint x0, uint
 
 void tile16_16px_alpha_loop(uint16_t *dst, const uint16_t *tileset, uint x0, uint x1);
 void tile16_16px_loop(uint16_t *dst, const uint16_t *tileset, uint x0, uint x1);
+void tile16_8px_alpha_loop(uint16_t *dst, const uint16_t *tileset, uint x0, uint x1);
+void tile16_8px_loop(uint16_t *dst, const uint16_t *tileset, uint x0, uint x1);
+
+// 8bpp (e.g. RGB332 for dvi_scanbuf_main_8bpp, or RAGB2132 for alpha):
+void tile8_16px_alpha_loop(uint8_t *dst, const uint8_t *tileset, uint x0, uint x1);
+void tile8_16px_loop(uint8_t *dst, const uint8_t *tileset, uint x0, uint x1);
+void tile8_8px_alpha_loop(uint8_t *dst, const uint8_t *tileset, uint x0, uint x1);
+void tile8_8px_loop(uint8_t *dst, const uint8_t *tileset, uint x0, uint x1);
 
 // ----------------------------------------------------------------------------
 // Functions from tile.c
 
+// bg->fill_loop must match the pixel size of the function called (and the
+// tile size in bg->tilesize). Nothing is drawn on lines disabled by
+// bg->line_enable:
+void tile8(uint8_t *scanbuf, const tilebg_t *bg, uint raster_y, uint raster_w);
 void tile16(uint16_t *scanbuf, const tilebg_t *bg, uint raster_y, uint raster_w);
 
+// Translucent layer: render into tmp (raster_w pixels, word-aligned like
+// scanbuf), then blend over scanbuf with a SPRITE_FLAG_BLEND_* mode. Use a
+// non-alpha fill loop; pixels without the alpha bit are skipped by the blend.
+void tile16_blend(uint16_t *scanbuf, uint16_t *tmp, const tilebg_t *bg, uint raster_y, uint raster_w, uint blend);
+
+// Render only raster x [x0, x1) of the line (scanbuf is still the start of
+// the line), e.g. the parts of a layer not covered by the layers above it.
+void tile8_range(uint8_t *scanbuf, const tilebg_t *bg, uint raster_y, uint x0, uint x1);
+void tile16_range(uint16_t *scanbuf, const tilebg_t *bg, uint raster_y, uint x0, uint x1);
+
+// Opacity per tile: opaque_tiles has one bit per tileset index (bit t & 31
+// of word t >> 5), set for tiles with no transparent pixels.
+// tilebg_opaque_spans() writes the raster x [start, end) of each run of
+// opaque tiles on this line (up to max_spans pairs) and returns the number
+// written. tile16_opaque_tiles() fills in the bits from an RGAB5515 tileset.
+uint tilebg_opaque_spans(const tilebg_t *bg, const uint32_t *opaque_tiles, uint raster_y, uint raster_w,
+	int16_t *spans, uint max_spans);
+void tile16_opaque_tiles(const uint16_t *tileset, uint n_tiles, tilesize_t tilesize, uint32_t *opaque_tiles);
+
 
 
 #endif
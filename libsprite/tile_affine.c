@@ -0,0 +1,98 @@
+#include "tile_affine.h"
+
+#include "pico.h" // for __not_in_flash
+#include "hardware/interp.h"
+#include "util_interp_owner.h"
+
+#define __ram_func(foo) __not_in_flash(#foo) foo
+
+static interp_owner_t tile_affine_interp_owner = INTERP_OWNER_INIT("tile_affine", false);
+
+// Both interpolators follow the same line through u,v space (accumulators
+// are u, v and bases are du, dv, added raw on every pop), but extract
+// different bits of it:
+//
+// - interp0: tile x, tile y, concatenated and added to the tilemap base,
+//   giving a pointer to the tilemap entry
+// - interp1: intra-tile x, y concatenated and scaled by the pixel size,
+//   giving the byte offset into the tile image
+static inline __attribute__((always_inline)) void setup_interp_affine_tile(const tilebg_affine_t *bg,
+	const affine_line_t *line, uint pixel_shift) {
+	uint log_tile = 3 + (uint)bg->tilesize;
+	assert(bg->log_size_x > log_tile && bg->log_size_y > log_tile);
+	uint log_w = bg->log_size_x - log_tile;
+	uint log_h = bg->log_size_y - log_tile;
+
+	interp_owner_claim(0, &tile_affine_interp_owner);
+	interp_owner_claim(1, &tile_affine_interp_owner);
+
+	interp_config c = interp_default_config();
+	interp_config_set_add_raw(&c, true);
+	interp_config_set_shift(&c, 16 + log_tile);
+	interp_config_set_mask(&c, 0, log_w - 1);
+	interp_set_config(interp0_hw, 0, &c);
+	interp_config_set_shift(&c, 16 + log_tile - log_w);
+	interp_config_set_mask(&c, log_w, log_w + log_h - 1);
+	interp_set_config(interp0_hw, 1, &c);
+
+	interp_config_set_shift(&c, 16 - pixel_shift);
+	interp_config_set_mask(&c, pixel_shift, pixel_shift + log_tile - 1);
+	interp_set_config(interp1_hw, 0, &c);
+	interp_config_set_shift(&c, 16 - log_tile - pixel_shift);
+	interp_config_set_mask(&c, pixel_shift + log_tile, pixel_shift + 2 * log_tile - 1);
+	interp_set_config(interp1_hw, 1, &c);
+
+	interp0_hw->accum[0] = interp1_hw->accum[0] = line->u0;
+	interp0_hw->accum[1] = interp1_hw->accum[1] = line->v0;
+	interp0_hw->base[0] = interp1_hw->base[0] = line->du;
+	interp0_hw->base[1] = interp1_hw->base[1] = line->dv;
+	interp0_hw->base[2] = (uintptr_t)bg->tilemap;
+	interp1_hw->base[2] = 0;
+}
+
+void __ram_func(tile_affine8)(uint8_t *scanbuf, const tilebg_affine_t *bg, uint raster_y, uint raster_w) {
+	setup_interp_affine_tile(bg, &bg->lines[raster_y], 0);
+	bg->fill_loop(scanbuf, bg->tileset, raster_w);
+}
+
+void __ram_func(tile_affine16)(uint16_t *scanbuf, const tilebg_affine_t *bg, uint raster_y, uint raster_w) {
+	setup_interp_affine_tile(bg, &bg->lines[raster_y], 1);
+	bg->fill_loop(scanbuf, bg->tileset, raster_w);
+}
+
+// The screen pixel (x, y) maps to atrans * (x, y, 1), so stepping x by one
+// adds the first column of the matrix.
+void __ram_func(tile_affine_line_from_transform)(affine_line_t *line, const affine_transform_t atrans, uint raster_y) {
+	line->u0 = atrans[1] * (int32_t)raster_y + atrans[2];
+	line->v0 = atrans[4] * (int32_t)raster_y + atrans[5];
+	line->du = atrans[0];
+	line->dv = atrans[3];
+}
+
+void tile_affine_lines_from_transform(affine_line_t *lines, const affine_transform_t atrans, uint y_first, uint y_end) {
+	for (uint y = y_first; y < y_end; ++y)
+		tile_affine_line_from_transform(&lines[y], atrans, y);
+}
+
+// A raster line dy pixels below the horizon sees the floor at distance
+// height * focal / dy, where one screen pixel spans height / dy map pixels.
+// The line is centred on the heading and runs perpendicular to it. In RAM
+// (as is the single-line transform version) so it can be called from the
+// scanline callback.
+void __ram_func(tile_affine_line_perspective)(affine_line_t *line, const affine_camera_t *cam, int horizon, uint raster_y, uint raster_w) {
+	int dy = (int)raster_y - horizon;
+	if (dy <= 0)
+		return;
+	int32_t scale = cam->height / dy;
+	// scale * focal passes 32 bits just below the horizon with a high camera
+	// or a long focal, so the start point is worked out in 64 bits. Cutting
+	// it back to 32 bits only wraps it around the map, which repeats anyway.
+	int64_t dist = (int64_t)scale * cam->focal;
+	int32_t c = cos_fp1616(cam->theta);
+	int32_t s = sin_fp1616(cam->theta);
+	line->du = -mul_fp1616(s, scale);
+	line->dv = mul_fp1616(c, scale);
+	int64_t half_w = raster_w / 2;
+	line->u0 = (int32_t)(cam->u + ((c * dist) >> 16) - line->du * half_w);
+	line->v0 = (int32_t)(cam->v + ((s * dist) >> 16) - line->dv * half_w);
+}
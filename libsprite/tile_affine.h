@@ -0,0 +1,84 @@
+#ifndef _TILE_AFFINE_H
+#define _TILE_AFFINE_H
+
+#include "pico/types.h"
+#include "affine_transform.h"
+#include "tile.h"
+
+// Affine ("mode 7") tilemap background. Each raster line samples the
+// tilemap along a straight line in u,v space: starting at (u0, v0) for the
+// leftmost pixel and stepping (du, dv) per pixel, all signed 16.16 in
+// tilemap pixels. The map wraps at its edges.
+//
+// The per-line values come from a table with one entry per raster line, so
+// a rotated/scaled layer, a perspective floor (the scale changes with y) and
+// per-line raster effects are all just different table contents. The table
+// is only read when the line is rendered, so it can be rewritten line by
+// line from the DVI scanline callback, e.g. filling in next frame's entry
+// for each line as it is displayed, instead of all at once in vblank.
+//
+// Tileset and tilemap layout are the same as for tilebg_t, with log_size_x/y
+// the map size in pixels. The map must be at least two tiles each way.
+
+typedef struct affine_line {
+	int32_t u0;
+	int32_t v0;
+	int32_t du;
+	int32_t dv;
+} affine_line_t;
+
+// As with tilebg_t, the fill loop is chosen by the creator so unused loops
+// can be garbage collected.
+typedef void (*tile_affine_loop_t)(void *dst, const void *tileset, uint len);
+
+typedef struct tilebg_affine {
+	const void *tileset;
+	const uint8_t *tilemap;
+	uint8_t log_size_x;
+	uint8_t log_size_y;
+	tilesize_t tilesize;
+	tile_affine_loop_t fill_loop;
+	const affine_line_t *lines;
+} tilebg_affine_t;
+
+// Perspective floor camera for tile_affine_lines_perspective(). Position is
+// 16.16 in tilemap pixels, height is 16.16 pixels above the map, focal is the
+// distance to the screen in screen pixels, and theta is the heading (256 = one
+// turn, 0 = looking along +u).
+typedef struct affine_camera {
+	int32_t u;
+	int32_t v;
+	int32_t height;
+	uint16_t focal;
+	uint8_t theta;
+} affine_camera_t;
+
+// ----------------------------------------------------------------------------
+// Functions from tile_affine.S
+
+void tile16_affine_16px_alpha_loop(uint16_t *dst, const uint16_t *tileset, uint len);
+void tile16_affine_16px_loop(uint16_t *dst, const uint16_t *tileset, uint len);
+void tile16_affine_8px_alpha_loop(uint16_t *dst, const uint16_t *tileset, uint len);
+void tile16_affine_8px_loop(uint16_t *dst, const uint16_t *tileset, uint len);
+
+void tile8_affine_16px_alpha_loop(uint8_t *dst, const uint8_t *tileset, uint len);
+void tile8_affine_16px_loop(uint8_t *dst, const uint8_t *tileset, uint len);
+void tile8_affine_8px_alpha_loop(uint8_t *dst, const uint8_t *tileset, uint len);
+void tile8_affine_8px_loop(uint8_t *dst, const uint8_t *tileset, uint len);
+
+// ----------------------------------------------------------------------------
+// Functions from tile_affine.c
+
+// Render bg->lines[raster_y] into the first raster_w pixels of scanbuf. Uses
+// both interpolators. bg->fill_loop must match the pixel size and tile size.
+void tile_affine8(uint8_t *scanbuf, const tilebg_affine_t *bg, uint raster_y, uint raster_w);
+void tile_affine16(uint16_t *scanbuf, const tilebg_affine_t *bg, uint raster_y, uint raster_w);
+
+// Line table helpers. atrans maps screen space to map space, as for
+// sprite_asprite*; for the perspective floor, lines at or above the horizon
+// are left alone (render something else there).
+void tile_affine_line_from_transform(affine_line_t *line, const affine_transform_t atrans, uint raster_y);
+void tile_affine_lines_from_transform(affine_line_t *lines, const affine_transform_t atrans, uint y_first, uint y_end);
+void tile_affine_line_perspective(affine_line_t *line, const affine_camera_t *cam, int horizon, uint raster_y, uint raster_w);
+
+#endif
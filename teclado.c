@@ -1,7 +1,13 @@
 #include <stdio.h>
 #include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
 #include "hardware/uart.h"
 
+#include "keypad.h"
+#include "keypad_proto.h"
+
 #define ROWS 4
 #define COLS 4
 
@@ -9,9 +15,12 @@
 #define UART_RX_PIN 0
 #define UART_TX_PIN 1
 
+#define LED_PIN 13
+
 const uint8_t row_pins[ROWS] = {16, 9, 8, 4};
 const uint8_t col_pins[COLS] = {17, 18, 19, 20};
 
+// Indexado [coluna][linha], conforme a fiação do teclado
 const char key_map[ROWS][COLS] = {
     {'0', '*', 'D', '#'},
     {'7', '8', '9', 'C'},
@@ -19,62 +28,124 @@ const char key_map[ROWS][COLS] = {
     {'1', '2', '3', 'A'}
 };
 
-void pad_init() {
-    for (int i = 0; i < ROWS; i++) {
-        gpio_init(row_pins[i]);
-        gpio_set_dir(row_pins[i], GPIO_OUT);
-        gpio_put(row_pins[i], 1);
-    }
-    for (int i = 0; i < COLS; i++) {
-        gpio_init(col_pins[i]);
-        gpio_set_dir(col_pins[i], GPIO_IN);
-        gpio_pull_up(col_pins[i]);
-    }
-}
-
-char scan_pad() {
-    for (int row = 0; row < ROWS; row++) {
-        gpio_put(row_pins[row], 0);
-        for (int col = 0; col < COLS; col++) {
-            if (gpio_get(col_pins[col]) == 0) {
-                sleep_ms(50); // debounce
-                while (gpio_get(col_pins[col]) == 0);
-                gpio_put(row_pins[row], 1);
-                return key_map[col][row]; 
-            }
-        }
-        gpio_put(row_pins[row], 1);
-    }
-    return '\0';
-}
-
 void uart_handler_init(uart_inst_t *uart_id, uint tx_pin, uint rx_pin) {
     uart_init(uart_id, 115200);
     gpio_set_function(tx_pin, GPIO_FUNC_UART);
     gpio_set_function(rx_pin, GPIO_FUNC_UART);
 }
 
-void uart_handler_send(uart_inst_t *uart_id, const char *msg) {
-    uart_puts(uart_id, msg);
+// ----------------------------------------------------------------------------
+// Transmissão em quadros (keypad_proto.h) por DMA
+//
+// Os eventos se acumulam em tx_sender. Se o DMA está livre, o quadro é
+// montado e enviado na hora; se não, os eventos que chegarem enquanto o
+// quadro anterior sai pela UART viram um único quadro, enviado pela IRQ de
+// fim do DMA. O laço de varredura nunca espera a UART, exceto se
+// KP_MAX_EVENTS eventos se acumularem durante um único quadro (~4 ms).
+
+static int tx_dma_chan;
+static uint8_t tx_buf[2][KP_FRAME_MAX_BYTES];
+static uint tx_buf_next;
+static kp_sender_t tx_sender;
+static volatile bool tx_busy;
+
+// Chamar com as interrupções desabilitadas e eventos pendentes
+static void tx_start_frame(void) {
+    uint8_t *buf = tx_buf[tx_buf_next];
+    tx_buf_next ^= 1;
+    size_t len = kp_sender_build(&tx_sender, buf, time_us_32());
+    tx_busy = true;
+    dma_channel_transfer_from_buffer_now(tx_dma_chan, buf, len);
+}
+
+static void tx_dma_irq_handler(void) {
+    if (!dma_channel_get_irq0_status(tx_dma_chan))
+        return;
+    dma_channel_acknowledge_irq0(tx_dma_chan);
+    tx_busy = false;
+    if (tx_sender.n_pending)
+        tx_start_frame();
+}
+
+static void tx_init(uart_inst_t *uart_id) {
+    kp_sender_init(&tx_sender);
+    tx_dma_chan = dma_claim_unused_channel(true);
+    dma_channel_config c = dma_channel_get_default_config(tx_dma_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, uart_get_dreq(uart_id, true));
+    dma_channel_configure(tx_dma_chan, &c, &uart_get_hw(uart_id)->dr, NULL, 0, false);
+    irq_add_shared_handler(DMA_IRQ_0, tx_dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    dma_channel_set_irq0_enabled(tx_dma_chan, true);
+    irq_set_enabled(DMA_IRQ_0, true);
+}
+
+static void tx_queue_event(char key, bool pressed, uint32_t time_us) {
+    while (true) {
+        uint32_t save = save_and_disable_interrupts();
+        bool queued = kp_sender_queue(&tx_sender, (uint8_t)key, pressed ? KP_EVENT_PRESSED : 0, time_us);
+        // Quadro cheio com o DMA parado: ninguém mais vai esvaziá-lo, então
+        // envia o que está acumulado
+        if (!queued && !tx_busy)
+            tx_start_frame();
+        restore_interrupts(save);
+        if (queued)
+            return;
+        // Espera o quadro atual terminar
+        while (tx_busy)
+            tight_loop_contents();
+    }
+}
+
+// Envia o que estiver acumulado, se o DMA estiver livre
+static void tx_flush(void) {
+    uint32_t save = save_and_disable_interrupts();
+    if (!tx_busy && tx_sender.n_pending)
+        tx_start_frame();
+    restore_interrupts(save);
 }
 
 int main() {
     stdio_init_all();
-    pad_init();
     uart_handler_init(UART_ID, UART_TX_PIN, UART_RX_PIN);
 
-    gpio_init(13);
-    gpio_set_dir(13, GPIO_OUT);
-    gpio_put(13, 0);
+    gpio_init(LED_PIN);
+    gpio_set_dir(LED_PIN, GPIO_OUT);
+    gpio_put(LED_PIN, 0);
 
-    while (true) {
-        char key = scan_pad();
-        if (key != '\0') {
-            gpio_put(13, 1);
-            char str[3] = {key, '\n', '\0'}; 
-            uart_handler_send(UART_ID, str);
+    // Varredura por timer: 1 ms por matriz, 4 leituras de debounce
+    const keypad_config_t pad_cfg = {
+        .row_pins = row_pins,
+        .col_pins = col_pins,
+        .n_rows = ROWS,
+        .n_cols = COLS,
+        .scan_period_us = KEYPAD_DEFAULT_SCAN_PERIOD_US,
+        .debounce_scans = KEYPAD_DEFAULT_DEBOUNCE_SCANS,
+        .ghost_filter = true,
+    };
+    if (!keypad_init(&pad_cfg)) {
+        // Sem alarme livre ou configuração inválida: sem varredura não há o
+        // que enviar, então só sinaliza o erro (LED piscando e serial USB)
+        for (bool led = true; ; led = !led) {
+            printf("keypad_init falhou: sem alarme livre ou configuração inválida\n");
+            gpio_put(LED_PIN, led);
+            sleep_ms(500);
         }
-        sleep_ms(200);
-        gpio_put(13, 0);
     }
-}
\ No newline at end of file
+
+    tx_init(UART_ID);
+
+    // O laço só dorme até o próximo evento; teclas seguradas não bloqueiam
+    // as outras, e os eventos pendentes na fila vão juntos num quadro
+    while (true) {
+        keypad_event_t ev;
+        keypad_wait_event(&ev);
+        do {
+            tx_queue_event(key_map[ev.col][ev.row], ev.pressed, ev.time_us);
+        } while (keypad_get_event(&ev));
+        tx_flush();
+        // LED aceso enquanto houver tecla pressionada
+        gpio_put(LED_PIN, keypad_pressed_mask() != 0);
+    }
+}
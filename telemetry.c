@@ -0,0 +1,173 @@
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "hardware/watchdog.h"
+#include "hardware/structs/vreg_and_chip_reset.h"
+
+#include "telemetry.h"
+
+#define TEL_SCRATCH_WD_RESETS   0
+#define TEL_SCRATCH_HISTORY     1
+#define TEL_SCRATCH_MAX_HB_AGE  2
+#define TEL_SCRATCH_LAST_FEED   3
+
+// ----------------------------------------------------------------------------
+// Histogramas
+
+void tel_hist_reset(tel_hist_t *h) {
+    h->count = 0;
+    h->min_us = UINT32_MAX;
+    h->max_us = 0;
+    for (uint i = 0; i < TEL_HIST_N_BUCKETS; ++i)
+        h->buckets[i] = 0;
+}
+
+static inline uint tel_hist_bucket(uint32_t us) {
+    if (us < (1u << TEL_HIST_SUB_BITS))
+        return us;
+    uint log2 = 31 - __builtin_clz(us);
+    if (log2 >= TEL_HIST_MAX_LOG2)
+        return TEL_HIST_N_BUCKETS - 1;
+    uint sub = (us >> (log2 - TEL_HIST_SUB_BITS)) & ((1u << TEL_HIST_SUB_BITS) - 1);
+    return ((log2 - TEL_HIST_SUB_BITS + 1) << TEL_HIST_SUB_BITS) + sub;
+}
+
+// Menor valor que cai na faixa i
+static uint32_t tel_hist_bucket_floor(uint i) {
+    if (i < (1u << TEL_HIST_SUB_BITS))
+        return i;
+    uint log2 = (i >> TEL_HIST_SUB_BITS) + TEL_HIST_SUB_BITS - 1;
+    uint sub = i & ((1u << TEL_HIST_SUB_BITS) - 1);
+    return ((1u << TEL_HIST_SUB_BITS) + sub) << (log2 - TEL_HIST_SUB_BITS);
+}
+
+void tel_hist_add(tel_hist_t *h, uint32_t us) {
+    h->buckets[tel_hist_bucket(us)]++;
+    h->count++;
+    if (us < h->min_us)
+        h->min_us = us;
+    if (us > h->max_us)
+        h->max_us = us;
+}
+
+uint32_t tel_hist_percentile_us(const tel_hist_t *h, uint permille) {
+    uint32_t count = h->count;
+    if (!count)
+        return 0;
+    // Posição (arredondada para cima) da amostra do percentil
+    uint32_t target = (uint32_t)(((uint64_t)count * permille + 999) / 1000);
+    if (target == 0)
+        target = 1;
+    uint32_t seen = 0;
+    for (uint i = 0; i < TEL_HIST_N_BUCKETS; ++i) {
+        seen += h->buckets[i];
+        if (seen >= target) {
+            uint32_t upper = i + 1 < TEL_HIST_N_BUCKETS ? tel_hist_bucket_floor(i + 1) - 1 : UINT32_MAX;
+            return MIN(upper, h->max_us);
+        }
+    }
+    return h->max_us;
+}
+
+void tel_hist_print(const tel_hist_t *h) {
+    if (!h->count) {
+        printf("%-16s sem amostras\n", h->name);
+        return;
+    }
+    printf("%-16s n=%-8lu min=%-8lu p50=%-8lu p99=%-8lu max=%lu us\n",
+        h->name,
+        (unsigned long)h->count,
+        (unsigned long)h->min_us,
+        (unsigned long)tel_hist_percentile_us(h, 500),
+        (unsigned long)tel_hist_percentile_us(h, 990),
+        (unsigned long)h->max_us
+    );
+}
+
+// ----------------------------------------------------------------------------
+// Causa de reset e dados persistentes
+
+static const char *const tel_reset_cause_names[TEL_RESET_CAUSE_COUNT] = {
+    [TEL_RESET_UNKNOWN]          = "desconhecida",
+    [TEL_RESET_POWER_ON]         = "power-on/brown-out",
+    [TEL_RESET_RUN_PIN]          = "pino RUN",
+    [TEL_RESET_DEBUGGER]         = "depurador",
+    [TEL_RESET_WATCHDOG_TIMEOUT] = "timeout do watchdog",
+    [TEL_RESET_WATCHDOG_REBOOT]  = "watchdog_reboot()",
+};
+
+const char *tel_reset_cause_str(tel_reset_cause_t cause) {
+    return cause < TEL_RESET_CAUSE_COUNT ? tel_reset_cause_names[cause] : "?";
+}
+
+static tel_reset_cause_t tel_detect_reset_cause(void) {
+    // O reset por watchdog não é um reset de chip, então CHIP_RESET ainda
+    // reflete o reset anterior: o watchdog tem de ser testado primeiro.
+    if (watchdog_enable_caused_reboot())
+        return TEL_RESET_WATCHDOG_TIMEOUT;
+    if (watchdog_caused_reboot())
+        return TEL_RESET_WATCHDOG_REBOOT;
+    uint32_t chip_reset = vreg_and_chip_reset_hw->chip_reset;
+    if (chip_reset & VREG_AND_CHIP_RESET_CHIP_RESET_HAD_PSM_RESTART_BITS)
+        return TEL_RESET_DEBUGGER;
+    if (chip_reset & VREG_AND_CHIP_RESET_CHIP_RESET_HAD_RUN_BITS)
+        return TEL_RESET_RUN_PIN;
+    if (chip_reset & VREG_AND_CHIP_RESET_CHIP_RESET_HAD_POR_BITS)
+        return TEL_RESET_POWER_ON;
+    return TEL_RESET_UNKNOWN;
+}
+
+void tel_boot_record(tel_boot_info_t *info) {
+    info->cause = tel_detect_reset_cause();
+    bool by_watchdog = info->cause == TEL_RESET_WATCHDOG_TIMEOUT || info->cause == TEL_RESET_WATCHDOG_REBOOT;
+
+    uint32_t max_hb_age = watchdog_hw->scratch[TEL_SCRATCH_MAX_HB_AGE];
+    info->prev_max_hb_age_ms[0] = max_hb_age >> 16;
+    info->prev_max_hb_age_ms[1] = max_hb_age & 0xffffu;
+    info->prev_last_feed_ms = watchdog_hw->scratch[TEL_SCRATCH_LAST_FEED];
+
+    if (by_watchdog) {
+        info->watchdog_reset_count = watchdog_hw->scratch[TEL_SCRATCH_WD_RESETS] + 1;
+        info->history = watchdog_hw->scratch[TEL_SCRATCH_HISTORY] << 4 | info->cause;
+    }
+    else {
+        // Os scratch só sobrevivem a resets do watchdog: em qualquer outra
+        // causa o conteúdo não é confiável e o histórico recomeça.
+        info->watchdog_reset_count = 0;
+        info->history = info->cause;
+        info->prev_max_hb_age_ms[0] = 0;
+        info->prev_max_hb_age_ms[1] = 0;
+        info->prev_last_feed_ms = 0;
+    }
+    watchdog_hw->scratch[TEL_SCRATCH_WD_RESETS] = info->watchdog_reset_count;
+    watchdog_hw->scratch[TEL_SCRATCH_HISTORY] = info->history;
+    watchdog_hw->scratch[TEL_SCRATCH_MAX_HB_AGE] = 0;
+    watchdog_hw->scratch[TEL_SCRATCH_LAST_FEED] = 0;
+}
+
+void tel_boot_print(const tel_boot_info_t *info) {
+    printf("Causa do reset: %s\n", tel_reset_cause_str(info->cause));
+    printf("Resets por watchdog: %lu\n", (unsigned long)info->watchdog_reset_count);
+    printf("Historico (mais recente primeiro):");
+    uint32_t history = info->history;
+    for (int i = 0; i < 8 && history; ++i, history >>= 4)
+        printf(" [%s]", tel_reset_cause_str((tel_reset_cause_t)(history & 0xfu)));
+    printf("\n");
+    if (info->prev_last_feed_ms) {
+        printf("Boot anterior: ultima alimentacao do WD em %lu ms, idade max. heartbeat C0=%u ms C1=%u ms\n",
+            (unsigned long)info->prev_last_feed_ms,
+            info->prev_max_hb_age_ms[0],
+            info->prev_max_hb_age_ms[1]
+        );
+    }
+}
+
+void tel_note_heartbeat_ages(uint32_t age_core0_ms, uint32_t age_core1_ms) {
+    uint32_t prev = watchdog_hw->scratch[TEL_SCRATCH_MAX_HB_AGE];
+    uint32_t max0 = MAX(prev >> 16, MIN(age_core0_ms, 0xffffu));
+    uint32_t max1 = MAX(prev & 0xffffu, MIN(age_core1_ms, 0xffffu));
+    watchdog_hw->scratch[TEL_SCRATCH_MAX_HB_AGE] = max0 << 16 | max1;
+}
+
+void tel_note_watchdog_fed(uint32_t now_ms) {
+    watchdog_hw->scratch[TEL_SCRATCH_LAST_FEED] = now_ms;
+}
@@ -0,0 +1,75 @@
+#ifndef _TELEMETRY_H
+#define _TELEMETRY_H
+
+#include "pico/types.h"
+
+// Telemetria de temporização dos núcleos e do watchdog.
+//
+// Histogramas log-lineares de durações em microssegundos: 4 faixas por
+// potência de 2 (resolução de ~25%), de 1 us até ~16 s, mais uma faixa de
+// estouro. Cada histograma deve ter um único escritor (um núcleo ou uma IRQ);
+// a leitura para o relatório pode ocorrer de outro contexto e tolera amostras
+// concorrentes.
+
+#define TEL_HIST_SUB_BITS 2
+#define TEL_HIST_MAX_LOG2 24
+#define TEL_HIST_N_BUCKETS (((TEL_HIST_MAX_LOG2 - TEL_HIST_SUB_BITS + 1) << TEL_HIST_SUB_BITS) + 1)
+
+typedef struct {
+    const char *name;
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint32_t buckets[TEL_HIST_N_BUCKETS];
+} tel_hist_t;
+
+#define TEL_HIST_INIT(label) { .name = (label), .count = 0, .min_us = UINT32_MAX, .max_us = 0, .buckets = {0} }
+
+void tel_hist_reset(tel_hist_t *h);
+void tel_hist_add(tel_hist_t *h, uint32_t us);
+// Limite superior da faixa que contém o percentil pedido (em milésimos, ex.
+// 990 para p99). Retorna 0 se o histograma estiver vazio.
+uint32_t tel_hist_percentile_us(const tel_hist_t *h, uint permille);
+void tel_hist_print(const tel_hist_t *h);
+
+// ----------------------------------------------------------------------------
+// Histórico persistente nos registradores scratch do watchdog
+//
+// scratch[0]: contador de resets por watchdog (zerado no power-on)
+// scratch[1]: histórico das últimas 8 causas de reset, 4 bits cada, a mais
+//             recente nos bits menos significativos
+// scratch[2]: maior idade de heartbeat do boot corrente, em ms
+//             (Core 0 nos 16 bits altos, Core 1 nos 16 bits baixos)
+// scratch[3]: tempo desde o boot (ms) da última alimentação do watchdog
+//
+// scratch[4..7] são usados pelo SDK/bootrom e não são tocados.
+
+typedef enum {
+    TEL_RESET_UNKNOWN = 0,
+    TEL_RESET_POWER_ON,
+    TEL_RESET_RUN_PIN,
+    TEL_RESET_DEBUGGER,
+    TEL_RESET_WATCHDOG_TIMEOUT,
+    TEL_RESET_WATCHDOG_REBOOT,
+    TEL_RESET_CAUSE_COUNT
+} tel_reset_cause_t;
+
+typedef struct {
+    tel_reset_cause_t cause;
+    uint32_t watchdog_reset_count;
+    uint32_t history;            // scratch[1] após registrar este boot
+    uint16_t prev_max_hb_age_ms[2];
+    uint32_t prev_last_feed_ms;
+} tel_boot_info_t;
+
+// Chamar uma vez no boot, antes de habilitar o watchdog. Registra a causa do
+// reset no histórico e preserva os dados do boot anterior em *info.
+void tel_boot_record(tel_boot_info_t *info);
+const char *tel_reset_cause_str(tel_reset_cause_t cause);
+void tel_boot_print(const tel_boot_info_t *info);
+
+// Chamadas a partir do callback de alimentação do watchdog:
+void tel_note_heartbeat_ages(uint32_t age_core0_ms, uint32_t age_core1_ms);
+void tel_note_watchdog_fed(uint32_t now_ms);
+
+#endif
@@ -0,0 +1,146 @@
+#include "text_screen.h"
+
+// Fonte gerada no build por tools/font_gen.py a partir de assets/font_teste.png
+// (ASCII + Latin-1). Define font_8x8, FONT_FIRST_CHAR, FONT_N_CHARS e a
+// tabela de remapeamento font_8x8_remap.
+#include "font_8x8.h"
+
+char charbuf[TEXT_MAX_ROWS * CHAR_COLS];
+uint32_t colourbuf[3 * COLOUR_PLANE_SIZE_WORDS];
+volatile uint8_t text_row_attr[TEXT_MAX_ROWS];
+
+void set_row_scale(unsigned y, unsigned scale, bool hdouble) {
+    if (y >= TEXT_MAX_ROWS)
+        return;
+    scale = scale < 1 ? 1 : scale > TEXT_MAX_SCALE ? TEXT_MAX_SCALE : scale;
+    text_row_attr[y] = (uint8_t)(scale | (hdouble ? TEXT_ROW_HDOUBLE : 0));
+}
+
+// Função para definir um caractere na tela
+void set_char(unsigned x, unsigned y, char c) {
+    if (y >= TEXT_MAX_ROWS || x >= row_cols(y))
+        return;
+    charbuf[x + y * CHAR_COLS] = c;
+}
+
+static inline void set_cell_colour(unsigned cell_index, uint8_t fg, uint8_t bg) {
+    unsigned bit_index = cell_index % 8 * 4;
+    unsigned word_index = cell_index / 8;
+    for (int plane = 0; plane < 3; ++plane) {
+        uint32_t fg_bg_combined = (fg & 0x3) | (bg << 2 & 0xc);
+        colourbuf[word_index] = (colourbuf[word_index] & ~(0xfu << bit_index)) | (fg_bg_combined << bit_index);
+        fg >>= 2;
+        bg >>= 2;
+        word_index += COLOUR_PLANE_SIZE_WORDS;
+    }
+}
+
+// Função para definir a cor de um caractere (formato RGB222)
+void set_colour(unsigned x, unsigned y, uint8_t fg, uint8_t bg) {
+    if (y >= TEXT_MAX_ROWS || x >= row_cols(y))
+        return;
+    set_cell_colour(x + y * CHAR_COLS, fg, bg);
+}
+
+void get_colour(unsigned x, unsigned y, uint8_t *fg, uint8_t *bg) {
+    unsigned cell_index = x + y * CHAR_COLS;
+    unsigned bit_index = cell_index % 8 * 4;
+    unsigned word_index = cell_index / 8;
+    *fg = 0;
+    *bg = 0;
+    for (int plane = 0; plane < 3; ++plane) {
+        uint32_t fg_bg_combined = colourbuf[word_index + plane * COLOUR_PLANE_SIZE_WORDS] >> bit_index;
+        *fg |= (uint8_t)((fg_bg_combined & 0x3) << 2 * plane);
+        *bg |= (uint8_t)((fg_bg_combined >> 2 & 0x3) << 2 * plane);
+    }
+}
+
+void clear_line(unsigned y, uint8_t bg) {
+    if (y >= TEXT_MAX_ROWS) return;
+    for (unsigned x = 1; x < row_cols(y) - 1; ++x) {
+        set_char(x, y, ' ');
+        set_colour(x, y, 0x00, bg);
+    }
+}
+
+void clear_screen(uint8_t bg) {
+    for (unsigned y = 0; y < TEXT_MAX_ROWS; ++y) {
+        for (unsigned x = 0; x < row_cols(y); ++x) {
+            set_char(x, y, ' ');
+            set_colour(x, y, 0x00, bg);
+        }
+    }
+}
+
+// Decodifica o próximo codepoint UTF-8 de *s e avança o ponteiro. Sequências
+// inválidas ou truncadas consomem um byte e viram U+FFFD.
+static uint32_t utf8_next(const char **s) {
+    const uint8_t *p = (const uint8_t*)*s;
+    uint32_t cp = p[0];
+    unsigned extra = cp >= 0xf0 ? 3 : cp >= 0xe0 ? 2 : cp >= 0xc0 ? 1 : 0;
+    if (cp >= 0x80 && cp < 0xc0)
+        extra = 4;
+    if (extra == 0 || extra == 4) {
+        *s += 1;
+        return extra ? 0xfffd : cp;
+    }
+    cp &= 0x3f >> extra;
+    for (unsigned i = 1; i <= extra; ++i) {
+        if ((p[i] & 0xc0) != 0x80) {
+            *s += 1;
+            return 0xfffd;
+        }
+        cp = cp << 6 | (p[i] & 0x3f);
+    }
+    *s += extra + 1;
+    return cp;
+}
+
+// Converte um codepoint no índice do glifo (o byte guardado em charbuf).
+// Latin-1 mapeia direto; o resto passa pela tabela de remapeamento gerada
+// junto com a fonte e, se não estiver lá, aparece como '?'.
+static uint8_t font_glyph(uint32_t cp) {
+    if (cp >= FONT_FIRST_CHAR && cp < FONT_FIRST_CHAR + FONT_N_CHARS)
+        return (uint8_t)cp;
+#if FONT_N_REMAP
+    int lo = 0, hi = FONT_N_REMAP - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        uint32_t key = font_8x8_remap[mid] >> 8;
+        if (key == cp)
+            return font_8x8_remap[mid] & 0xff;
+        if (key < cp)
+            lo = mid + 1;
+        else
+            hi = mid - 1;
+    }
+#endif
+    return '?';
+}
+
+int utf8_len(const char *text) {
+    int len = 0;
+    while (*text) {
+        utf8_next(&text);
+        ++len;
+    }
+    return len;
+}
+
+void write_text(int start_x, int y, const char *text, uint8_t fg, uint8_t bg) {
+    if (y < 0 || y >= (int)TEXT_MAX_ROWS || !text) return;
+    int cols = (int)row_cols((unsigned)y);
+    for (int x = start_x; *text != '\0'; ++x) {
+        uint8_t glyph = font_glyph(utf8_next(&text));
+        if (x <= 0 || x >= cols - 1) continue;
+        set_char((unsigned)x, (unsigned)y, (char)glyph);
+        set_colour((unsigned)x, (unsigned)y, fg, bg);
+    }
+}
+
+void write_centered(int y, const char *text, uint8_t fg, uint8_t bg) {
+    if (y < 0 || y >= (int)TEXT_MAX_ROWS) return;
+    int len = utf8_len(text);
+    int start_x = ((int)row_cols((unsigned)y) / 2) - (len / 2);
+    write_text(start_x, y, text, fg, bg);
+}
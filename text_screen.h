@@ -0,0 +1,101 @@
+#ifndef _TEXT_SCREEN_H
+#define _TEXT_SCREEN_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Terminal de caracteres do receptor: charbuf, colourbuf e os atributos de
+// cada linha de texto, mais as funções de escrita da IHM. Só C padrão, sem
+// SDK, para a IHM também rodar no host (host/).
+//
+// CHAR_COLS: 640 / 8 = 80 células por linha de texto
+// TEXT_MAX_ROWS: 480 / 8 = 60 linhas de texto no pior caso (todas em 1x)
+//
+// As linhas de texto são empilhadas de cima para baixo, cada uma com altura
+// 8 * escala; as que passam do fim da tela não aparecem. Uma linha com
+// TEXT_ROW_HDOUBLE tem caracteres de 16 px de largura, então só as primeiras
+// CHAR_COLS / 2 posições de charbuf e de cor daquela linha são usadas.
+
+// Fonte 8x8. A escala vertical (1x a 4x) e a duplicação horizontal são
+// atributos de cada linha de texto (text_row_attr).
+#define FONT_CHAR_WIDTH 8
+#define FONT_ORIGINAL_HEIGHT 8
+#define TEXT_MAX_SCALE 4
+
+#define TEXT_SCREEN_WIDTH 640
+#define TEXT_SCREEN_HEIGHT 480
+
+#define CHAR_COLS (TEXT_SCREEN_WIDTH / FONT_CHAR_WIDTH)
+#define TEXT_MAX_ROWS (TEXT_SCREEN_HEIGHT / FONT_ORIGINAL_HEIGHT)
+
+#define TEXT_ROW_SCALE_BITS 0x07
+#define TEXT_ROW_HDOUBLE    0x80
+
+// Cores RGB222, 4 bits por célula (2 de frente, 2 de fundo) em cada um dos
+// três planos
+#define COLOUR_PLANE_SIZE_WORDS (TEXT_MAX_ROWS * CHAR_COLS * 4 / 32)
+#define COLOUR_ROW_WORDS (CHAR_COLS * 4 / 32)
+
+extern char charbuf[TEXT_MAX_ROWS * CHAR_COLS];
+extern uint32_t colourbuf[3 * COLOUR_PLANE_SIZE_WORDS];
+extern volatile uint8_t text_row_attr[TEXT_MAX_ROWS];
+
+static inline unsigned row_attr_scale(unsigned attr) {
+    unsigned scale = attr & TEXT_ROW_SCALE_BITS;
+    return scale ? scale : 1;
+}
+
+static inline unsigned row_cols(unsigned y) {
+    return text_row_attr[y] & TEXT_ROW_HDOUBLE ? CHAR_COLS / 2 : CHAR_COLS;
+}
+
+// Percorre as linhas de pixels da tela de cima para baixo: para cada uma, a
+// linha de texto (row), os atributos dela e a linha da fonte (0 a 7). É o
+// laço do Core 1 (hdmi.c) e também o da renderização no host (host/), para
+// as duas concordarem pixel a pixel.
+typedef struct {
+    unsigned row;
+    unsigned attr;
+    unsigned font_row;
+    unsigned repeat; // quantas vezes font_row já foi repetida (escala vertical)
+} text_raster_t;
+
+static inline void text_raster_start(text_raster_t *r) {
+    r->row = 0;
+    r->attr = text_row_attr[0];
+    r->font_row = 0;
+    r->repeat = 0;
+}
+
+static inline void text_raster_next(text_raster_t *r) {
+    if (++r->repeat < row_attr_scale(r->attr))
+        return;
+    r->repeat = 0;
+    if (++r->font_row < FONT_ORIGINAL_HEIGHT)
+        return;
+    r->font_row = 0;
+    // Cada linha de texto tem ao menos 8 px, então 60 linhas sempre cobrem a
+    // tela; a guarda é só para a última volta.
+    if (++r->row < TEXT_MAX_ROWS)
+        r->attr = text_row_attr[r->row];
+    else
+        r->row = 0;
+}
+
+void set_row_scale(unsigned y, unsigned scale, bool hdouble);
+void set_char(unsigned x, unsigned y, char c);
+void set_colour(unsigned x, unsigned y, uint8_t fg, uint8_t bg);
+
+// Lê de volta a célula (para testes e para a renderização no host)
+void get_colour(unsigned x, unsigned y, uint8_t *fg, uint8_t *bg);
+
+void clear_line(unsigned y, uint8_t bg);
+void clear_screen(uint8_t bg);
+
+// Textos são UTF-8: cada codepoint ocupa uma célula. Células fora da linha
+// ou nas bordas (coluna 0 e a última) não são escritas.
+void write_text(int start_x, int y, const char *text, uint8_t fg, uint8_t bg);
+void write_centered(int y, const char *text, uint8_t fg, uint8_t bg);
+int utf8_len(const char *text);
+
+#endif
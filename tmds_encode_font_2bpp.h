@@ -20,4 +20,14 @@
 void tmds_encode_font_2bpp(const uint8_t *charbuf, const uint32_t	*colourbuf,
 	uint32_t *tmdsbuf, uint n_pix, const uint8_t *font_line);
 
+// As above, but every pixel is doubled horizontally (16 px wide characters),
+// using one word of two identical symbols per pixel like the pixel-doubled
+// 8bpp/16bpp encoders. n_pix is the logical width (e.g. 320 for a 640 px
+// line, so 40 characters); colourbuf has one entry per logical character.
+// Costs roughly 3/4 of a full-resolution line, since the table lookups per
+// line halve but the number of stores stays the same.
+
+void tmds_encode_font_2bpp_2x(const uint8_t *charbuf, const uint32_t *colourbuf,
+	uint32_t *tmdsbuf, uint n_pix, const uint8_t *font_line);
+
 #endif
@@ -0,0 +1,322 @@
+#!/usr/bin/env python3
+
+# Convert 8x8 bitmap fonts (PNG strips and/or BDF files) to the
+# row-interleaved glyph table that tmds_encode_font_2bpp expects:
+#
+#   font[row * FONT_N_CHARS + (c - FONT_FIRST_CHAR)], bit 0 = leftmost pixel
+#
+# Up to 256 glyphs are emitted, indexed directly by Latin-1 code. With
+# --latin1, glyphs missing from every source in 0xa0..0xff are synthesised
+# from the ASCII ones (base letter + accent, overlays, mirrored punctuation),
+# so an ASCII-only PNG is enough to show Portuguese text.
+#
+# Codepoints above 0xff can either be placed in a free slot (--map, usually
+# in the unused C1 range 0x80..0x9f) or folded onto an existing glyph (the
+# typographic quotes and dashes below). Both end up in a sorted remap table
+# (codepoint << 8 | glyph) that the UTF-8 decoder on the device searches.
+#
+# Usage:
+#   font_gen.py --png assets/font_8x8.png:32 [--bdf extra.bdf] [--latin1]
+#               [--map 0x20ac=0x80] [--name font_8x8] -o font_8x8.h
+#
+# Sources are applied in order; a later source overrides earlier glyphs.
+
+import argparse
+import os
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from pngutil import read_png
+
+GLYPH_W = 8
+GLYPH_H = 8
+
+# Glyphs are lists of 8 row bytes, bit x = pixel x (leftmost = bit 0)
+
+def load_png_strip(path, first):
+	pixels = read_png(path)
+	if len(pixels) != GLYPH_H or len(pixels[0]) % GLYPH_W:
+		raise ValueError(f"{path}: expected a {GLYPH_H} pixel high strip of {GLYPH_W} pixel wide glyphs")
+	glyphs = {}
+	for i in range(len(pixels[0]) // GLYPH_W):
+		rows = []
+		for y in range(GLYPH_H):
+			bits = 0
+			for x in range(GLYPH_W):
+				r, g, b, a = pixels[y][i * GLYPH_W + x]
+				if a > 127 and (r + g + b) > 3 * 127:
+					bits |= 1 << x
+			rows.append(bits)
+		glyphs[first + i] = rows
+	return glyphs
+
+def load_bdf(path):
+	glyphs = {}
+	ascent = GLYPH_H - 1
+	enc = None
+	bbx = None
+	bitmap = None
+	for line in open(path, encoding="latin-1"):
+		tok = line.split()
+		if not tok:
+			continue
+		if tok[0] == "FONT_ASCENT":
+			ascent = int(tok[1])
+		elif tok[0] == "ENCODING":
+			enc = int(tok[1])
+		elif tok[0] == "BBX":
+			bbx = [int(t) for t in tok[1:5]]
+		elif tok[0] == "BITMAP":
+			bitmap = []
+		elif tok[0] == "ENDCHAR":
+			if enc is not None and enc >= 0 and bbx:
+				w, h, xoff, yoff = bbx
+				rows = [0] * GLYPH_H
+				top = ascent - (h + yoff)
+				for i, hexrow in enumerate(bitmap):
+					y = top + i
+					if not 0 <= y < GLYPH_H:
+						continue
+					v = int(hexrow, 16)
+					nbits = len(hexrow) * 4
+					for x in range(w):
+						px = xoff + x
+						if 0 <= px < GLYPH_W and (v >> (nbits - 1 - x)) & 1:
+							rows[y] |= 1 << px
+				glyphs[enc] = rows
+			enc = bbx = bitmap = None
+		elif bitmap is not None:
+			bitmap.append(tok[0])
+	return glyphs
+
+# ----------------------------------------------------------------------------
+# Latin-1 synthesis
+
+def span(rows, axis):
+	if axis == "x":
+		mask = 0
+		for r in rows:
+			mask |= r
+		xs = [x for x in range(GLYPH_W) if mask >> x & 1]
+	else:
+		xs = [y for y in range(GLYPH_H) if rows[y]]
+	return (xs[0], xs[-1]) if xs else (0, -1)
+
+def overlay(*glyphs):
+	out = [0] * GLYPH_H
+	for g in glyphs:
+		out = [a | b for a, b in zip(out, g)]
+	return out
+
+def vflip(rows):
+	y0, y1 = span(rows, "y")
+	out = [0] * GLYPH_H
+	for y in range(y0, y1 + 1):
+		out[y0 + y1 - y] = rows[y]
+	return out
+
+def rot180(rows):
+	x0, x1 = span(rows, "x")
+	out = vflip(rows)
+	for y in range(GLYPH_H):
+		out[y] = sum(1 << (x0 + x1 - x) for x in range(x0, x1 + 1) if out[y] >> x & 1)
+	return out
+
+def squash_top(rows, n):
+	# Free n rows above the glyph, dropping redundant rows (equal to a
+	# neighbour, closest to the middle first) if shifting down isn't enough.
+	rows = list(rows)
+	y0, y1 = span(rows, "y")
+	body = rows[y0:y1 + 1]
+	room = GLYPH_H - n
+	while len(body) > room:
+		mid = (len(body) - 1) / 2
+		dup = [i for i in range(1, len(body)) if body[i] == body[i - 1]]
+		i = min(dup, key=lambda i: abs(i - mid)) if dup else int(mid)
+		del body[i]
+	top = max(n, min(y0, room - len(body) + n))
+	out = [0] * GLYPH_H
+	out[top:top + len(body)] = body
+	return out
+
+def draw(rows, pattern, y, centre):
+	out = list(rows)
+	for dy, s in enumerate(pattern):
+		x0 = int(round(centre - (len(s) - 1) / 2))
+		for dx, ch in enumerate(s):
+			if ch == "#" and 0 <= x0 + dx < GLYPH_W:
+				out[y + dy] |= 1 << (x0 + dx)
+	return out
+
+ACCENTS = {
+	"grave":      [".##..", "..##."],
+	"acute":      ["..##.", ".##.."],
+	"circumflex": [".###.", "##.##"],
+	"tilde":      [".##.#", "#.##."],
+	"diaeresis":  [".....", "##.##"],
+	"ring":       [".###.", ".###."],
+}
+CEDILLA = ["..##."]
+
+def accented(base, accent):
+	n = len(ACCENTS[accent])
+	y0, _ = span(base, "y")
+	if y0 >= n:
+		# Lowercase: anything above the x-height (the dot of i) is replaced
+		rows = [0] * n + base[n:]
+	else:
+		rows = squash_top(base, n)
+	x0, x1 = span(base, "x")
+	return draw(rows, ACCENTS[accent], 0, (x0 + x1) / 2)
+
+def cedilla(base):
+	rows = list(base)
+	_, y1 = span(rows, "y")
+	if y1 >= GLYPH_H - 1:
+		rows = vflip(squash_top(vflip(rows), 1))
+	x0, x1 = span(base, "x")
+	return draw(rows, CEDILLA, GLYPH_H - 1, (x0 + x1) / 2)
+
+def from_art(art, y):
+	rows = [0] * GLYPH_H
+	return draw(rows, art, y, 3)
+
+MISSING = [0x00, 0x7e, 0x42, 0x42, 0x42, 0x42, 0x7e, 0x00]
+
+_ACC = {"`": "grave", "'": "acute", "^": "circumflex", "~": "tilde", ":": "diaeresis", "o": "ring"}
+LATIN1_ACCENTED = {
+	0xc0: "A`", 0xc1: "A'", 0xc2: "A^", 0xc3: "A~", 0xc4: "A:", 0xc5: "Ao",
+	0xc8: "E`", 0xc9: "E'", 0xca: "E^", 0xcb: "E:",
+	0xcc: "I`", 0xcd: "I'", 0xce: "I^", 0xcf: "I:",
+	0xd1: "N~", 0xd2: "O`", 0xd3: "O'", 0xd4: "O^", 0xd5: "O~", 0xd6: "O:",
+	0xd9: "U`", 0xda: "U'", 0xdb: "U^", 0xdc: "U:", 0xdd: "Y'",
+	0xe0: "a`", 0xe1: "a'", 0xe2: "a^", 0xe3: "a~", 0xe4: "a:", 0xe5: "ao",
+	0xe8: "e`", 0xe9: "e'", 0xea: "e^", 0xeb: "e:",
+	0xec: "i`", 0xed: "i'", 0xee: "i^", 0xef: "i:",
+	0xf1: "n~", 0xf2: "o`", 0xf3: "o'", 0xf4: "o^", 0xf5: "o~", 0xf6: "o:",
+	0xf9: "u`", 0xfa: "u'", 0xfb: "u^", 0xfc: "u:", 0xfd: "y'", 0xff: "y:",
+}
+
+def synthesise_latin1(glyphs):
+	g = lambda c: glyphs.get(ord(c), MISSING)
+	out = {
+		0xa0: g(" "),
+		0xa1: vflip(g("!")),
+		0xa2: overlay(g("c"), g("|")),
+		0xa8: from_art(ACCENTS["diaeresis"], 0),
+		0xab: g("<"),
+		0xad: g("-"),
+		0xb0: from_art([".##.", "#..#", ".##."], 0),
+		0xb1: overlay(g("+"), g("_")),
+		0xb4: from_art(ACCENTS["acute"], 0),
+		0xb7: from_art(["##", "##"], 3),
+		0xb8: from_art(CEDILLA, GLYPH_H - 1),
+		0xbb: g(">"),
+		0xbf: rot180(g("?")),
+		0xc7: cedilla(g("C")),
+		0xd0: g("D"),
+		0xd7: g("x"),
+		0xd8: overlay(g("O"), g("/")),
+		0xe7: cedilla(g("c")),
+		0xf0: g("d"),
+		0xf7: overlay(g("-"), g(":")),
+		0xf8: overlay(g("o"), g("/")),
+	}
+	for cp, spec in LATIN1_ACCENTED.items():
+		out[cp] = accented(g(spec[0]), _ACC[spec[1]])
+	for cp in range(0xa0, 0x100):
+		out.setdefault(cp, MISSING)
+	return out
+
+# Codepoints folded onto an existing glyph when the font has no slot for them
+FOLD = {
+	0x2013: "-", 0x2014: "-", 0x2018: "'", 0x2019: "'", 0x201a: ",",
+	0x201c: '"', 0x201d: '"', 0x201e: '"', 0x2022: 0xb7, 0x2026: ".",
+}
+
+# ----------------------------------------------------------------------------
+
+def main():
+	p = argparse.ArgumentParser(description="8x8 font to row-interleaved glyph table")
+	p.add_argument("--png", action="append", default=[], metavar="FILE:FIRST",
+		help="PNG strip of 8x8 glyphs, FIRST = codepoint of the leftmost glyph (default 32)")
+	p.add_argument("--bdf", action="append", default=[], metavar="FILE",
+		help="BDF font; glyphs up to 8x8 are placed on the cell using FONT_ASCENT")
+	p.add_argument("--latin1", action="store_true",
+		help="synthesise missing Latin-1 glyphs (0xa0..0xff) from the ASCII ones")
+	p.add_argument("--map", action="append", default=[], metavar="CP=SLOT",
+		help="place source glyph CP (> 0xff) in table slot SLOT")
+	p.add_argument("--first", type=lambda s: int(s, 0), default=32)
+	p.add_argument("--last", type=lambda s: int(s, 0), default=None,
+		help="last slot emitted (default 0xff with --latin1, else the last source glyph)")
+	p.add_argument("--name", default="font_8x8")
+	p.add_argument("-o", "--output", required=True)
+	args = p.parse_args()
+
+	glyphs = {}
+	sources = []
+	for spec in args.png:
+		path, _, first = spec.partition(":")
+		glyphs.update(load_png_strip(path, int(first, 0) if first else 32))
+		sources.append(path)
+	for path in args.bdf:
+		glyphs.update(load_bdf(path))
+		sources.append(path)
+	if not glyphs:
+		p.error("no font sources given")
+
+	remap = {}
+	for spec in args.map:
+		cp, slot = (int(v, 0) for v in spec.split("="))
+		if cp not in glyphs:
+			p.error(f"--map: U+{cp:04X} is not in any source")
+		glyphs[slot] = glyphs[cp]
+		remap[cp] = slot
+
+	if args.latin1:
+		for cp, rows in synthesise_latin1(glyphs).items():
+			glyphs.setdefault(cp, rows)
+	last = args.last if args.last is not None else \
+		(0xff if args.latin1 else max(c for c in glyphs if c <= 0xff))
+	first = args.first
+	n_chars = last - first + 1
+	if not 0 < n_chars <= 256 or last > 0xff:
+		p.error("the glyph table is indexed by a byte: need FIRST <= LAST <= 0xff")
+
+	for cp, target in FOLD.items():
+		slot = target if isinstance(target, int) else ord(target)
+		if cp not in remap and first <= slot <= last and slot in glyphs:
+			remap[cp] = slot
+
+	table = []
+	for y in range(GLYPH_H):
+		for c in range(first, last + 1):
+			table.append(glyphs.get(c, [0] * GLYPH_H)[y])
+
+	out = []
+	out.append(f"// Generated by tools/font_gen.py from {', '.join(os.path.basename(s) for s in sources)} -- do not edit\n")
+	out.append("#ifndef _IMG_ASSET_SECTION\n#define _IMG_ASSET_SECTION \".data\"\n#endif\n\n")
+	out.append(f"#define FONT_FIRST_CHAR {first}\n")
+	out.append(f"#define FONT_N_CHARS {n_chars}\n")
+	out.append(f"#define FONT_N_REMAP {len(remap)}\n\n")
+	out.append(f"static const char __attribute__((aligned(4), section(_IMG_ASSET_SECTION \".{args.name}\"))) {args.name}[] = {{\n")
+	for i in range(0, len(table), 16):
+		out.append("\t" + " ".join(f"0x{b:02x}," for b in table[i:i + 16]) + "\n")
+	out.append("};\n")
+	if remap:
+		out.append("\n// Sorted (codepoint << 8 | glyph) for codepoints outside the table\n")
+		out.append(f"static const uint32_t {args.name}_remap[FONT_N_REMAP] = {{\n")
+		entries = [f"0x{cp << 8 | slot:08x}," for cp, slot in sorted(remap.items())]
+		for i in range(0, len(entries), 6):
+			out.append("\t" + " ".join(entries[i:i + 6]) + "\n")
+		out.append("};\n")
+
+	text = "".join(out)
+	# Only touch the output when it changes, so dependants don't rebuild
+	if not os.path.exists(args.output) or open(args.output).read() != text:
+		os.makedirs(os.path.dirname(os.path.abspath(args.output)), exist_ok=True)
+		with open(args.output, "w") as f:
+			f.write(text)
+
+if __name__ == "__main__":
+	main()
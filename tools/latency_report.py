@@ -0,0 +1,203 @@
+#!/usr/bin/env python3
+
+# Key-to-photon latency report from the receiver's "LAT" log lines.
+#
+# With the latency probe enabled ('l' on the receiver's USB console), hdmi.c
+# prints one line per measured key press:
+#
+#   LAT seq=12 key=3 bytes=15 ev=... fr=... rx=... wr=... enc=... line=216 out=... vline=217
+#
+# ev and fr are the emitter's time_us_32() at the key event (first debounce
+# sample in the new state) and at frame build; rx, wr, enc and out are the
+# receiver's clock when the frame was decoded, the '*' was written to
+# charbuf, the first pixel line of that text row was encoded on core 1, and
+# that TMDS buffer was loaded for scanout by the DMA IRQ.
+#
+# The two boards have independent clocks. The offset between them (plus
+# crystal drift) is estimated from the lower envelope of
+# rx - fr - wire_time: the fastest deliveries are assumed to have had no
+# polling delay, so the link stage reported below is UART wire time plus the
+# receiver's poll wait, measured against that best case.
+#
+# Usage:
+#   latency_report.py [--baud 115200] [--window 10] [--hist] [--csv out.csv] [log ...]
+#
+# Logs are read from stdin when no file is given; anything other than LAT
+# lines (telemetry reports, boot messages) is ignored.
+
+import argparse
+import re
+import sys
+
+WRAP = 1 << 32
+LAT_RE = re.compile(r"LAT\s+(.*)$")
+FIELDS = ("seq", "bytes", "ev", "fr", "rx", "wr", "enc", "line", "out", "vline")
+
+STAGES = (
+	("emitter", "scan + debounce + frame build (fr - ev)"),
+	("link", "UART wire + receiver poll (rx - fr)"),
+	("ui", "decode -> charbuf write (wr - rx)"),
+	("encode", "charbuf write -> line encoded (enc - wr)"),
+	("scanout", "line encoded -> loaded for scanout (out - enc)"),
+	("total", "key event -> scanout (out - ev)"),
+)
+
+def wrap_diff(a, b):
+	# a - b for two time_us_32() values, assuming |a - b| < 2^31 us
+	d = (a - b) % WRAP
+	return d - WRAP if d >= WRAP // 2 else d
+
+def parse(lines):
+	samples = []
+	for line in lines:
+		m = LAT_RE.search(line)
+		if not m:
+			continue
+		rec = {}
+		for tok in m.group(1).split():
+			k, _, v = tok.partition("=")
+			if k in FIELDS:
+				try:
+					rec[k] = int(v)
+				except ValueError:
+					break
+			elif k == "key":
+				rec[k] = v
+		if all(k in rec for k in FIELDS):
+			samples.append(rec)
+	return samples
+
+def split_sessions(samples, baud):
+	# Unwraps the receiver clock and splits the log wherever either board
+	# rebooted (receiver clock going backwards, or a jump in the clock offset)
+	sessions = []
+	cur = []
+	t = 0
+	prev = None
+	for s in samples:
+		wire = s["bytes"] * 10 * 1e6 / baud
+		raw = wrap_diff(s["rx"], s["fr"]) - wire
+		if prev is not None:
+			step = wrap_diff(s["rx"], prev["rx"])
+			if step < 0 or abs(raw - prev["raw"]) > 100000 + step * 1e-3:
+				sessions.append(cur)
+				cur = []
+				t = 0
+			else:
+				t += step
+		s = dict(s, t=t, wire=wire, raw=raw)
+		cur.append(s)
+		prev = s
+	if cur:
+		sessions.append(cur)
+	return sessions
+
+def fit_offset(session, window_us):
+	# Line through the per-window minima of raw = offset(t) + delay, delay >= 0
+	minima = {}
+	for s in session:
+		w = int(s["t"] // window_us)
+		if w not in minima or s["raw"] < minima[w][1]:
+			minima[w] = (s["t"], s["raw"])
+	pts = sorted(minima.values())
+	if len(pts) < 2:
+		return 0.0, pts[0][1]
+	n = len(pts)
+	mt = sum(p[0] for p in pts) / n
+	mr = sum(p[1] for p in pts) / n
+	var = sum((p[0] - mt) ** 2 for p in pts)
+	slope = sum((p[0] - mt) * (p[1] - mr) for p in pts) / var if var else 0.0
+	base = mr - slope * mt
+	# Shift down so that every window minimum lies on or above the line
+	base += min(p[1] - (base + slope * p[0]) for p in pts)
+	return slope, base
+
+def stage_values(session, slope, base):
+	out = []
+	for s in session:
+		offset = base + slope * s["t"]
+		fr_rx = s["rx"] - (wrap_diff(s["rx"], s["fr"]) - offset)
+		ev_rx = fr_rx - wrap_diff(s["fr"], s["ev"])
+		out.append({
+			"seq": s["seq"],
+			"key": s.get("key", "?"),
+			"emitter": wrap_diff(s["fr"], s["ev"]),
+			"link": s["rx"] - fr_rx,
+			"ui": wrap_diff(s["wr"], s["rx"]),
+			"encode": wrap_diff(s["enc"], s["wr"]),
+			"scanout": wrap_diff(s["out"], s["enc"]),
+			"total": s["rx"] - ev_rx + wrap_diff(s["out"], s["rx"]),
+			"wire": s["wire"],
+			"line": s["line"],
+			"vline": s["vline"],
+		})
+	return out
+
+def percentile(sorted_vals, p):
+	if not sorted_vals:
+		return 0
+	i = min(len(sorted_vals) - 1, max(0, int(round(p / 100 * (len(sorted_vals) - 1)))))
+	return sorted_vals[i]
+
+def print_hist(vals, bins=20, width=50):
+	lo, hi = min(vals), max(vals)
+	step = max((hi - lo) / bins, 1)
+	counts = [0] * bins
+	for v in vals:
+		counts[min(bins - 1, int((v - lo) / step))] += 1
+	peak = max(counts)
+	for i, c in enumerate(counts):
+		bar = "#" * (c * width // peak if peak else 0)
+		print(f"  {(lo + i * step) / 1000:8.3f} ms {c:6d} {bar}")
+
+def main():
+	ap = argparse.ArgumentParser(description="Report key-to-photon latency from hdmi.c LAT lines")
+	ap.add_argument("logs", nargs="*", help="log files (default: stdin)")
+	ap.add_argument("--baud", type=int, default=115200, help="keypad link baud rate")
+	ap.add_argument("--window", type=float, default=10.0,
+		help="seconds per window when fitting the clock offset")
+	ap.add_argument("--hist", action="store_true", help="print a histogram of the total latency")
+	ap.add_argument("--csv", help="write per-sample stage latencies (us) to this file")
+	args = ap.parse_args()
+
+	lines = []
+	if args.logs:
+		for path in args.logs:
+			with open(path, errors="replace") as f:
+				lines.extend(f)
+	else:
+		lines = sys.stdin.readlines()
+
+	samples = parse(lines)
+	if not samples:
+		sys.exit("no LAT lines found (enable the probe with 'l' on the receiver's USB console)")
+
+	rows = []
+	for session in split_sessions(samples, args.baud):
+		slope, base = fit_offset(session, args.window * 1e6)
+		span = session[-1]["t"] / 1e6
+		print(f"session: {len(session)} samples over {span:.1f} s, clock drift {slope * 1e6:+.1f} ppm")
+		rows.extend(stage_values(session, slope, base))
+
+	print(f"\n{len(rows)} samples, wire time {min(r['wire'] for r in rows):.0f} us per minimal frame")
+	print(f"{'stage':8} {'min':>9} {'p50':>9} {'p90':>9} {'p99':>9} {'max':>9} {'mean':>9}  (ms)")
+	for name, desc in STAGES:
+		vals = sorted(r[name] for r in rows)
+		mean = sum(vals) / len(vals)
+		cols = " ".join(f"{v / 1000:9.3f}" for v in
+			(vals[0], percentile(vals, 50), percentile(vals, 90), percentile(vals, 99), vals[-1], mean))
+		print(f"{name:8} {cols}  {desc}")
+
+	if args.hist:
+		print("\ntotal latency:")
+		print_hist([r["total"] for r in rows])
+
+	if args.csv:
+		keys = ("seq", "key") + tuple(n for n, _ in STAGES) + ("line", "vline")
+		with open(args.csv, "w") as f:
+			f.write(",".join(keys) + "\n")
+			for r in rows:
+				f.write(",".join(str(round(r[k]) if isinstance(r[k], float) else r[k]) for k in keys) + "\n")
+
+if __name__ == "__main__":
+	main()
@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+
+# Minimal PNG reader/writer for the asset tools, so they only need the Python
+# standard library (no Pillow on the build machine). Supports non-interlaced
+# 8-bit greyscale, grey+alpha, RGB, RGBA and palette images, which covers
+# anything a normal image editor will export for small fonts and sprites.
+#
+# Images are returned as a list of rows, each a list of (r, g, b, a) tuples.
+
+import struct
+import zlib
+
+PNG_SIG = b"\x89PNG\r\n\x1a\n"
+
+def _paeth(a, b, c):
+	p = a + b - c
+	pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+	if pa <= pb and pa <= pc:
+		return a
+	return b if pb <= pc else c
+
+def _unfilter(raw, width, height, bpp):
+	stride = width * bpp
+	rows = []
+	prev = bytearray(stride)
+	pos = 0
+	for y in range(height):
+		ftype = raw[pos]
+		line = bytearray(raw[pos + 1:pos + 1 + stride])
+		pos += 1 + stride
+		if ftype == 0:
+			rows.append(line)
+			prev = line
+			continue
+		for x in range(stride):
+			a = line[x - bpp] if x >= bpp else 0
+			b = prev[x]
+			c = prev[x - bpp] if x >= bpp else 0
+			if ftype == 1:
+				line[x] = (line[x] + a) & 0xff
+			elif ftype == 2:
+				line[x] = (line[x] + b) & 0xff
+			elif ftype == 3:
+				line[x] = (line[x] + ((a + b) >> 1)) & 0xff
+			elif ftype == 4:
+				line[x] = (line[x] + _paeth(a, b, c)) & 0xff
+			elif ftype != 0:
+				raise ValueError(f"bad PNG filter type {ftype}")
+		rows.append(line)
+		prev = line
+	return rows
+
+def read_png(path):
+	data = open(path, "rb").read()
+	if data[:8] != PNG_SIG:
+		raise ValueError(f"{path}: not a PNG file")
+	pos = 8
+	idat = b""
+	palette = None
+	trns = None
+	while pos < len(data):
+		length, ctype = struct.unpack(">I4s", data[pos:pos + 8])
+		body = data[pos + 8:pos + 8 + length]
+		pos += 12 + length
+		if ctype == b"IHDR":
+			width, height, depth, colour, _, _, interlace = struct.unpack(">IIBBBBB", body)
+		elif ctype == b"PLTE":
+			palette = [tuple(body[i:i + 3]) for i in range(0, len(body), 3)]
+		elif ctype == b"tRNS":
+			trns = body
+		elif ctype == b"IDAT":
+			idat += body
+		elif ctype == b"IEND":
+			break
+	if depth != 8 or interlace:
+		raise ValueError(f"{path}: only 8-bit non-interlaced PNGs are supported")
+	bpp = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}[colour]
+	rows = _unfilter(zlib.decompress(idat), width, height, bpp)
+	pixels = []
+	for line in rows:
+		out = []
+		for x in range(width):
+			px = line[x * bpp:(x + 1) * bpp]
+			if colour == 0:
+				out.append((px[0], px[0], px[0], 255))
+			elif colour == 2:
+				out.append((px[0], px[1], px[2], 255))
+			elif colour == 3:
+				r, g, b = palette[px[0]]
+				a = trns[px[0]] if trns and px[0] < len(trns) else 255
+				out.append((r, g, b, a))
+			elif colour == 4:
+				out.append((px[0], px[0], px[0], px[1]))
+			else:
+				out.append(tuple(px))
+		pixels.append(out)
+	return pixels
+
+def _chunk(ctype, body):
+	crc = zlib.crc32(ctype + body) & 0xffffffff
+	return struct.pack(">I", len(body)) + ctype + body + struct.pack(">I", crc)
+
+def write_png(path, pixels, alpha=False):
+	height = len(pixels)
+	width = len(pixels[0])
+	raw = bytearray()
+	for line in pixels:
+		raw.append(0)
+		for px in line:
+			raw.extend(px[:4] if alpha else px[:3])
+	with open(path, "wb") as f:
+		f.write(PNG_SIG)
+		f.write(_chunk(b"IHDR", struct.pack(">IIBBBBB", width, height, 8, 6 if alpha else 2, 0, 0, 0)))
+		f.write(_chunk(b"IDAT", zlib.compress(bytes(raw), 9)))
+		f.write(_chunk(b"IEND", b""))
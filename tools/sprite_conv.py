@@ -0,0 +1,168 @@
+#!/usr/bin/env python3
+
+# Convert a PNG with an alpha channel into a libsprite image, optionally
+# with opacity metadata, as a C header:
+#
+#   static const uint32_t <name>[] = { pixels..., metadata... };
+#   #define <NAME>_W, <NAME>_H, <NAME>_STRIDE, <NAME>_FLAGS
+#
+# so a sprite is just
+#
+#   sprite_t sp = {.img = name, SPRITE_DIMS(NAME_W, NAME_H, NAME_STRIDE),
+#                  .flags = NAME_FLAGS};
+#
+# Pixel formats are the ones the alpha blits expect: RGAB5515 (16bpp) or
+# RAGB2132 (8bpp), alpha bit set = opaque. Metadata (see sprite.c):
+#
+#   none   no metadata, every row goes through sprite_blit*_alpha
+#   row    SPRITE_FLAG_OPACITY_METADATA, one first..last opaque span per row
+#   spans  SPRITE_FLAG_SPAN_METADATA, any number of spans per row
+#
+# Images with no transparent pixels get SPRITE_FLAG_OPAQUE instead (and no
+# metadata), which also selects the faster non-alpha affine loops.
+#
+# For "spans", runs of opaque pixels become solid spans (plain blit), and
+# transparent gaps are skipped. Each blit call has a fixed cost of roughly
+# a few alpha pixels, so gaps narrower than --merge-gap are folded into a
+# single non-solid span instead of splitting it.
+#
+# The stride is padded so the pixel data ends on a word boundary, as the
+# metadata is read as words straight after it. sprite_t stores w, h and
+# stride in a byte each (minus one), so all three are at most 256.
+#
+# Usage:
+#   sprite_conv.py ship.png [--format rgab5515|ragb2132] [--meta spans]
+#                  [--merge-gap 4] [--name ship] -o ship.h
+
+import argparse
+import os
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from pngutil import read_png
+
+def rgab5515(r, g, b, opaque):
+	return (r >> 3) << 11 | (g >> 3) << 6 | opaque << 5 | b >> 3
+
+def ragb2132(r, g, b, opaque):
+	return (r >> 6) << 6 | opaque << 5 | (g >> 5) << 2 | b >> 6
+
+FORMATS = {
+	"rgab5515": (2, rgab5515),
+	"ragb2132": (1, ragb2132),
+}
+
+def span_word(start, end, solid):
+	return (solid << 31) | start << 16 | end
+
+def row_spans(mask, merge_gap):
+	"""List of (start, end, solid) for one row of opacity flags."""
+	runs = []
+	x = 0
+	w = len(mask)
+	while x < w:
+		if not mask[x]:
+			x += 1
+			continue
+		start = x
+		while x < w and mask[x]:
+			x += 1
+		runs.append([start, x, True])
+	merged = []
+	for run in runs:
+		if merged and run[0] - merged[-1][1] < merge_gap:
+			merged[-1][1] = run[1]
+			merged[-1][2] = False
+		else:
+			merged.append(run)
+	return [tuple(r) for r in merged]
+
+def row_meta(mask):
+	opaque = [x for x, m in enumerate(mask) if m]
+	if not opaque:
+		return span_word(0, 0, 0)
+	start, end = opaque[0], opaque[-1] + 1
+	return span_word(start, end, int(all(mask[start:end])))
+
+def pack_words(values, size):
+	data = b"".join(v.to_bytes(size, "little") for v in values)
+	data += bytes(-len(data) % 4)
+	return [int.from_bytes(data[i:i + 4], "little") for i in range(0, len(data), 4)]
+
+def main():
+	ap = argparse.ArgumentParser(description=__doc__)
+	ap.add_argument("png")
+	ap.add_argument("--format", choices=FORMATS, default="rgab5515")
+	ap.add_argument("--meta", choices=("none", "row", "spans"), default="spans")
+	ap.add_argument("--merge-gap", type=int, default=4, metavar="PX",
+		help="merge opaque runs separated by fewer than PX transparent pixels")
+	ap.add_argument("--threshold", type=int, default=128,
+		help="PNG alpha at or above this is opaque")
+	ap.add_argument("--name")
+	ap.add_argument("-o", "--output", required=True)
+	args = ap.parse_args()
+
+	pixels = read_png(args.png)
+	h = len(pixels)
+	w = len(pixels[0])
+	if not (1 <= w <= 256 and 1 <= h <= 256):
+		sys.exit(f"{args.png}: sprites are at most 256x256, got {w}x{h}")
+	size, conv = FORMATS[args.format]
+	stride = w
+	while (stride * h * size) % 4:
+		stride += 1
+	if stride > 256:
+		sys.exit(f"{args.png}: padded stride {stride} does not fit in sprite_t")
+	name = args.name or os.path.splitext(os.path.basename(args.png))[0]
+
+	masks = []
+	image = []
+	for row in pixels:
+		mask = [a >= args.threshold for (_, _, _, a) in row]
+		masks.append(mask)
+		image += [conv(r, g, b, int(m)) for (r, g, b, _), m in zip(row, mask)]
+		image += [0] * (stride - w)
+	words = pack_words(image, size)
+
+	flags = "0"
+	stats = ""
+	if all(all(m) for m in masks):
+		flags = "SPRITE_FLAG_OPAQUE"
+		args.meta = "none"
+	elif args.meta == "row":
+		flags = "SPRITE_FLAG_OPACITY_METADATA"
+		words += [row_meta(m) for m in masks]
+	elif args.meta == "spans":
+		flags = "SPRITE_FLAG_SPAN_METADATA"
+		spans = [row_spans(m, args.merge_gap) for m in masks]
+		row_start = [0]
+		for s in spans:
+			row_start.append(row_start[-1] + len(s))
+		if row_start[-1] > 0xffff:
+			sys.exit(f"{args.png}: too many spans")
+		words += pack_words(row_start, 2)
+		words += [span_word(*s) for row in spans for s in row]
+		n_opaque = sum(sum(m) for m in masks)
+		n_solid = sum(e - s for row in spans for (s, e, solid) in row if solid)
+		n_alpha = sum(e - s for row in spans for (s, e, solid) in row if not solid)
+		stats = (f"// {row_start[-1]} spans, {n_solid} of {n_opaque} opaque pixels "
+			f"in solid spans, {n_alpha} pixels through the alpha blit\n")
+
+	upper = name.upper()
+	with open(args.output, "w") as f:
+		f.write(f"// Generated by tools/sprite_conv.py from {os.path.basename(args.png)}, do not edit\n")
+		f.write(f"// {args.format}, {w}x{h}, stride {stride}, metadata: {args.meta}\n")
+		f.write(stats)
+		f.write(f"\n#ifndef _{upper}_SPRITE_H\n#define _{upper}_SPRITE_H\n\n")
+		f.write("#include \"sprite.h\"\n\n")
+		f.write(f"#define {upper}_W {w}\n")
+		f.write(f"#define {upper}_H {h}\n")
+		f.write(f"#define {upper}_STRIDE {stride}\n")
+		f.write(f"#define {upper}_FLAGS {flags}\n\n")
+		f.write(f"static const uint32_t {name}[] = {{\n")
+		for i in range(0, len(words), 8):
+			f.write("\t" + ", ".join(f"0x{v:08x}" for v in words[i:i + 8]) + ",\n")
+		f.write("};\n\n#endif\n")
+
+if __name__ == "__main__":
+	main()
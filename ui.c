@@ -0,0 +1,141 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "text_screen.h"
+#include "ui.h"
+
+static const char PASSWORD[PASSWORD_LEN + 1] = "3333";
+
+#define UI_INPUT_BASE_X ((int)row_cols(UI_INPUT_Y) / 2 - (PASSWORD_LEN / 2))
+
+static const char *const ui_title = "COFRE ELETRÔNICO";
+static const char *const ui_prompt_msg = "Digite a senha (4 dígitos):";
+
+void ui_setup_layout(void) {
+    for (unsigned y = 0; y < TEXT_MAX_ROWS; ++y)
+        set_row_scale(y, 3, true);
+    set_row_scale(UI_TITLE_Y, 4, true);
+    set_row_scale(UI_STATUS_Y, 1, false);
+    set_row_scale(UI_STATUS_Y + 1, 1, false);
+    clear_screen(0x00);
+}
+
+static void ui_draw_lockout_countdown(ui_t *ui, uint64_t now_us) {
+    int64_t remaining_us = (int64_t)(ui->deadline_us - now_us);
+    int secs = remaining_us > 0 ? (int)((remaining_us + 999999) / 1000000) : 0;
+    if (secs == ui->lockout_secs_shown)
+        return;
+    ui->lockout_secs_shown = secs;
+    char msg[40];
+    snprintf(msg, sizeof(msg), "Bloqueado por %2d segundos...", secs);
+    write_centered(UI_LOCKOUT_Y, msg, 0x3f, 0x30);
+}
+
+// Linhas de status densas (1x) no rodapé
+static void ui_draw_status(const ui_t *ui, uint8_t bg) {
+    char msg[CHAR_COLS];
+    snprintf(msg, sizeof(msg), "Tentativas: %d/%d   Resets por watchdog: %lu   Último reset: %s",
+        ui->attempts, MAX_ATTEMPTS, (unsigned long)ui->watchdog_resets,
+        ui->reset_cause ? ui->reset_cause : "?");
+    clear_line(UI_STATUS_Y, bg);
+    write_text(2, UI_STATUS_Y, msg, 0x2a, bg);
+    clear_line(UI_STATUS_Y + 1, bg);
+    write_text(2, UI_STATUS_Y + 1, "Terminal USB: 't' telemetria, 'r' zera histogramas, 'l' sonda de latência", 0x2a, bg);
+}
+
+static void ui_enter(ui_t *ui, ui_state_t state, uint64_t now_us) {
+    ui->state = state;
+    switch (state) {
+        case UI_STATE_PROMPT:
+            memset(ui->input, 0, sizeof(ui->input));
+            ui->input_index = 0;
+            clear_screen(0x00); // Fundo preto
+            write_centered(UI_TITLE_Y, ui_title, 0x3f, 0x00); // branco sobre preto
+            write_centered(UI_PROMPT_Y, ui_prompt_msg, 0x3f, 0x00);
+            ui_draw_status(ui, 0x00);
+            break;
+        case UI_STATE_ENTRY:
+            break;
+        case UI_STATE_SUCCESS:
+            clear_screen(0x0c); // Fundo verde
+            write_centered(UI_TITLE_Y, ui_title, 0x3f, 0x0c); // branco sobre verde
+            write_centered(UI_PROMPT_Y, "Bem vindo", 0x3f, 0x0c);
+            ui_draw_status(ui, 0x0c);
+            break;
+        case UI_STATE_ERROR:
+            ui->attempts++;
+            clear_screen(0x30); // Fundo vermelho
+            write_centered(UI_TITLE_Y, ui_title, 0x3f, 0x30); // branco sobre vermelho
+            write_centered(UI_PROMPT_Y, "Senha incorreta. Tente novamente.", 0x3f, 0x30);
+            ui_draw_status(ui, 0x30);
+            ui->deadline_us = now_us + ERROR_DISPLAY_MS * 1000ull;
+            break;
+        case UI_STATE_LOCKOUT:
+            ui->deadline_us = now_us + LOCKOUT_MS * 1000ull;
+            ui->lockout_secs_shown = -1;
+            ui_draw_lockout_countdown(ui, now_us);
+            break;
+    }
+}
+
+void ui_start(ui_t *ui, uint64_t now_us) {
+    ui->attempts = 0;
+    ui_enter(ui, UI_STATE_PROMPT, now_us);
+}
+
+bool ui_on_char(ui_t *ui, char ch, uint64_t now_us) {
+    if (ch < '0' || ch > '9')
+        return false;
+    if (ui->state != UI_STATE_PROMPT && ui->state != UI_STATE_ENTRY)
+        return false;
+    if (ui->state == UI_STATE_PROMPT)
+        ui_enter(ui, UI_STATE_ENTRY, now_us);
+
+    ui->input[ui->input_index] = ch;
+    // Mostrar '*' para cada dígito
+    set_char((unsigned)(UI_INPUT_BASE_X + ui->input_index), UI_INPUT_Y, '*');
+    set_colour((unsigned)(UI_INPUT_BASE_X + ui->input_index), UI_INPUT_Y, 0x3C, 0x00); // amarelo sobre preto
+    ui->input_index++;
+
+    if (ui->input_index == PASSWORD_LEN) {
+        ui->input[PASSWORD_LEN] = '\0';
+        if (strncmp(ui->input, PASSWORD, PASSWORD_LEN) == 0)
+            ui_enter(ui, UI_STATE_SUCCESS, now_us);
+        else
+            ui_enter(ui, UI_STATE_ERROR, now_us);
+    }
+    return true;
+}
+
+uint32_t ui_on_frame(ui_t *ui, kp_link_t *link, const kp_frame_t *frame, uint64_t now_us) {
+    uint32_t shown = 0;
+    for (unsigned i = kp_link_accept(link, frame); i < frame->n_events; ++i) {
+        if ((frame->events[i].flags & KP_EVENT_PRESSED) &&
+            ui_on_char(ui, (char)frame->events[i].key, now_us))
+            shown |= 1u << i;
+    }
+    return shown;
+}
+
+void ui_tick(ui_t *ui, uint64_t now_us) {
+    switch (ui->state) {
+        case UI_STATE_ERROR:
+            if ((int64_t)(now_us - ui->deadline_us) < 0)
+                break;
+            if (ui->attempts >= MAX_ATTEMPTS)
+                ui_enter(ui, UI_STATE_LOCKOUT, now_us);
+            else
+                ui_enter(ui, UI_STATE_PROMPT, now_us);
+            break;
+        case UI_STATE_LOCKOUT:
+            if ((int64_t)(now_us - ui->deadline_us) < 0) {
+                ui_draw_lockout_countdown(ui, now_us);
+                break;
+            }
+            ui->attempts = 0;
+            ui_enter(ui, UI_STATE_PROMPT, now_us);
+            break;
+        default:
+            break;
+    }
+}
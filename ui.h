@@ -0,0 +1,72 @@
+#ifndef _UI_H
+#define _UI_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "keypad_proto.h"
+
+// Máquina de estados da IHM (cofre eletrônico), desenhada em text_screen.h.
+//
+// Todas as transições temporizadas usam um prazo absoluto (deadline) que é
+// verificado em ui_tick(). Nem ui_tick() nem ui_on_char() bloqueiam, então a
+// UART continua sendo consumida e o heartbeat do Core 0 continua sendo
+// atualizado durante a mensagem de erro e o bloqueio. Os instantes são em
+// microssegundos de um relógio qualquer (time_us_64() no receptor, o relógio
+// do emissor no emulador de host/).
+
+// Password configuration
+#define PASSWORD_LEN 4
+#define MAX_ATTEMPTS 3
+#define LOCKOUT_MS 30000
+#define ERROR_DISPLAY_MS 3000
+
+// Layout: título em 4x e corpo em 3x, ambos com largura dupla (40 colunas,
+// codificadas com pixels duplicados), e duas linhas de status densas em 1x
+// no rodapé (6 * 24 + 32 + 12 * 24 + 2 * 8 = 480 linhas).
+#define UI_TITLE_Y   6
+#define UI_PROMPT_Y  8
+#define UI_INPUT_Y   (UI_PROMPT_Y + 1)
+#define UI_LOCKOUT_Y (UI_INPUT_Y + 2)
+#define UI_STATUS_Y  19
+
+typedef enum {
+    UI_STATE_PROMPT,  // Tela inicial, aguardando o primeiro dígito
+    UI_STATE_ENTRY,   // Recebendo dígitos (exibidos como '*')
+    UI_STATE_SUCCESS, // Senha correta (estado final)
+    UI_STATE_ERROR,   // Senha incorreta, mensagem por ERROR_DISPLAY_MS
+    UI_STATE_LOCKOUT  // Bloqueio por LOCKOUT_MS após MAX_ATTEMPTS erros
+} ui_state_t;
+
+typedef struct {
+    ui_state_t state;
+    uint64_t deadline_us;
+    int attempts;
+    char input[PASSWORD_LEN + 1];
+    int input_index;
+    int lockout_secs_shown;
+    // Mostrados na linha de status
+    uint32_t watchdog_resets;
+    const char *reset_cause;
+} ui_t;
+
+// Define a escala de cada linha e limpa a tela com fundo preto
+void ui_setup_layout(void);
+
+// Zera o estado e desenha a tela inicial
+void ui_start(ui_t *ui, uint64_t now_us);
+
+// Processa um caractere recebido. Fora dos estados de entrada os caracteres
+// são descartados, para que dígitos digitados durante o erro ou o bloqueio
+// não sejam reprocessados depois. Retorna true se o caractere mudou a tela.
+bool ui_on_char(ui_t *ui, char ch, uint64_t now_us);
+
+// Entrega os eventos novos de um quadro do enlace (os repetidos são
+// descartados por kp_link_accept) e retorna a máscara dos eventos, bit i para
+// frame->events[i], que mudaram a tela.
+uint32_t ui_on_frame(ui_t *ui, kp_link_t *link, const kp_frame_t *frame, uint64_t now_us);
+
+// Avança as transições temporizadas. Nunca bloqueia.
+void ui_tick(ui_t *ui, uint64_t now_us);
+
+#endif